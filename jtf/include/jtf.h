@@ -7,8 +7,16 @@
 #include "jtf_version.h"
 #include "jtf_types.h"
 #include "jtf_crc32.h"
+#include "jtf_view.h"
+#include "jtf_stream.h"
+#include "jtf_reader.h"
+#include "jtf_query.h"
 #include <string>
 #include <fstream>
+#include <functional>
+#include <optional>
+#include <future>
+#include <span>
 #include <bit>
 #include <unordered_map>
 
@@ -18,6 +26,9 @@ namespace cybex_interactive::jtf
 
 	constexpr uint32_t MAP_AXIS_SIZE_LIMIT = 4097;
 
+	constexpr uint16_t TILE_SIZE_MIN = 16;
+	constexpr uint16_t TILE_SIZE_MAX = 4096;
+
 	// ensure chunk IDs are built big-endian
 	constexpr inline uint32_t BuildChunkID_LittleEndian(char a, char b, char c, char d) noexcept
 	{
@@ -30,6 +41,11 @@ namespace cybex_interactive::jtf
 
 	constexpr uint32_t CHUNK_ID_HEAD = BuildChunkID_LittleEndian('H','E','A','D');
 	constexpr uint32_t CHUNK_ID_HMAP = BuildChunkID_LittleEndian('H','M','A','P');
+	constexpr uint32_t CHUNK_ID_HTIL = BuildChunkID_LittleEndian('H','T','I','L');
+	constexpr uint32_t CHUNK_ID_HCMP = BuildChunkID_LittleEndian('H','C','M','P');
+	constexpr uint32_t CHUNK_ID_HLOD = BuildChunkID_LittleEndian('H','L','O','D');
+	constexpr uint32_t CHUNK_ID_HQDT = BuildChunkID_LittleEndian('H','Q','D','T');
+	constexpr uint32_t CHUNK_ID_HDIR = BuildChunkID_LittleEndian('H','D','I','R');
 
 	constexpr uint32_t CHUNK_ID_FEND = BuildChunkID_LittleEndian('F','E','N','D');
 
@@ -37,6 +53,8 @@ namespace cybex_interactive::jtf
 	constexpr RequestableChunkName RequestableChunkNames[] = {
 		{"HEAD", CHUNK_ID_HEAD},
 		{"HMAP", CHUNK_ID_HMAP},
+		{"HTIL", CHUNK_ID_HTIL},
+		{"HCMP", CHUNK_ID_HCMP},
 
 		{"FEND", CHUNK_ID_FEND}
 	};
@@ -54,6 +72,8 @@ namespace cybex_interactive::jtf
 	}
 
 
+	struct TileGrid;
+
 	class JTFFile
 	{
 	public:
@@ -66,88 +86,470 @@ namespace cybex_interactive::jtf
 		/// <param name="heights">Terrain heights stored in row-major order.</param>
 		template<typename T> static void Write(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& heights);
 
+		/// <summary>Write to .jtf file with explicit storage options.</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="width">Terrain width. Max value = 4097.</param>
+		/// <param name="height">Terrain height. Max value = 4097.</param>
+		/// <param name="boundsLower">Lowest Elevation floored to next lesser int32_t.</param>
+		/// <param name="boundsUpper">Highest Elevation ceiled to next greater int32_t.</param>
+		/// <param name="heights">Terrain heights stored in row-major order.</param>
+		/// <param name="options">Storage options, e.g. tiled layout.</param>
+		template<typename T> static void Write(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& heights, const JTF_WriteOptions& options);
+
+		/// <summary>Write .jtf file from real-world elevations, normalized to the bounds while quantizing, see Normalize().</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="width">Terrain width. Max value = 4097.</param>
+		/// <param name="height">Terrain height. Max value = 4097.</param>
+		/// <param name="boundsLower">Lowest Elevation floored to next lesser int32_t.</param>
+		/// <param name="boundsUpper">Highest Elevation ceiled to next greater int32_t.</param>
+		/// <param name="elevations">Terrain elevations stored in row-major order, in the units of the bounds.</param>
+		/// <param name="options">Storage options, e.g. tiled layout. ThreadCount also sets the normalizing threads.</param>
+		template<typename T> static void WriteElevations(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& elevations, const JTF_WriteOptions& options = JTF_WriteOptions{});
+
+		/// <summary>
+		/// Write .jtf file from raw elevations, the bounds are computed as the floored minimum and ceiled maximum by a parallel SIMD min/max scan.
+		/// The elevations are normalized while they are quantized and hashed for the 'HMAP' payload, no normalized copy is kept for 8 / 16 bit output.
+		/// NaN elevations are skipped by the scan.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <param name="width">Terrain width. Max value = 4097.</param>
+		/// <param name="height">Terrain height. Max value = 4097.</param>
+		/// <param name="elevations">Terrain elevations stored in row-major order, finite and within int32_t range.</param>
+		/// <param name="options">Storage options, e.g. tiled layout. ThreadCount also sets the scanning threads.</param>
+		template<typename T> static void WriteElevations(const std::string& filePath, uint16_t width, uint16_t height, const std::vector<T>& elevations, const JTF_WriteOptions& options = JTF_WriteOptions{});
+
 		/// <summary>Read terrain data from .jtf file.</summary>
 		/// <param name="path">File path.</param>
 		/// <returns>Returns JTF data struct.</returns>
 		static JTF Read(const std::string& filePath);
 
-		/// <summary>Read specified data from .jtf file. "HEAD", holding relevant flags, will always be read.</summary>
+		/// <summary>Read terrain data from .jtf file with explicit read options.</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="options">Read options, e.g. verification thread count.</param>
+		/// <returns>Returns JTF data struct.</returns>
+		static JTF Read(const std::string& filePath, const JTF_ReadOptions& options);
+
+		/// <summary>
+		/// Read specified data from .jtf file. "HEAD", holding relevant flags, will always be read.
+		/// Files with a chunk directory 'HDIR' (see JTF_WriteOptions::ChunkDirectory) are read by seeking straight to the requested chunks.
+		/// </summary>
 		/// <param name="path">File path.</param>
 		/// <param name="requestedChunks">Requested chunk names. "HEAD", "HMAP", etc.</param>
 		/// <param name="verifyFileCrc">Read all chunk CRCs to verify file CRC.</param>
 		/// <returns>Returns JTF data struct with selectively populated chunks.</returns>
 		static JTF Read(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc);
 
+		/// <summary>Read specified data from .jtf file with explicit read options. "HEAD", holding relevant flags, will always be read.</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="requestedChunks">Requested chunk names. "HEAD", "HMAP", etc.</param>
+		/// <param name="verifyFileCrc">Read all chunk CRCs to verify file CRC.</param>
+		/// <param name="options">Read options, e.g. verification thread count or stats.</param>
+		/// <returns>Returns JTF data struct with selectively populated chunks.</returns>
+		static JTF Read(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc, const JTF_ReadOptions& options);
+
+		/// <summary>Read terrain data from .jtf file, keeping height samples at the file's native bit depth (8 / 16 = uint8_t / uint16_t UNORM, 32 = float, 64 = double).</summary>
+		/// <param name="path">File path.</param>
+		/// <returns>Returns JTF data struct with native precision height samples.</returns>
+		static JTF_Native ReadNative(const std::string& filePath);
+
+		/// <summary>Read terrain data from .jtf file with explicit read options, keeping height samples at the file's native bit depth.</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="options">Read options, e.g. verification thread count.</param>
+		/// <returns>Returns JTF data struct with native precision height samples.</returns>
+		static JTF_Native ReadNative(const std::string& filePath, const JTF_ReadOptions& options);
+
+		/// <summary>Read specified data from .jtf file, keeping height samples at the file's native bit depth. "HEAD", holding relevant flags, will always be read.</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="requestedChunks">Requested chunk names. "HEAD", "HMAP", etc.</param>
+		/// <param name="verifyFileCrc">Read all chunk CRCs to verify file CRC.</param>
+		/// <returns>Returns JTF data struct with selectively populated chunks and native precision height samples.</returns>
+		static JTF_Native ReadNative(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc);
+
+		/// <summary>
+		/// Read many .jtf files concurrently on a work-stealing thread pool, overlapping I/O, CRC verification and decoding across files.
+		/// A failing file does not abort the batch, its error is reported in its result.
+		/// </summary>
+		/// <param name="filePaths">File paths.</param>
+		/// <param name="options">Read options, ThreadCount sets the pool size (0 = hardware concurrency), each file is read on one thread.</param>
+		/// <returns>Returns one result per file path, in order.</returns>
+		static std::vector<JTF_BatchResult> ReadBatch(const std::vector<std::string>& filePaths, const JTF_ReadOptions& options);
+
+		/// <summary>
+		/// Read a .jtf file without blocking the caller. The file is loaded through io_uring on Linux (a small I/O thread pool elsewhere),
+		/// then verified and decoded on a shared thread pool while further reads proceed. Many reads may be in flight at once.
+		/// Parallelism is spread across reads, every file is decoded on a single pool thread.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <param name="options">Read options, ThreadCount is ignored. Stats must not be shared by reads in flight at the same time.</param>
+		/// <returns>Returns a future holding the JTF data struct, or the read error.</returns>
+		static std::future<JTF> ReadAsync(const std::string& filePath, const JTF_ReadOptions& options = JTF_ReadOptions{});
+
+		/// <summary>Read a .jtf file without blocking the caller, see ReadAsync(filePath, options), handing the result to a callback instead of a future.</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="onComplete">Invoked exactly once on a library thread, with the JTF data struct or the read error. It must not block for long.</param>
+		/// <param name="options">Read options, ThreadCount is ignored. Stats must not be shared by reads in flight at the same time.</param>
+		static void ReadAsync(const std::string& filePath, std::function<void(JTF&& data, std::exception_ptr error)> onComplete, const JTF_ReadOptions& options = JTF_ReadOptions{});
+
+		/// <summary>Gets the I/O backend serving ReadAsync(): "io_uring" or "thread pool".</summary>
+		static const char* GetAsyncBackendName();
+
+		/// <summary>Read only the header of a .jtf file, e.g. to size the buffer handed to ReadInto().</summary>
+		/// <param name="path">File path.</param>
+		/// <returns>Returns the file header: dimensions, bit depth, layout, compression and bounds.</returns>
+		static JTF_Head ReadHeader(const std::string& filePath);
+
+		/// <summary>
+		/// Read the headers of many .jtf files in parallel. Every file is read with a single positioned read of its fixed-size prefix
+		/// (signature and HEAD chunk), no stream is constructed. A failing file does not abort the scan, its error is reported in the result.
+		/// </summary>
+		/// <param name="filePaths">File paths.</param>
+		/// <param name="options">Read options, ThreadCount sets the number of scanning threads (0 = hardware concurrency).</param>
+		/// <returns>Returns the headers and errors, one entry per file path, in order.</returns>
+		static JTF_HeaderScan ScanHeaders(const std::vector<std::string>& filePaths, const JTF_ReadOptions& options = JTF_ReadOptions{});
+
+		/// <summary>Read the headers of all .jtf files in a directory in parallel, see ScanHeaders(filePaths, options).</summary>
+		/// <param name="directory">Directory path.</param>
+		/// <param name="recursive">Include the files of sub directories.</param>
+		/// <param name="options">Read options, ThreadCount sets the number of scanning threads (0 = hardware concurrency).</param>
+		/// <returns>Returns the headers and errors, one entry per file, ordered by path.</returns>
+		static JTF_HeaderScan ScanHeaders(const std::string& directory, bool recursive, const JTF_ReadOptions& options = JTF_ReadOptions{});
+
+		/// <summary>
+		/// Read height samples straight into a caller-provided buffer, widening or narrowing to T (float or double) without allocating a sample array.
+		/// Uncompressed linear files are read without any payload allocation, tiled and compressed files stage their encoded chunk payload.
+		/// On error the buffer contents are unspecified.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <param name="destination">Buffer of at least width * height samples, filled in row-major order.</param>
+		/// <returns>Returns the file header.</returns>
+		template<typename T> static JTF_Head ReadInto(const std::string& filePath, std::span<T> destination);
+
+		/// <summary>Read height samples straight into a caller-provided buffer with explicit read options, see ReadInto(filePath, destination).</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="destination">Buffer of at least width * height samples, filled in row-major order.</param>
+		/// <param name="options">Read options, e.g. verification thread count.</param>
+		/// <returns>Returns the file header.</returns>
+		template<typename T> static JTF_Head ReadInto(const std::string& filePath, std::span<T> destination, const JTF_ReadOptions& options);
+
+		/// <summary>
+		/// Read real-world elevations straight into a caller-provided buffer: (BoundsLower + sample * BoundsRange()) * scale + offset.
+		/// The map is decoded as by ReadInto(), then mapped in place in parallel SIMD bands, no intermediate sample array is allocated.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <param name="destination">Buffer of at least width * height samples, filled in row-major order.</param>
+		/// <param name="scale">Unit conversion factor applied to the elevations, e.g. 3.28084 for meters to feet.</param>
+		/// <param name="offset">Added after scaling, e.g. a datum shift.</param>
+		/// <param name="options">Read options, e.g. verification thread count.</param>
+		/// <returns>Returns the file header.</returns>
+		template<typename T> static JTF_Head ReadElevationsInto(const std::string& filePath, std::span<T> destination, double scale = 1.0, double offset = 0.0, const JTF_ReadOptions& options = JTF_ReadOptions{});
+
+		/// <summary>Map normalized samples to real-world elevations, (boundsLower + sample * (boundsUpper - boundsLower)) * scale + offset, in parallel SIMD bands.</summary>
+		/// <param name="normalized">Normalized samples in [0, 1].</param>
+		/// <param name="boundsLower">Lower bound of the map.</param>
+		/// <param name="boundsUpper">Upper bound of the map.</param>
+		/// <param name="elevations">Destination of normalized.size() samples, may be the normalized buffer itself.</param>
+		/// <param name="scale">Unit conversion factor applied to the elevations.</param>
+		/// <param name="offset">Added after scaling.</param>
+		/// <param name="threadCount">Mapping threads, 0 = hardware concurrency, 1 = serial.</param>
+		template<typename T> static void Denormalize(std::span<const T> normalized, int32_t boundsLower, int32_t boundsUpper, std::span<T> elevations, double scale = 1.0, double offset = 0.0, uint32_t threadCount = 0);
+
+		/// <summary>Map real-world elevations to normalized samples, the inverse of Denormalize(), in parallel SIMD bands. Equal bounds map every sample to 0.</summary>
+		/// <param name="elevations">Elevations, (elevation - offset) / scale lies within the bounds.</param>
+		/// <param name="boundsLower">Lower bound of the map.</param>
+		/// <param name="boundsUpper">Upper bound of the map.</param>
+		/// <param name="normalized">Destination of elevations.size() samples, may be the elevations buffer itself.</param>
+		/// <param name="scale">Unit conversion factor the elevations carry, not 0.</param>
+		/// <param name="offset">Offset the elevations carry.</param>
+		/// <param name="threadCount">Mapping threads, 0 = hardware concurrency, 1 = serial.</param>
+		template<typename T> static void Normalize(std::span<const T> elevations, int32_t boundsLower, int32_t boundsUpper, std::span<T> normalized, double scale = 1.0, double offset = 0.0, uint32_t threadCount = 0);
+
+		/// <summary>
+		/// Read a rectangular region of the height map. Tiled files read and CRC-verify only the tiles overlapping the region, linear files are read completely.
+		/// The remaining chunks are skipped, the file CRC is verified over their stored chunk CRCs.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <param name="x">Region origin x, in samples.</param>
+		/// <param name="y">Region origin y, in samples.</param>
+		/// <param name="width">Region width, in samples.</param>
+		/// <param name="height">Region height, in samples.</param>
+		/// <returns>Returns region struct with file header and region samples in row-major order.</returns>
+		static JTF_Region ReadRegion(const std::string& filePath, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+		/// <summary>Read a rectangular region of the height map, see ReadRegion(filePath, x, y, width, height).</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="x">Region origin x, in samples.</param>
+		/// <param name="y">Region origin y, in samples.</param>
+		/// <param name="width">Region width, in samples.</param>
+		/// <param name="height">Region height, in samples.</param>
+		/// <param name="options">Read options, e.g. decoding thread count of linear files.</param>
+		/// <returns>Returns region struct with file header and region samples in row-major order.</returns>
+		static JTF_Region ReadRegion(const std::string& filePath, uint16_t x, uint16_t y, uint16_t width, uint16_t height, const JTF_ReadOptions& options);
+
+		/// <summary>
+		/// Read one level of detail. Levels above 0 are read from the 'HLOD' chunk (see JTF_WriteOptions::LodLevels) without touching the full resolution height chunk,
+		/// only the level's own CRC is verified. Level 0 reads the full resolution map.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <param name="level">Level, 0 = full resolution, n = halved n times.</param>
+		/// <returns>Returns level struct with file header, level extents, stored level count and level samples in row-major order.</returns>
+		static JTF_Lod ReadLod(const std::string& filePath, uint8_t level);
+
+		/// <summary>Read one level of detail, see ReadLod(filePath, level).</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="level">Level, 0 = full resolution, n = halved n times.</param>
+		/// <param name="options">Read options, e.g. decoding thread count of level 0.</param>
+		/// <returns>Returns level struct with file header, level extents, stored level count and level samples in row-major order.</returns>
+		static JTF_Lod ReadLod(const std::string& filePath, uint8_t level, const JTF_ReadOptions& options);
+
+		/// <summary>
+		/// Read the min/max quadtree from the 'HQDT' chunk (see JTF_WriteOptions::HeightTreeLeafSize) without touching the height chunk,
+		/// only the tree chunk's CRC is verified. Pair it with the heights in a JTFHeightQuery.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <returns>Returns the tree with normalized bounds, root level first.</returns>
+		static JTF_HeightTree ReadHeightTree(const std::string& filePath);
+
+		/// <summary>Read the min/max quadtree, see ReadHeightTree(filePath).</summary>
+		/// <param name="path">File path.</param>
+		/// <param name="options">Read options, e.g. CRC hashing thread count and stats.</param>
+		/// <returns>Returns the tree with normalized bounds, root level first.</returns>
+		static JTF_HeightTree ReadHeightTree(const std::string& filePath, const JTF_ReadOptions& options);
+
+		/// <summary>
+		/// Read the chunk directory 'HDIR' (see JTF_WriteOptions::ChunkDirectory) from the file tail. The directory CRC and the file CRC,
+		/// computed over the listed chunk CRCs, are verified, the chunk payloads are not read.
+		/// </summary>
+		/// <param name="path">File path.</param>
+		/// <returns>Returns the chunks in file order, 'HDIR' and 'FEND' excluded. Empty if the file holds no directory.</returns>
+		static std::vector<JTF_ChunkEntry> ReadChunkDirectory(const std::string& filePath);
+
 	private:
+		template<typename T> friend class JTFStreamWriter;
+		friend class JTFStreamReader;
+		friend class JTFReader;
+
+		/// <summary>Write .jtf file from samples mapped to normalized samples by sample * scale + offset, see Write(). An identity map writes the samples as passed.</summary>
+		template<typename T> static void WriteMapped(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& samples, double scale, double offset, const JTF_WriteOptions& options);
+
 		/// <summary>Write the JTF signature (magic number).</summary>
 		/// <param name="file">File</param>
-		inline static void WriteSignature(std::ofstream& file);
+		inline static void WriteSignature(std::ostream& file);
 
 		/// <summary>Write the header chunk 'HEAD'.</summary>
 		/// <param name="file">File</param>
-		/// <param name="width">Terrain width.</param>
-		/// <param name="height">Terrain height.</param>
-		/// <param name="bitDepth">Bit depth: 32 = 32bit single precision, 64 = 64bit double precision.</param>
-		/// <param name="boundsLower">Lowest Elevation floored to next lesser int32_t.</param>
-		/// <param name="boundsUpper">Highest Elevation ceiled to next greater int32_t.</param>
+		/// <param name="header">Header: dimensions, bit depth, layout, compression and bounds. Version fields are ignored, the library version is written.</param>
 		/// <param name="fileCrc">Computing file CRC reference.</param>
-		inline static void WriteHeadChunk(std::ofstream& file, uint16_t width, uint16_t height, uint8_t bitDepth, int32_t boundsLower, int32_t boundsUpper, Crc32& fileCrc);
+		/// <returns>Returns the chunk CRC.</returns>
+		inline static uint32_t WriteHeadChunk(std::ostream& file, const JTF_Head& header, Crc32& fileCrc);
 
 		/// <summary>Write the height map chunk 'HMAP'.</summary>
 		/// <param name="file">File</param>
 		/// <param name="heights">Heights, normalized with bounds as extents.</param>
+		/// <param name="payloadHash">CRC-32 of the payload if already computed while quantizing, hashed here otherwise.</param>
+		/// <param name="fileCrc">Computing file CRC reference.</param>
+		/// <param name="threadCount">Threads encoding and hashing the payload, 0 = hardware concurrency.</param>
+		/// <returns>Returns the chunk CRC.</returns>
+		template<typename T> inline static uint32_t WriteHmapChunk(std::ostream& file, uint8_t bitDepth, const std::vector<T>& heights, std::optional<uint32_t> payloadHash, Crc32& fileCrc, uint32_t threadCount);
+
+		/// <summary>Write the tiled height map chunk 'HTIL'.</summary>
+		/// <param name="file">File</param>
+		/// <param name="grid">Tile arrangement.</param>
+		/// <param name="heights">Heights, normalized with bounds as extents, row-major.</param>
+		/// <param name="fileCrc">Computing file CRC reference.</param>
+		/// <returns>Returns the chunk CRC.</returns>
+		template<typename T> inline static uint32_t WriteHtilChunk(std::ostream& file, const TileGrid& grid, const std::vector<T>& heights, Crc32& fileCrc);
+
+		/// <summary>Write the compressed height map chunk 'HCMP'.</summary>
+		/// <param name="file">File</param>
+		/// <param name="payload">Payload encoded with HeightCodec.</param>
+		/// <param name="fileCrc">Computing file CRC reference.</param>
+		/// <param name="threadCount">Threads encoding and hashing the payload, 0 = hardware concurrency.</param>
+		/// <returns>Returns the chunk CRC.</returns>
+		inline static uint32_t WriteHcmpChunk(std::ostream& file, const std::vector<uint8_t>& payload, Crc32& fileCrc, uint32_t threadCount);
+
+		/// <summary>Write the level of detail chunk 'HLOD'.</summary>
+		/// <param name="file">File</param>
+		/// <param name="payload">Payload holding the level index and the downsampled levels.</param>
+		/// <param name="fileCrc">Computing file CRC reference.</param>
+		/// <param name="threadCount">Threads hashing the payload, 0 = hardware concurrency.</param>
+		/// <returns>Returns the chunk CRC.</returns>
+		inline static uint32_t WriteHlodChunk(std::ostream& file, const std::vector<uint8_t>& payload, Crc32& fileCrc, uint32_t threadCount);
+
+		/// <summary>Write the min/max quadtree chunk 'HQDT'.</summary>
+		/// <param name="file">File</param>
+		/// <param name="payload">Payload holding the tree header and the bounds of every level.</param>
 		/// <param name="fileCrc">Computing file CRC reference.</param>
-		template<typename T> inline static void WriteHmapChunk(std::ofstream& file, uint8_t bitDepth, const std::vector<T>& heights, Crc32& fileCrc);
+		/// <param name="threadCount">Threads hashing the payload, 0 = hardware concurrency.</param>
+		/// <returns>Returns the chunk CRC.</returns>
+		inline static uint32_t WriteHqdtChunk(std::ostream& file, const std::vector<uint8_t>& payload, Crc32& fileCrc, uint32_t threadCount);
+
+		/// <summary>Write the chunk directory 'HDIR'.</summary>
+		/// <param name="file">File</param>
+		/// <param name="directory">Entries of the chunks written so far, in file order.</param>
+		/// <param name="fileCrc">Computing file CRC reference.</param>
+		inline static void WriteHdirChunk(std::ostream& file, const std::vector<JTF_ChunkEntry>& directory, Crc32& fileCrc);
 
 		/// <summary>Write the file end chunk 'FEND'.</summary>
 		/// <param name="file">File</param>
 		/// <param name="fileCrc">Computing file CRC reference.</param>
-		inline static void WriteFendChunk(std::ofstream& file, Crc32& fileCrc);
+		/// <returns>Returns the chunk CRC.</returns>
+		inline static uint32_t WriteFendChunk(std::ostream& file, Crc32& fileCrc);
 
 		/// <summary>Write the file CRC32.</summary>
 		/// <param name="file">File</param>
 		/// <param name="fileCrc">Computing file CRC reference.</param>
-		inline static void WriteFileCrc(std::ofstream& file, Crc32& fileCrc);
+		inline static void WriteFileCrc(std::ostream& file, Crc32& fileCrc);
+
+
+		/// <summary>Read all chunks of a .jtf file into JTF or JTF_Native.</summary>
+		/// <param name="filePath">File path</param>
+		/// <param name="options">Read options.</param>
+		template<typename Data> static Data ReadChunks(const std::string& filePath, const JTF_ReadOptions& options);
+
+		/// <summary>Read all chunks of an opened .jtf file into JTF or JTF_Native.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File or in-memory stream, positioned at the signature.</param>
+		/// <param name="options">Read options.</param>
+		template<typename Data> static Data ReadChunks(const std::string& filePath, std::istream& file, const JTF_ReadOptions& options);
 
+		/// <summary>Read requested chunks of a .jtf file into JTF or JTF_Native.</summary>
+		/// <param name="filePath">File path</param>
+		/// <param name="requestedChunks">Requested chunk names.</param>
+		/// <param name="verifyFileCrc">Read all chunk CRCs to verify file CRC.</param>
+		/// <param name="options">Read options.</param>
+		template<typename Data> static Data ReadChunks(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc, const JTF_ReadOptions& options);
+
+		/// <summary>Read all chunks of an opened .jtf file, decoding the height samples into the float or double destination returned by resolve(header).</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File, opened and positioned at the signature.</param>
+		/// <param name="threadCount">Threads verifying and decoding the payload, 0 = hardware concurrency.</param>
+		/// <param name="payload">Reusable staging for tiled and compressed chunk payloads.</param>
+		/// <param name="scratch">Reusable decoder working memory.</param>
+		/// <param name="resolve">Called once HEAD is read, returns the destination of width * height samples.</param>
+		/// <returns>The file header.</returns>
+		template<typename Resolve> static JTF_Head ReadHeightsInto(const std::string& filePath, std::istream& file, uint32_t threadCount, std::vector<uint8_t>& payload, std::vector<uint8_t>& scratch, Resolve&& resolve);
 
 		/// <summary>Read and validate the JTF signature (magic number).</summary>
 		/// <param name="filePath">File path</param>
 		/// <param name="file">File</param>
-		inline static void ReadValidateSignature(const std::string& filePath, std::ifstream& file);
+		inline static void ReadValidateSignature(const std::string& filePath, std::istream& file);
 
 		/// <summary>Read the chunk type ASCII.</summary>
 		/// <param name="filePath">File path (for exception log purpose).</param>
 		/// <param name="file">File</param>
 		/// <returns>uint32_t of ASCII</returns>
-		inline static uint32_t ReadChunkType(const std::string& filePath, std::ifstream& file);
+		inline static uint32_t ReadChunkType(const std::string& filePath, std::istream& file);
 
 		/// <summary>Read the head chunk 'HEAD'.</summary>
 		/// <param name="filePath">File path (for exception log purpose).</param>
 		/// <param name="file">File</param>
 		/// <param name="payloadSize">Payload size as written in file.</param>
 		/// <param name="fileCrc">Computed file CRC reference.</param>
-		/// <param name="jtf">JTF reference.</param>
-		inline static void ReadHeadChunk(const std::string& filePath, std::ifstream& file, uint32_t payloadSize, Crc32& fileCrc, JTF& jtf);
+		/// <param name="header">Header reference.</param>
+		inline static void ReadHeadChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, JTF_Head& header);
 
 		/// <summary>Read the height map chunk 'HMAP'.</summary>
 		/// <param name="filePath">File path (for exception log purpose).</param>
 		/// <param name="file">File</param>
 		/// <param name="payloadSize">Payload size as written in file.</param>
 		/// <param name="fileCrc">Computed file CRC reference.</param>
-		/// <param name="jtf">JTF reference.</param>
-		inline static void ReadHmapChunk(const std::string& filePath, std::ifstream& file, uint32_t payloadSize, Crc32& fileCrc, JTF& jtf);
+		/// <param name="header">Header, read beforehand.</param>
+		/// <param name="heights">Heights reference, samples widened to double.</param>
+		/// <param name="threadCount">Threads verifying and decoding the payload, 0 = hardware concurrency.</param>
+		inline static void ReadHmapChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_Heights& heights, uint32_t threadCount);
+
+		/// <summary>Read the height map chunk 'HMAP' keeping the native sample type.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="fileCrc">Computed file CRC reference.</param>
+		/// <param name="header">Header, read beforehand.</param>
+		/// <param name="heights">Heights reference, samples at native bit depth.</param>
+		/// <param name="threadCount">Threads verifying and decoding the payload, 0 = hardware concurrency.</param>
+		inline static void ReadHmapChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_NativeHeights& heights, uint32_t threadCount);
+
+		/// <summary>Read the tiled height map chunk 'HTIL' into row-major samples.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="fileCrc">Computed file CRC reference.</param>
+		/// <param name="header">Header, read beforehand.</param>
+		/// <param name="heights">Heights reference, samples widened to double.</param>
+		/// <param name="threadCount">Threads verifying and decoding the payload, 0 = hardware concurrency.</param>
+		inline static void ReadHtilChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_Heights& heights, uint32_t threadCount);
+
+		/// <summary>Read the tiled height map chunk 'HTIL' into row-major samples keeping the native sample type.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="fileCrc">Computed file CRC reference.</param>
+		/// <param name="header">Header, read beforehand.</param>
+		/// <param name="heights">Heights reference, samples at native bit depth.</param>
+		/// <param name="threadCount">Threads verifying and decoding the payload, 0 = hardware concurrency.</param>
+		inline static void ReadHtilChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_NativeHeights& heights, uint32_t threadCount);
+
+		/// <summary>Read and decompress the compressed height map chunk 'HCMP'.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="fileCrc">Computed file CRC reference.</param>
+		/// <param name="header">Header, read beforehand.</param>
+		/// <param name="heights">Heights reference, samples widened to double.</param>
+		/// <param name="threadCount">Threads verifying and decoding the payload, 0 = hardware concurrency.</param>
+		inline static void ReadHcmpChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_Heights& heights, uint32_t threadCount);
+
+		/// <summary>Read and decompress the compressed height map chunk 'HCMP' keeping the native sample type.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="fileCrc">Computed file CRC reference.</param>
+		/// <param name="header">Header, read beforehand.</param>
+		/// <param name="heights">Heights reference, samples at native bit depth.</param>
+		/// <param name="threadCount">Threads verifying and decoding the payload, 0 = hardware concurrency.</param>
+		inline static void ReadHcmpChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_NativeHeights& heights, uint32_t threadCount);
+
+		/// <summary>Read the tiles of the 'HTIL' chunk overlapping a region, verifying each tile CRC.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File, positioned at the chunk payload.</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="region">Region reference, header and extents set beforehand.</param>
+		inline static void ReadHtilRegion(const std::string& filePath, std::istream& file, uint32_t payloadSize, JTF_Region& region);
+
+		/// <summary>Read the level index of the 'HLOD' chunk and the samples of the requested level, verifying the level CRC. Level 0 reads the index only and skips the chunk.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File, positioned at the chunk payload.</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="lod">Level reference, header and level set beforehand.</param>
+		inline static void ReadHlodLevel(const std::string& filePath, std::istream& file, uint32_t payloadSize, JTF_Lod& lod);
+
+		/// <summary>
+		/// Locate the chunk directory 'HDIR' announced by the 'HEAD' chunk from the file end and read it, verifying its frame before reading the entries,
+		/// its CRC, its entries against the chunk layout and the file CRC.
+		/// </summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File, left at an unspecified position.</param>
+		/// <param name="directory">Receives the entries in file order.</param>
+		/// <returns>Returns false if the 'HEAD' chunk announces no directory.</returns>
+		inline static bool ReadHdirChunk(const std::string& filePath, std::istream& file, std::vector<JTF_ChunkEntry>& directory);
 
 		/// <summary>Read the file end chunk 'FEND'.</summary>
 		/// <param name="filePath">File path (for exception log purpose).</param>
 		/// <param name="file">File</param>
 		/// <param name="payloadSize">Payload size as written in file.</param>
 		/// <param name="fileCrc">Computed file CRC reference.</param>
-		inline static void ReadFendChunk(const std::string& filePath, std::ifstream& file, uint32_t payloadSize, Crc32& fileCrc);
+		inline static void ReadFendChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc);
+
+		/// <summary>Skip a chunk payload unread, appending the chunk CRC to the file CRC.</summary>
+		/// <param name="filePath">File path (for exception log purpose).</param>
+		/// <param name="file">File, positioned at the chunk payload.</param>
+		/// <param name="payloadSize">Payload size as written in file.</param>
+		/// <param name="fileCrc">Computed file CRC reference.</param>
+		inline static void SkipChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc);
 
 		/// <summary>Read the file CRC32.</summary>
 		/// <param name="filePath">File path (for exception log purpose).</param>
 		/// <param name="file">File</param>
 		/// <param name="fileCrc">Computed file CRC reference.</param>
-		inline static void ReadFileCrc(const std::string& filePath, std::ifstream& file, Crc32& fileCrc);
+		inline static void ReadFileCrc(const std::string& filePath, std::istream& file, Crc32& fileCrc);
 	};
 }
@@ -0,0 +1,83 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>Read-only, seekable stream buffer over bytes in memory, lets the chunk readers parse a file loaded up front.</summary>
+	class MemoryStreamBuffer final : public std::streambuf
+	{
+	public:
+		MemoryStreamBuffer(const uint8_t* data, size_t size)
+		{
+			char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+			setg(begin, begin, begin + size);
+		}
+
+	protected:
+		pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override
+		{
+			if (!(which & std::ios_base::in))
+				return pos_type(off_type(-1));
+
+			char* origin = direction == std::ios_base::beg ? eback() : direction == std::ios_base::cur ? gptr() : egptr();
+			if (offset < eback() - origin || offset > egptr() - origin)
+				return pos_type(off_type(-1));
+			setg(eback(), origin + offset, egptr());
+			return pos_type(gptr() - eback());
+		}
+
+		pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+		{
+			return seekoff(off_type(position), std::ios_base::beg, which);
+		}
+	};
+
+	/// <summary>
+	/// Process wide whole-file reader that never blocks the caller. On Linux the reads are issued through an io_uring instance whose
+	/// completions are reaped by one thread, elsewhere, or when the kernel refuses io_uring, they run as blocking reads on a small
+	/// I/O thread pool. Completion handlers run on those threads and should hand heavy work (CRC, decode) on to the reader's
+	/// worker pool through Submit(), so the next read proceeds meanwhile.
+	/// </summary>
+	class AsyncFileReader final
+	{
+	public:
+		/// <summary>Receives the file bytes, or the error that prevented reading them.</summary>
+		using Completion = std::function<void(std::vector<uint8_t>&& bytes, std::exception_ptr error)>;
+
+		/// <summary>Gets the process wide reader, created on first use.</summary>
+		static AsyncFileReader& Get();
+
+		~AsyncFileReader();
+
+		AsyncFileReader(const AsyncFileReader&) = delete;
+		AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+		/// <summary>Queue reading a whole file, onComplete is invoked exactly once.</summary>
+		void Read(const std::string& filePath, Completion onComplete);
+
+		/// <summary>Queue work on the reader's worker pool, e.g. decoding from a completion. The pool outlives every completion of the reader.</summary>
+		void Submit(std::function<void()> task);
+
+		/// <summary>Gets the backend in use: "io_uring" or "thread pool".</summary>
+		[[nodiscard]] const char* GetBackendName() const noexcept;
+
+	private:
+		struct Backend;
+
+		AsyncFileReader();
+
+		std::unique_ptr<Backend> m_backend;
+	};
+}
\ No newline at end of file
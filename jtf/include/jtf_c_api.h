@@ -38,6 +38,25 @@ extern "C" {
 		uint32_t count;
 	};
 
+	/// <summary>Header information of a .jtf file, used to size the buffer for ReadIntoFloat / ReadIntoDouble.</summary>
+	struct JTF_Info
+	{
+		uint8_t VersionMajor;
+		uint8_t VersionMinor;
+		uint8_t VersionPatch;
+		uint8_t BitDepth;
+		uint8_t Layout;		// 0 = linear, 1 = tiled
+		uint8_t Compression;	// 0 = none, 1 = predictive LZ
+		uint16_t Width;
+		uint16_t Height;
+		int32_t BoundsLower;
+		int32_t BoundsUpper;
+		uint64_t SampleCount;	// Width * Height
+	};
+
+	/// <summary>Per-phase timings and counters of one read or write, see cybex_interactive::jtf::JTF_Stats.</summary>
+	typedef cybex_interactive::jtf::JTF_Stats JTF_Stats;
+
 	/// <summary>Opaque handle representing an in memory JTF file.</summary>
 	struct JTF;
 
@@ -51,12 +70,37 @@ extern "C" {
 	/// <returns>JTF_Log information.</returns>
 	JTF_API JTF_Log Write(const char* filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const double* heights, uint64_t sampleCount);
 
+	/// <summary>Write .jtf file and report where the time went.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_stats">Receives the timings and counters of this write, also on error.</param>
+	/// <returns>JTF_Log information.</returns>
+	JTF_API JTF_Log WriteWithStats(const char* filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const double* heights, uint64_t sampleCount, JTF_Stats* out_stats);
+
+	/// <summary>Write .jtf file from real-world elevations in the units of the bounds, normalized in parallel before writing.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="elevations">Terrain elevations stored in row-major order, within [boundsLower, boundsUpper].</param>
+	/// <returns>JTF_Log information.</returns>
+	JTF_API JTF_Log WriteElevations(const char* filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const double* elevations, uint64_t sampleCount);
+
+	/// <summary>Write .jtf file from raw elevations, the bounds are the floored minimum and ceiled maximum of the elevations.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="elevations">Terrain elevations stored in row-major order, finite and within int32_t range.</param>
+	/// <returns>JTF_Log information.</returns>
+	JTF_API JTF_Log WriteElevationsAutoBounds(const char* filePath, uint16_t width, uint16_t height, const double* elevations, uint64_t sampleCount);
+
 	/// <summary>Read .jtf file.</summary>
 	/// <param name="path">File path.</param>
 	/// <param name="out_file">Pointer to new JTF handle.</param>
 	/// <returns>JTF_Log information.</returns>
 	JTF_API JTF_Log Read(const char* filePath, JTF** out_file);
 
+	/// <summary>Read .jtf file and report where the time went.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_data">Pointer to new JTF handle.</param>
+	/// <param name="out_stats">Receives the timings and counters of this read, also on error.</param>
+	/// <returns>JTF_Log information.</returns>
+	JTF_API JTF_Log ReadWithStats(const char* filePath, JTF** out_data, JTF_Stats* out_stats);
+
 	/// <summary>Read .jtf files chunks as requested. "HEAD", holding relevant flags, will always be read.</summary>
 	/// <param name="filePath">File path.</param>
 	/// <param name="requestedChunks">Requested chunk names. "HEAD", "HMAP", etc.</param>
@@ -65,6 +109,89 @@ extern "C" {
 	/// <returns>JTF_Log information.</returns>
 	JTF_API JTF_Log ReadRequested(const char* filePath, JTF_ChunkRequests requestedChunks, bool verifyFileCrc, JTF** out_data);
 
+	/// <summary>Read many .jtf files concurrently on a work-stealing thread pool. A failing file does not abort the batch.</summary>
+	/// <param name="filePaths">File paths.</param>
+	/// <param name="fileCount">Number of file paths.</param>
+	/// <param name="threadCount">Pool size, 0 = hardware concurrency.</param>
+	/// <param name="out_data">Array of fileCount JTF handles, receives a new handle per file read, null for files that failed.</param>
+	/// <param name="out_logs">Optional array of fileCount JTF_Log, receives the result per file.</param>
+	/// <returns>JTF_Log information, JTF_SUCCESS if every file was read.</returns>
+	JTF_API JTF_Log ReadBatch(const char** filePaths, uint32_t fileCount, uint32_t threadCount, JTF** out_data, JTF_Log* out_logs);
+
+	/// <summary>Receives the result of ReadAsync: the log and, on success, a new JTF handle owned by the callee (release with Destroy), otherwise null.</summary>
+	typedef void (*JTF_ReadCallback)(void* userData, JTF_Log log, JTF* data);
+
+	/// <summary>Read .jtf file without blocking the caller, loading through io_uring on Linux (an I/O thread pool elsewhere) and decoding on a shared thread pool.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="callback">Invoked exactly once on a library thread once the file is read or failed, unless the read could not be queued.</param>
+	/// <param name="userData">Passed through to the callback.</param>
+	/// <returns>JTF_Log information on queueing the read, the read result is reported to the callback.</returns>
+	JTF_API JTF_Log ReadAsync(const char* filePath, JTF_ReadCallback callback, void* userData);
+
+	/// <summary>Read .jtf file keeping height samples at the file's native bit depth. Samples are exposed through NativeHeightSamples (BitDepth 8 = uint8_t, 16 = uint16_t raw UNORM, 32 = float, 64 = double), HeightSamples stays null.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_data">Pointer to new JTF handle.</param>
+	/// <returns>JTF_Log information.</returns>
+	JTF_API JTF_Log ReadNative(const char* filePath, JTF** out_data);
+
+	/// <summary>Read one level of detail of a .jtf file written with LOD levels. Width, Height and HeightSamples of the handle describe the level.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="level">Level, 0 = full resolution, n = halved n times.</param>
+	/// <param name="out_data">Pointer to new JTF handle.</param>
+	/// <returns>JTF_Log information, JTF_INVALID_ARGUMENT if the level is not stored.</returns>
+	JTF_API JTF_Log ReadLod(const char* filePath, uint8_t level, JTF** out_data);
+
+	/// <summary>Read only the header of a .jtf file, e.g. to size the buffer for ReadIntoFloat / ReadIntoDouble.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_info">Receives the header information.</param>
+	/// <returns>JTF_Log information.</returns>
+	JTF_API JTF_Log ReadInfo(const char* filePath, JTF_Info* out_info);
+
+	/// <summary>Read the headers of many .jtf files in parallel, one positioned read of the fixed-size file prefix each. A failing file does not abort the scan.</summary>
+	/// <param name="filePaths">File paths.</param>
+	/// <param name="fileCount">Number of file paths.</param>
+	/// <param name="threadCount">Scanning threads, 0 = hardware concurrency.</param>
+	/// <param name="out_infos">Array of fileCount JTF_Info, receives the header per file, zeroed for files that failed.</param>
+	/// <param name="out_logs">Optional array of fileCount JTF_Log, receives the result per file.</param>
+	/// <returns>JTF_Log information, JTF_SUCCESS if every header was read.</returns>
+	JTF_API JTF_Log ScanHeaders(const char** filePaths, uint32_t fileCount, uint32_t threadCount, JTF_Info* out_infos, JTF_Log* out_logs);
+
+	/// <summary>Read .jtf height samples straight into a caller-provided float buffer, no library-side sample array is allocated. On error the buffer contents are unspecified.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_samples">Buffer receiving the samples in row-major order.</param>
+	/// <param name="sampleCapacity">Buffer capacity in samples, at least JTF_Info.SampleCount.</param>
+	/// <param name="out_info">Optional, receives the header information.</param>
+	/// <returns>JTF_Log information, JTF_INVALID_ARGUMENT if the buffer is too small.</returns>
+	JTF_API JTF_Log ReadIntoFloat(const char* filePath, float* out_samples, uint64_t sampleCapacity, JTF_Info* out_info);
+
+	/// <summary>Read .jtf height samples straight into a caller-provided double buffer, no library-side sample array is allocated. On error the buffer contents are unspecified.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_samples">Buffer receiving the samples in row-major order.</param>
+	/// <param name="sampleCapacity">Buffer capacity in samples, at least JTF_Info.SampleCount.</param>
+	/// <param name="out_info">Optional, receives the header information.</param>
+	/// <returns>JTF_Log information, JTF_INVALID_ARGUMENT if the buffer is too small.</returns>
+	JTF_API JTF_Log ReadIntoDouble(const char* filePath, double* out_samples, uint64_t sampleCapacity, JTF_Info* out_info);
+
+	/// <summary>Read .jtf real-world elevations, (BoundsLower + sample * range) * scale + offset, straight into a caller-provided float buffer. On error the buffer contents are unspecified.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_elevations">Buffer receiving the elevations in row-major order.</param>
+	/// <param name="sampleCapacity">Buffer capacity in samples, at least JTF_Info.SampleCount.</param>
+	/// <param name="scale">Unit conversion factor, 1 keeps the units of the bounds.</param>
+	/// <param name="offset">Added after scaling.</param>
+	/// <param name="out_info">Optional, receives the header information.</param>
+	/// <returns>JTF_Log information, JTF_INVALID_ARGUMENT if the buffer is too small.</returns>
+	JTF_API JTF_Log ReadElevationsIntoFloat(const char* filePath, float* out_elevations, uint64_t sampleCapacity, double scale, double offset, JTF_Info* out_info);
+
+	/// <summary>Read .jtf real-world elevations, (BoundsLower + sample * range) * scale + offset, straight into a caller-provided double buffer. On error the buffer contents are unspecified.</summary>
+	/// <param name="filePath">File path.</param>
+	/// <param name="out_elevations">Buffer receiving the elevations in row-major order.</param>
+	/// <param name="sampleCapacity">Buffer capacity in samples, at least JTF_Info.SampleCount.</param>
+	/// <param name="scale">Unit conversion factor, 1 keeps the units of the bounds.</param>
+	/// <param name="offset">Added after scaling.</param>
+	/// <param name="out_info">Optional, receives the header information.</param>
+	/// <returns>JTF_Log information, JTF_INVALID_ARGUMENT if the buffer is too small.</returns>
+	JTF_API JTF_Log ReadElevationsIntoDouble(const char* filePath, double* out_elevations, uint64_t sampleCapacity, double scale, double offset, JTF_Info* out_info);
+
 	/// <summary>Destroy a JTF file handle and free memory.</summary>
 	JTF_API void Destroy(JTF* file);
 
@@ -0,0 +1,56 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>
+	/// Lossless sample codec of the 'HCMP' chunk. The map is coded in independent row bands: the IEEE (or UNORM integer) bit pattern of each sample
+	/// is predicted from its left, upper and upper-left neighbours, the zigzag mapped residuals are shuffled into byte planes
+	/// and every plane is LZ coded, or stored if it does not shrink.
+	/// </summary>
+	class HeightCodec final
+	{
+	public:
+		/// <summary>Encode row-major samples into an 'HCMP' payload.</summary>
+		/// <param name="samples">Samples, row-major (width * height).</param>
+		/// <param name="width">Map width.</param>
+		/// <param name="height">Map height.</param>
+		/// <param name="threadCount">Threads coding bands in parallel, 0 = hardware concurrency, 1 = serial.</param>
+		/// <returns>The chunk payload.</returns>
+		template<typename T> static std::vector<uint8_t> Encode(const T* samples, uint16_t width, uint16_t height, uint32_t threadCount = 1);
+
+		/// <summary>
+		/// Decode an 'HCMP' payload into row-major samples. 32 bit samples are widened if T is double, 8 and 16 bit samples
+		/// are dequantized if T is floating point and copied raw if T is the matching unsigned integer.
+		/// </summary>
+		/// <param name="payload">Chunk payload.</param>
+		/// <param name="payloadSize">Chunk payload size.</param>
+		/// <param name="width">Map width.</param>
+		/// <param name="height">Map height.</param>
+		/// <param name="bitDepth">Bit depth of the coded samples: 8, 16, 32 or 64.</param>
+		/// <param name="samples">Destination, width * height samples.</param>
+		/// <param name="threadCount">Threads decoding bands in parallel, 0 = hardware concurrency, 1 = serial.</param>
+		/// <returns>False if the payload is malformed.</returns>
+		template<typename T> static bool Decode(const uint8_t* payload, size_t payloadSize, uint16_t width, uint16_t height, uint8_t bitDepth, T* samples, uint32_t threadCount = 1);
+
+		/// <summary>Decode an 'HCMP' payload into row-major samples, keeping band offsets and per-worker band buffers in `scratch` between calls.</summary>
+		/// <param name="payload">Chunk payload.</param>
+		/// <param name="payloadSize">Chunk payload size.</param>
+		/// <param name="width">Map width.</param>
+		/// <param name="height">Map height.</param>
+		/// <param name="bitDepth">Bit depth of the coded samples: 8, 16, 32 or 64.</param>
+		/// <param name="samples">Destination, width * height samples.</param>
+		/// <param name="threadCount">Threads decoding bands in parallel, 0 = hardware concurrency, 1 = serial.</param>
+		/// <param name="scratch">Reusable working memory, grown as needed and never shrunk.</param>
+		/// <returns>False if the payload is malformed.</returns>
+		template<typename T> static bool Decode(const uint8_t* payload, size_t payloadSize, uint16_t width, uint16_t height, uint8_t bitDepth, T* samples, uint32_t threadCount, std::vector<uint8_t>& scratch);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>Instruction set of the SampleConverter kernels, selected once at runtime from the CPU features.</summary>
+	enum class SampleKernel : uint8_t
+	{
+		Scalar = 0,	// portable element loop, always used on big-endian hosts
+		Sse2 = 1,	// x86 128 bit vectors
+		Avx2 = 2,	// x86 256 bit vectors
+		Avx512 = 3,	// x86 512 bit vectors (AVX-512 F and BW)
+		Neon = 4	// ARM64 128 bit vectors
+	};
+
+	/// <summary>
+	/// Bulk conversions between little-endian payload bytes and native samples: plain loads, byte swapping,
+	/// float to double widening and double to float narrowing, plus the affine map between normalized samples and elevations and the min/max reduction over elevations.
+	/// All kernels produce results bit-identical to the scalar loop.
+	/// </summary>
+	class SampleConverter final
+	{
+	public:
+		/// <summary>Load 32 bit little-endian floats.</summary>
+		static void Load_LittleEndian(const uint8_t* source, size_t count, float* destination) noexcept;
+
+		/// <summary>Load 64 bit little-endian doubles.</summary>
+		static void Load_LittleEndian(const uint8_t* source, size_t count, double* destination) noexcept;
+
+		/// <summary>Load 32 bit little-endian floats, widened to double.</summary>
+		static void Widen_LittleEndian(const uint8_t* source, size_t count, double* destination) noexcept;
+
+		/// <summary>Load 64 bit little-endian doubles, narrowed to float (round to nearest).</summary>
+		static void Narrow_LittleEndian(const uint8_t* source, size_t count, float* destination) noexcept;
+
+		/// <summary>Map samples to source * scale + offset (multiply, then add, no fused rounding), source and destination may be the same buffer.</summary>
+		static void Affine(const float* source, size_t count, float scale, float offset, float* destination) noexcept;
+
+		/// <summary>Map samples to source * scale + offset (multiply, then add, no fused rounding), source and destination may be the same buffer.</summary>
+		static void Affine(const double* source, size_t count, double scale, double offset, double* destination) noexcept;
+
+		/// <summary>Widen minimum and maximum to the range of the samples, NaN samples are skipped.</summary>
+		static void MinMax(const float* source, size_t count, float& minimum, float& maximum) noexcept;
+
+		/// <summary>Widen minimum and maximum to the range of the samples, NaN samples are skipped.</summary>
+		static void MinMax(const double* source, size_t count, double& minimum, double& maximum) noexcept;
+
+		/// <summary>Reverse the bytes of count elements of sampleSize (1, 2, 4 or 8) bytes, source and destination may be the same buffer.</summary>
+		static void ByteSwap(const uint8_t* source, size_t count, size_t sampleSize, uint8_t* destination) noexcept;
+
+		/// <summary>Gets the kernel instruction set selected for the executing CPU.</summary>
+		/// <returns>The active kernel.</returns>
+		static SampleKernel GetKernel() noexcept;
+
+		/// <summary>Gets a printable name of the kernel instruction set selected for the executing CPU.</summary>
+		/// <returns>Kernel name, e.g. "avx2".</returns>
+		static const char* GetKernelName() noexcept;
+
+		/// <summary>Gets whether a kernel is compiled in and supported by the executing CPU and host byte order.</summary>
+		static bool IsKernelSupported(SampleKernel kernel) noexcept;
+
+		// conversions through a specific kernel, e.g. to compare kernels, unsupported kernels run the scalar loop
+
+		/// <summary>Load 32 bit little-endian floats widened to double, through a specific kernel.</summary>
+		static void Widen_LittleEndian(SampleKernel kernel, const uint8_t* source, size_t count, double* destination) noexcept;
+
+		/// <summary>Load 64 bit little-endian doubles narrowed to float, through a specific kernel.</summary>
+		static void Narrow_LittleEndian(SampleKernel kernel, const uint8_t* source, size_t count, float* destination) noexcept;
+
+		/// <summary>Map samples to source * scale + offset, through a specific kernel.</summary>
+		static void Affine(SampleKernel kernel, const float* source, size_t count, float scale, float offset, float* destination) noexcept;
+
+		/// <summary>Map samples to source * scale + offset, through a specific kernel.</summary>
+		static void Affine(SampleKernel kernel, const double* source, size_t count, double scale, double offset, double* destination) noexcept;
+
+		/// <summary>Widen minimum and maximum to the range of the samples, through a specific kernel.</summary>
+		static void MinMax(SampleKernel kernel, const float* source, size_t count, float& minimum, float& maximum) noexcept;
+
+		/// <summary>Widen minimum and maximum to the range of the samples, through a specific kernel.</summary>
+		static void MinMax(SampleKernel kernel, const double* source, size_t count, double& minimum, double& maximum) noexcept;
+
+		/// <summary>Reverse the bytes of count elements of sampleSize bytes, through a specific kernel.</summary>
+		static void ByteSwap(SampleKernel kernel, const uint8_t* source, size_t count, size_t sampleSize, uint8_t* destination) noexcept;
+	};
+}
\ No newline at end of file
@@ -9,6 +9,14 @@
 
 namespace cybex_interactive::jtf
 {
+	/// <summary>CRC-32 implementation used by Crc32::Append, selected once at runtime from the CPU features.</summary>
+	enum class Crc32Engine : uint8_t
+	{
+		SliceBy16 = 0,	// portable, 16 bytes per iteration over 16 lookup tables
+		Pclmul = 1,		// x86 PCLMULQDQ carry-less multiply folding
+		ArmCrc = 2		// ARMv8 CRC32 instructions
+	};
+
 	class Crc32 final
 	{
 	public:
@@ -26,10 +34,40 @@ namespace cybex_interactive::jtf
 		/// <returns>The CRC-32 hash of the provided data.</returns>
 		static uint32_t Hash(const uint8_t* data, size_t length) noexcept;
 
+		/// <summary>Appends data hashed separately (e.g. on another thread), as if its bytes had been passed to Append.</summary>
+		/// <param name="hash">CRC-32 hash of the appended data.</param>
+		/// <param name="length">Length of the appended data in bytes.</param>
+		void AppendHash(uint32_t hash, size_t length) noexcept { m_value = Combine(GetCurrentHashAsUInt32(), hash, length) ^ 0xFFFFFFFFu; }
+
+		/// <summary>Combines the CRC-32 hashes of two consecutive blocks into the hash of their concatenation, without touching the data.</summary>
+		/// <param name="crcA">CRC-32 hash of the first block.</param>
+		/// <param name="crcB">CRC-32 hash of the second block.</param>
+		/// <param name="lengthB">Length of the second block in bytes.</param>
+		/// <returns>The CRC-32 hash of the first block followed by the second block.</returns>
+		static uint32_t Combine(uint32_t crcA, uint32_t crcB, size_t lengthB) noexcept;
+
+		/// <summary>Gets the CRC-32 engine selected for the executing CPU. All engines produce bit-identical results.</summary>
+		/// <returns>The active engine.</returns>
+		static Crc32Engine GetEngine() noexcept;
+
+		/// <summary>Gets a printable name of the CRC-32 engine selected for the executing CPU.</summary>
+		/// <returns>Engine name, e.g. "pclmul".</returns>
+		static const char* GetEngineName() noexcept;
+
+		/// <summary>Gets whether an engine is compiled in and supported by the executing CPU.</summary>
+		static bool IsEngineSupported(Crc32Engine engine) noexcept;
+
+		/// <summary>Computes the CRC-32 hash with a specific engine, e.g. to compare engines. Unsupported engines hash with slice-by-16.</summary>
+		/// <returns>The CRC-32 hash of the provided data.</returns>
+		static uint32_t Hash(Crc32Engine engine, const uint8_t* data, size_t length) noexcept;
+
 		/// <summary>Resets the hash computation to the initial state.</summary>
 		constexpr void Reset() noexcept { m_value = 0xFFFFFFFFu; }
 
 	private:
+		/// <summary>Reference byte-at-a-time table loop, used as fallback and for short tails.</summary>
+		static uint32_t AppendTable(uint32_t crc, const uint8_t* data, size_t length) noexcept;
+
 		uint32_t m_value;
 		static constexpr uint32_t m_table[256] = {
 			0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA,
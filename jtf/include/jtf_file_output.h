@@ -0,0 +1,67 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	// small writes (chunk frames, header fields, tile rows) are gathered in a staging buffer of this size
+	constexpr size_t OUTPUT_STAGING_SIZE = size_t(256) << 10;
+
+	// writes of at least this size bypass the staging buffer, they go out from the caller's memory together with the staged bytes
+	constexpr size_t OUTPUT_GATHER_SIZE = size_t(64) << 10;
+
+	/// <summary>
+	/// Output stream buffer of the writers. Small writes are staged, large payloads are written straight from the caller's memory
+	/// in one vectored write (writev) with the bytes staged before them, so a file takes a handful of write calls.
+	/// With atomic replace the bytes go to a temporary file next to the target, which Commit() syncs to disk and renames over
+	/// the target: readers see either the previous or the complete new file, never a torn one.
+	/// </summary>
+	class FileOutputBuffer final : public std::streambuf
+	{
+	public:
+		/// <summary>Create the output file, check IsOpen() for success.</summary>
+		/// <param name="filePath">Target file path.</param>
+		/// <param name="atomicReplace">Write a temporary file and rename it over the target on Commit(), false writes the target in place.</param>
+		FileOutputBuffer(const std::string& filePath, bool atomicReplace);
+
+		/// <summary>Closes the file. An uncommitted temporary file is removed, the target stays untouched.</summary>
+		~FileOutputBuffer() override;
+
+		FileOutputBuffer(const FileOutputBuffer&) = delete;
+		FileOutputBuffer& operator=(const FileOutputBuffer&) = delete;
+
+		/// <summary>Checks whether the output file was created.</summary>
+		[[nodiscard]] bool IsOpen() const noexcept;
+
+		/// <summary>Write out the staged bytes and close the file. With atomic replace the temporary file is synced and renamed over the target.</summary>
+		/// <returns>Returns false if any write, the sync or the rename failed.</returns>
+		bool Commit();
+
+	protected:
+		int_type overflow(int_type character) override;
+		std::streamsize xsputn(const char_type* data, std::streamsize count) override;
+		int sync() override;
+		pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override;
+
+	private:
+		bool WriteOut(const char* data, size_t size);
+		bool Close() noexcept;
+
+		std::string m_filePath;
+		std::string m_tempPath; // empty when writing in place
+		std::vector<char> m_staging;
+		intptr_t m_file = -1; // file descriptor, or HANDLE on Windows
+		uint64_t m_written = 0; // bytes handed to the file, staged bytes excluded
+		bool m_failed = false;
+		bool m_committed = false;
+	};
+}
\ No newline at end of file
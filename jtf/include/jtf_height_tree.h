@@ -0,0 +1,89 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_parallel.h"
+#include "jtf_utility.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>
+	/// Build the min/max bounds of every quadtree level over samples as stored (uint8_t / uint16_t UNORM, float or double), root first,
+	/// min and max interleaved per cell. Leaves scan their samples in parallel bands of cell rows, every level above reduces 2x2 cells.
+	/// </summary>
+	template<typename S> inline static std::vector<std::vector<S>> BuildHeightTreeBounds(const S* samples, uint16_t width, uint16_t height, uint16_t leafSize, uint32_t threadCount)
+	{
+		std::vector<std::pair<uint16_t, uint16_t>> sizes = HeightTreeLevelSizes(width, height, leafSize);
+		std::vector<std::vector<S>> levels(sizes.size());
+
+		// leaves
+		uint16_t leafCellsX = sizes.back().first;
+		uint16_t leafCellsY = sizes.back().second;
+		std::vector<S>& leaves = levels.back();
+		ResizeTracked(leaves, size_t(leafCellsX) * leafCellsY * 2);
+		ParallelForBands(leafCellsY, PARALLEL_MIN_SLICE_SIZE / (size_t(width) * leafSize * sizeof(S)), threadCount, [&](size_t rowBegin, size_t rowEnd)
+			{
+				for (size_t cellY = rowBegin; cellY < rowEnd; ++cellY)
+				{
+					auto [firstY, lastY] = HeightTreeCellSpan(static_cast<uint32_t>(cellY), leafSize, height);
+					for (uint32_t cellX = 0; cellX < leafCellsX; ++cellX)
+					{
+						auto [firstX, lastX] = HeightTreeCellSpan(cellX, leafSize, width);
+						S low = samples[size_t(firstY) * width + firstX];
+						S high = low;
+						for (uint32_t y = firstY; y <= lastY; ++y)
+						{
+							const S* row = samples + size_t(y) * width;
+							for (uint32_t x = firstX; x <= lastX; ++x)
+							{
+								low = std::min(low, row[x]);
+								high = std::max(high, row[x]);
+							}
+						}
+						size_t cell = (cellY * leafCellsX + cellX) * 2;
+						leaves[cell] = low;
+						leaves[cell + 1] = high;
+					}
+				}
+			});
+
+		// every level above bounds up to 2x2 cells of the level below
+		for (size_t level = levels.size() - 1; level-- > 0;)
+		{
+			uint16_t cellsX = sizes[level].first;
+			uint16_t cellsY = sizes[level].second;
+			uint16_t childCellsX = sizes[level + 1].first;
+			uint16_t childCellsY = sizes[level + 1].second;
+			const std::vector<S>& children = levels[level + 1];
+			std::vector<S>& cells = levels[level];
+			ResizeTracked(cells, size_t(cellsX) * cellsY * 2);
+			ParallelForBands(cellsY, PARALLEL_MIN_SLICE_SIZE / (size_t(childCellsX) * 4 * sizeof(S)), threadCount, [&](size_t rowBegin, size_t rowEnd)
+				{
+					for (size_t cellY = rowBegin; cellY < rowEnd; ++cellY)
+						for (size_t cellX = 0; cellX < cellsX; ++cellX)
+						{
+							size_t first = (cellY * 2 * childCellsX + cellX * 2) * 2;
+							S low = children[first];
+							S high = children[first + 1];
+							for (size_t childY = cellY * 2; childY < std::min<size_t>(cellY * 2 + 2, childCellsY); ++childY)
+								for (size_t childX = cellX * 2; childX < std::min<size_t>(cellX * 2 + 2, childCellsX); ++childX)
+								{
+									size_t child = (childY * childCellsX + childX) * 2;
+									low = std::min(low, children[child]);
+									high = std::max(high, children[child + 1]);
+								}
+							size_t cell = (cellY * cellsX + cellX) * 2;
+							cells[cell] = low;
+							cells[cell + 1] = high;
+						}
+				});
+		}
+		return levels;
+	}
+}
\ No newline at end of file
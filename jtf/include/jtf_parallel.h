@@ -0,0 +1,179 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_convert.h"
+#include "jtf_crc32.h"
+#include "jtf_stats.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	// smallest slice in bytes worth handing to a worker thread, thread start up would dominate below
+	constexpr size_t PARALLEL_MIN_SLICE_SIZE = size_t(1) << 20;
+
+	/// <summary>Resolve a requested worker count: 0 = hardware concurrency, capped so each worker gets at least minimumWork.</summary>
+	inline static uint32_t ResolveThreadCount(uint32_t requested, size_t work, size_t minimumWork)
+	{
+		size_t count = requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+		count = std::min(count, std::max<size_t>(1, work / minimumWork));
+		return static_cast<uint32_t>(count);
+	}
+
+	/// <summary>
+	/// Run task(index) for every index in [0, count), one thread per index, the calling thread runs index 0 and every index whose thread
+	/// could not be started. The first exception is rethrown.
+	/// </summary>
+	template<typename Task> inline static void ParallelFor(uint32_t count, Task&& task)
+	{
+		if (count <= 1)
+		{
+			if (count == 1) task(0u);
+			return;
+		}
+
+		std::vector<std::exception_ptr> errors(count);
+		auto run = [&task, &errors](uint32_t index)
+			{
+				try { task(index); }
+				catch (...) { errors[index] = std::current_exception(); }
+			};
+
+		std::vector<std::thread> workers;
+		workers.reserve(count - 1);
+		uint32_t started = 1;
+		try
+		{
+			for (; started < count; ++started)
+				workers.emplace_back(run, started);
+		}
+		catch (const std::system_error&)
+		{
+			// out of threads, the indices not started run on the calling thread and the started workers are joined below
+		}
+
+		run(0u);
+		for (uint32_t index = started; index < count; ++index)
+			run(index);
+
+		for (std::thread& worker : workers)
+			worker.join();
+		for (std::exception_ptr& error : errors)
+			if (error)
+				std::rethrow_exception(error);
+	}
+
+	/// <summary>Split [0, count) into contiguous bands of at least minimumBand items and run task(begin, end) per band on up to threadCount threads.</summary>
+	template<typename Task> inline static void ParallelForBands(size_t count, size_t minimumBand, uint32_t threadCount, Task&& task)
+	{
+		uint32_t bandCount = ResolveThreadCount(threadCount, count, std::max<size_t>(1, minimumBand));
+		size_t bandSize = (count + bandCount - 1) / bandCount;
+		ParallelFor(bandCount, [&](uint32_t band)
+			{
+				size_t begin = std::min(count, size_t(band) * bandSize);
+				task(begin, std::min(count, begin + bandSize));
+			});
+	}
+
+	/// <summary>Append source to crc, hashing equal slices on up to threadCount threads and combining the partial hashes in order.</summary>
+	inline static void AppendToCrcParallel(const uint8_t* source, size_t length, Crc32& crc, uint32_t threadCount)
+	{
+		StatsTimer timer(&JTF_Stats::CrcNanoseconds);
+		uint32_t sliceCount = ResolveThreadCount(threadCount, length, PARALLEL_MIN_SLICE_SIZE);
+		if (sliceCount <= 1)
+		{
+			crc.Append(source, length);
+			return;
+		}
+
+		size_t sliceSize = (length + sliceCount - 1) / sliceCount;
+		std::vector<uint32_t> hashes(sliceCount);
+		ParallelFor(sliceCount, [&](uint32_t slice)
+			{
+				size_t begin = std::min(length, size_t(slice) * sliceSize);
+				hashes[slice] = Crc32::Hash(source + begin, std::min(length - begin, sliceSize));
+			});
+
+		for (uint32_t slice = 0; slice < sliceCount; ++slice)
+		{
+			size_t begin = std::min(length, size_t(slice) * sliceSize);
+			crc.AppendHash(hashes[slice], std::min(length - begin, sliceSize));
+		}
+	}
+
+	// payload bytes converted and hashed per step of a fused sweep, the block is still in L1 when its second pass runs
+	constexpr size_t FUSED_BLOCK_SIZE = size_t(16) << 10;
+
+	/// <summary>
+	/// Convert count samples and append their payload bytes to crc in a single sweep: convert(begin, end) reads or writes the payload bytes of
+	/// samples [begin, end), which are hashed right after, block by block, while still in cache. Bands run on up to threadCount threads,
+	/// their hashes are combined in order. Halves the memory traffic of a separate hashing pass over a large payload.
+	/// </summary>
+	template<typename Convert> inline static void ConvertAndAppendToCrcParallel(const uint8_t* payload, size_t count, size_t sampleSize, Crc32& crc, uint32_t threadCount, Convert&& convert)
+	{
+		size_t blockSize = std::max<size_t>(1, FUSED_BLOCK_SIZE / sampleSize);
+		uint32_t bandCount = ResolveThreadCount(threadCount, count * sampleSize, PARALLEL_MIN_SLICE_SIZE);
+		size_t bandSize = (count + bandCount - 1) / bandCount;
+		std::vector<uint32_t> hashes(bandCount);
+		ParallelFor(bandCount, [&](uint32_t band)
+			{
+				size_t begin = std::min(count, size_t(band) * bandSize);
+				size_t end = std::min(count, begin + bandSize);
+				Crc32 bandCrc;
+				for (size_t block = begin; block < end; block += blockSize)
+				{
+					size_t blockEnd = std::min(end, block + blockSize);
+					convert(block, blockEnd);
+					bandCrc.Append(payload + block * sampleSize, (blockEnd - block) * sampleSize);
+				}
+				hashes[band] = bandCrc.GetCurrentHashAsUInt32();
+			});
+
+		for (uint32_t band = 0; band < bandCount; ++band)
+		{
+			size_t begin = std::min(count, size_t(band) * bandSize);
+			size_t length = (std::min(count, begin + bandSize) - begin) * sampleSize;
+			if (length > 0)
+				crc.AppendHash(hashes[band], length);
+		}
+	}
+
+	/// <summary>Map source to source * scale + offset in SIMD bands on up to threadCount threads, computed in T. Source and destination may be the same buffer.</summary>
+	template<typename T> inline static void MapAffineParallel(const T* source, size_t count, double scale, double offset, T* destination, uint32_t threadCount)
+	{
+		StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+		ParallelForBands(count, PARALLEL_MIN_SLICE_SIZE / sizeof(T), threadCount, [&](size_t begin, size_t end)
+			{
+				SampleConverter::Affine(source + begin, end - begin, static_cast<T>(scale), static_cast<T>(offset), destination + begin);
+			});
+	}
+
+	/// <summary>Widen minimum and maximum to the range of the samples, NaN samples skipped, reducing bands of SIMD min/max on up to threadCount threads.</summary>
+	template<typename T> inline static void MinMaxParallel(const T* source, size_t count, T& minimum, T& maximum, uint32_t threadCount)
+	{
+		StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+		uint32_t bandCount = ResolveThreadCount(threadCount, count * sizeof(T), PARALLEL_MIN_SLICE_SIZE);
+		size_t bandSize = (count + bandCount - 1) / bandCount;
+		std::vector<T> minima(bandCount, minimum);
+		std::vector<T> maxima(bandCount, maximum);
+		ParallelFor(bandCount, [&](uint32_t band)
+			{
+				size_t begin = std::min(count, size_t(band) * bandSize);
+				SampleConverter::MinMax(source + begin, std::min(count, begin + bandSize) - begin, minima[band], maxima[band]);
+			});
+
+		for (uint32_t band = 0; band < bandCount; ++band)
+		{
+			minimum = minima[band] < minimum ? minima[band] : minimum;
+			maximum = maxima[band] > maximum ? maxima[band] : maximum;
+		}
+	}
+}
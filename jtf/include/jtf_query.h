@@ -0,0 +1,69 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>
+	/// Spatial queries over a height map accelerated by its min/max quadtree: whole subtrees are skipped once their bounds decide the outcome,
+	/// only partially covered leaves touch samples. Everything is in grid space, x and y in samples and z as normalized height, the surface
+	/// between samples is two triangles per quad split along the (x, y) - (x + 1, y + 1) diagonal. Regions are given in samples as for
+	/// JTFFile::ReadRegion. The tree and heights are referenced, not copied, and must outlive the query. Queries are const and thread safe.
+	/// </summary>
+	class JTFHeightQuery final
+	{
+	public:
+		/// <summary>Bind a tree to the samples it was built from.</summary>
+		/// <param name="tree">Tree from JTFFile::ReadHeightTree or BuildTree.</param>
+		/// <param name="heights">Normalized samples in row-major order (tree width * tree height).</param>
+		JTFHeightQuery(const JTF_HeightTree& tree, std::span<const double> heights);
+
+		/// <summary>The tree is referenced, a temporary would dangle once the constructor returns.</summary>
+		JTFHeightQuery(JTF_HeightTree&& tree, std::span<const double> heights) = delete;
+
+		/// <summary>Build a tree in memory, e.g. for files written without one.</summary>
+		/// <param name="heights">Normalized samples in row-major order (width * height).</param>
+		/// <param name="width">Map width, in samples.</param>
+		/// <param name="height">Map height, in samples.</param>
+		/// <param name="leafSize">Quads per leaf cell edge, [2..4096].</param>
+		/// <param name="threadCount">Threads scanning the leaves, 0 = hardware concurrency.</param>
+		static JTF_HeightTree BuildTree(std::span<const double> heights, uint16_t width, uint16_t height, uint16_t leafSize, uint32_t threadCount = 0);
+
+		/// <summary>Gets the lowest and highest sample in a region.</summary>
+		[[nodiscard]] JTF_HeightRange GetRange(uint16_t x, uint16_t y, uint16_t width, uint16_t height) const;
+
+		/// <summary>Gets whether any sample in a region lies within [minHeight, maxHeight], e.g. an axis aligned box against the terrain.</summary>
+		[[nodiscard]] bool Overlaps(uint16_t x, uint16_t y, uint16_t width, uint16_t height, double minHeight, double maxHeight) const;
+
+		/// <summary>Gets whether all samples in a region lie within tolerance of each other.</summary>
+		[[nodiscard]] bool IsFlat(uint16_t x, uint16_t y, uint16_t width, uint16_t height, double tolerance) const;
+
+		/// <summary>Intersect a ray with the surface, nearest hit within ray.MaxDistance.</summary>
+		/// <param name="ray">Ray in grid space, the direction need not be normalized.</param>
+		/// <param name="hit">Receives distance and position of the nearest hit, untouched on a miss.</param>
+		/// <returns>Returns true on a hit.</returns>
+		[[nodiscard]] bool Raycast(const JTF_Ray& ray, JTF_RayHit& hit) const;
+
+		/// <summary>Gets the tree.</summary>
+		[[nodiscard]] const JTF_HeightTree& GetTree() const noexcept { return m_tree; }
+
+	private:
+		struct SampleRect { uint32_t FirstX, FirstY, LastX, LastY; };
+
+		SampleRect MakeRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height) const;
+		SampleRect CellRect(size_t level, uint32_t cellX, uint32_t cellY) const;
+		template<typename Visitor> bool VisitRegion(size_t level, uint32_t cellX, uint32_t cellY, const SampleRect& region, Visitor& visitor) const;
+		bool RaycastCell(size_t level, uint32_t cellX, uint32_t cellY, const JTF_Ray& ray, double& nearest) const;
+		bool IntersectCell(size_t level, uint32_t cellX, uint32_t cellY, const JTF_Ray& ray, double nearest, double& enter) const;
+
+		const JTF_HeightTree& m_tree;
+		std::span<const double> m_heights;
+	};
+}
\ No newline at end of file
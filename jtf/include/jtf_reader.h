@@ -0,0 +1,66 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_types.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>
+	/// Reusable .jtf reader for loops reading many, typically equally sized, files. The file stream and its I/O buffer, the staging of tiled
+	/// and compressed payloads and the decoder working memory persist between reads, output storage is refilled in place.
+	/// Once the buffers have grown to the largest file read, reads without worker threads (ThreadCount = 1, or payloads below
+	/// the parallel threshold) perform no heap allocation. A reader is not thread safe, use one reader per thread.
+	/// </summary>
+	class JTFReader final
+	{
+	public:
+		/// <summary>Create a reader and its I/O buffer.</summary>
+		/// <param name="options">
+		/// Read options applied to every read, e.g. verification thread count. The default (0 = hardware concurrency) starts worker threads
+		/// for large payloads, which allocate on every read; pass ThreadCount = 1 for allocation free reads once warmed up.
+		/// </param>
+		explicit JTFReader(const JTF_ReadOptions& options = JTF_ReadOptions{});
+
+		JTFReader(const JTFReader&) = delete;
+		JTFReader& operator=(const JTFReader&) = delete;
+
+		/// <summary>Read terrain data from .jtf file into storage owned by the reader.</summary>
+		/// <param name="filePath">File path.</param>
+		/// <returns>Returns JTF data struct, valid until the next read.</returns>
+		const JTF& Read(const std::string& filePath);
+
+		/// <summary>Read terrain data from .jtf file into caller storage, reusing the capacity of its height samples.</summary>
+		/// <param name="filePath">File path.</param>
+		/// <param name="data">JTF data struct to refill.</param>
+		void Read(const std::string& filePath, JTF& data);
+
+		/// <summary>Read height samples straight into a caller-provided buffer, widening or narrowing to T (float or double). On error the buffer contents are unspecified.</summary>
+		/// <param name="filePath">File path.</param>
+		/// <param name="destination">Buffer of at least width * height samples, filled in row-major order.</param>
+		/// <returns>Returns the file header.</returns>
+		template<typename T> JTF_Head ReadInto(const std::string& filePath, std::span<T> destination);
+
+		/// <summary>Gets the read options.</summary>
+		[[nodiscard]] const JTF_ReadOptions& GetOptions() const noexcept { return m_options; }
+
+	private:
+		template<typename Resolve> JTF_Head ReadFile(const std::string& filePath, Resolve&& resolve);
+
+		JTF_ReadOptions m_options;
+		std::ifstream m_file;
+		std::unique_ptr<char[]> m_ioBuffer;	// stream buffer, installed before every open
+
+		std::vector<uint8_t> m_payload;	// tiled and compressed chunk payloads, sized to the largest read
+		std::vector<uint8_t> m_scratch;	// decoder working memory, sized to the largest read
+		JTF m_data;
+	};
+}
\ No newline at end of file
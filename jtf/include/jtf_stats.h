@@ -0,0 +1,108 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_types.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace cybex_interactive::jtf
+{
+	// stats of the read or write running on this thread, null when instrumentation is disabled (worker threads never collect)
+	inline thread_local JTF_Stats* t_stats = nullptr;
+
+	inline static uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point start) noexcept
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	/// <summary>
+	/// Collect into stats on this thread for the lifetime of the scope and add the scope duration to TotalNanoseconds.
+	/// A null stats keeps an enclosing scope collecting, a scope nested in one for the same stats adds no time of its own.
+	/// </summary>
+	class StatsScope final
+	{
+	public:
+		explicit StatsScope(JTF_Stats* stats) noexcept : m_stats(stats != t_stats ? stats : nullptr), m_previous(t_stats)
+		{
+			if (m_stats)
+			{
+				t_stats = m_stats;
+				m_start = std::chrono::steady_clock::now();
+			}
+		}
+
+		~StatsScope()
+		{
+			if (m_stats) m_stats->TotalNanoseconds += ElapsedNanoseconds(m_start);
+			t_stats = m_previous;
+		}
+
+		StatsScope(const StatsScope&) = delete;
+		StatsScope& operator=(const StatsScope&) = delete;
+
+	private:
+		JTF_Stats* m_stats;
+		JTF_Stats* m_previous;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	/// <summary>Add the scope duration to one phase counter of the stats collected on this thread, a no-op if none are.</summary>
+	class StatsTimer final
+	{
+	public:
+		explicit StatsTimer(uint64_t JTF_Stats::* counter) noexcept : m_stats(t_stats), m_counter(counter)
+		{
+			if (m_stats) m_start = std::chrono::steady_clock::now();
+		}
+
+		~StatsTimer()
+		{
+			if (m_stats) m_stats->*m_counter += ElapsedNanoseconds(m_start);
+		}
+
+		StatsTimer(const StatsTimer&) = delete;
+		StatsTimer& operator=(const StatsTimer&) = delete;
+
+	private:
+		JTF_Stats* m_stats;
+		uint64_t JTF_Stats::* m_counter;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	/// <summary>Add to one counter of the stats collected on this thread.</summary>
+	inline static void CountStat(uint64_t JTF_Stats::* counter, uint64_t value) noexcept
+	{
+		if (t_stats) t_stats->*counter += value;
+	}
+
+	/// <summary>Resize a library buffer, counting the allocation if it has to grow.</summary>
+	template<typename Buffer> inline static void ResizeTracked(Buffer& buffer, size_t size)
+	{
+		if (t_stats && size > buffer.capacity())
+		{
+			++t_stats->Allocations;
+			t_stats->AllocatedBytes += size * sizeof(typename Buffer::value_type);
+		}
+		buffer.resize(size);
+	}
+
+	/// <summary>Add all counters of source to target.</summary>
+	inline static void MergeStats(JTF_Stats& target, const JTF_Stats& source) noexcept
+	{
+		target.BytesRead += source.BytesRead;
+		target.BytesWritten += source.BytesWritten;
+		target.IoNanoseconds += source.IoNanoseconds;
+		target.CrcNanoseconds += source.CrcNanoseconds;
+		target.ConvertNanoseconds += source.ConvertNanoseconds;
+		target.TotalNanoseconds += source.TotalNanoseconds;
+		target.ChunksVisited += source.ChunksVisited;
+		target.ChunksSkipped += source.ChunksSkipped;
+		target.Allocations += source.Allocations;
+		target.AllocatedBytes += source.AllocatedBytes;
+		target.WriteCalls += source.WriteCalls;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_types.h"
+#include "jtf_crc32.h"
+#include "jtf_file_output.h"
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>
+	/// Writes a .jtf file incrementally in row bands. Signature, HEAD and the HMAP chunk header are written on construction,
+	/// rows are appended as they are produced and the chunk and file CRCs are computed on the fly.
+	/// Memory is bounded by the band size passed to AppendRows().
+	/// </summary>
+	template<typename T> class JTFStreamWriter final
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTF supports only float or double for T.");
+
+	public:
+		/// <summary>Create .jtf file and write signature, HEAD and the HMAP chunk header.</summary>
+		/// <param name="filePath">File path.</param>
+		/// <param name="width">Terrain width. Max value = 4097.</param>
+		/// <param name="height">Terrain height. Max value = 4097.</param>
+		/// <param name="boundsLower">Lowest Elevation floored to next lesser int32_t.</param>
+		/// <param name="boundsUpper">Highest Elevation ceiled to next greater int32_t.</param>
+		JTFStreamWriter(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper);
+
+		/// <summary>Closes the file. An unfinished file never replaces the target, it would not pass validation.</summary>
+		~JTFStreamWriter();
+
+		JTFStreamWriter(const JTFStreamWriter&) = delete;
+		JTFStreamWriter& operator=(const JTFStreamWriter&) = delete;
+
+		/// <summary>Append a band of complete rows.</summary>
+		/// <param name="rows">Heights, normalized with bounds as extents, row-major. Size must be a multiple of width.</param>
+		void AppendRows(std::span<const T> rows);
+
+		/// <summary>Write the HMAP CRC, the FEND chunk and the file CRC. All rows must have been appended.</summary>
+		void Finish();
+
+		/// <summary>Gets the number of rows appended so far.</summary>
+		[[nodiscard]] uint32_t GetRowsWritten() const noexcept { return m_rowsWritten; }
+
+	private:
+		std::string m_filePath;
+		FileOutputBuffer m_output; // temporary file, renamed over the target by Finish()
+		std::ostream m_file;
+
+		uint16_t m_width = 0;
+		uint16_t m_height = 0;
+		uint32_t m_rowsWritten = 0;
+		bool m_finished = false;
+
+		Crc32 m_chunkCrc;
+		Crc32 m_fileCrc;
+
+		std::vector<uint8_t> m_encoded; // byte swap staging on big-endian hosts, sized to the largest band
+	};
+
+	/// <summary>
+	/// Reads a .jtf file incrementally in row bands. Signature and HEAD are parsed on construction, HMAP rows are then pulled
+	/// into caller provided buffers. The HMAP chunk CRC is computed on the fly and verified once the last row has been read.
+	/// Memory is bounded by the band size passed to ReadRows().
+	/// </summary>
+	class JTFStreamReader final
+	{
+	public:
+		/// <summary>Open .jtf file, validate the signature, read HEAD and position at the first HMAP row.</summary>
+		/// <param name="filePath">File path.</param>
+		/// <param name="verifyFileCrc">Read FEND and verify the file CRC after the last row.</param>
+		explicit JTFStreamReader(const std::string& filePath, bool verifyFileCrc = true);
+
+		JTFStreamReader(const JTFStreamReader&) = delete;
+		JTFStreamReader& operator=(const JTFStreamReader&) = delete;
+
+		/// <summary>Gets the decoded header.</summary>
+		[[nodiscard]] const JTF_Head& GetHeader() const noexcept { return m_header; }
+
+		/// <summary>Gets the number of rows read so far.</summary>
+		[[nodiscard]] uint32_t GetRowsRead() const noexcept { return m_rowsRead; }
+
+		/// <summary>Gets the number of rows not yet read.</summary>
+		[[nodiscard]] uint32_t GetRowsRemaining() const noexcept { return m_header.Height - m_rowsRead; }
+
+		/// <summary>
+		/// Read the next band of rows. As many complete rows as fit into `band` are read, samples are converted to T
+		/// (8 and 16 bit samples are dequantized for float and double, uint8_t and uint16_t read raw samples of matching bit depth).
+		/// Reading the last row verifies the HMAP chunk CRC (and the file CRC if requested) and throws on mismatch.
+		/// </summary>
+		/// <param name="band">Destination, at least one row (width samples).</param>
+		/// <returns>Number of rows read, 0 once all rows have been read.</returns>
+		template<typename T> uint32_t ReadRows(std::span<T> band);
+
+	private:
+		void FinishChunk();
+
+		std::string m_filePath;
+		std::ifstream m_file;
+		bool m_verifyFileCrc = true;
+
+		JTF_Head m_header;
+		uint32_t m_rowsRead = 0;
+
+		Crc32 m_chunkCrc;
+		Crc32 m_fileCrc;
+
+		std::vector<uint8_t> m_staging; // raw band bytes when converting, sized to the largest band
+	};
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>
+	/// Work-stealing thread pool. Every worker owns a task deque: submitted tasks are spread round-robin (or pushed to the
+	/// submitting worker's own deque), a worker takes its newest task first and, once its deque runs dry, steals the oldest
+	/// task of another worker. Tasks handle their own errors, an exception escaping a task terminates the process.
+	/// </summary>
+	class ThreadPool final
+	{
+	public:
+		/// <summary>Start the worker threads.</summary>
+		/// <param name="threadCount">Worker count, 0 = hardware concurrency.</param>
+		explicit ThreadPool(uint32_t threadCount);
+
+		/// <summary>Waits for all submitted tasks, then joins the workers.</summary>
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/// <summary>Queue a task for execution on a worker.</summary>
+		void Submit(std::function<void()> task);
+
+		/// <summary>Block until every submitted task has finished.</summary>
+		void Wait();
+
+		/// <summary>Gets the number of worker threads.</summary>
+		[[nodiscard]] uint32_t GetThreadCount() const noexcept { return static_cast<uint32_t>(m_workers.size()); }
+
+	private:
+		struct TaskQueue
+		{
+			std::mutex Mutex;
+			std::deque<std::function<void()>> Tasks;
+		};
+
+		void Run(size_t self);
+		bool TryTake(size_t self, std::function<void()>& task);
+
+		std::vector<std::unique_ptr<TaskQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_mutex;
+		std::condition_variable m_taskAvailable;
+		std::condition_variable m_allDone;
+		size_t m_queued = 0;	// tasks waiting in the deques
+		size_t m_pending = 0;	// tasks submitted and not finished
+		size_t m_nextQueue = 0;
+		bool m_stopping = false;
+	};
+}
\ No newline at end of file
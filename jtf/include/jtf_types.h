@@ -5,10 +5,24 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
+#include <variant>
 #include <vector>
 
 namespace cybex_interactive::jtf
 {
+	enum class JTF_Layout : uint8_t
+	{
+		Linear = 0,	// 'HMAP' single row-major sample array
+		Tiled = 1	// 'HTIL' fixed-size tiles with tile index and per-tile CRCs
+	};
+
+	enum class JTF_Compression : uint8_t
+	{
+		None = 0,		// raw samples in 'HMAP' or 'HTIL'
+		PredictiveLZ = 1	// 'HCMP' gradient predicted, byte-plane shuffled and LZ coded samples
+	};
+
 	struct JTF_Head
 	{
 		uint8_t VersionMajor = 0;
@@ -20,6 +34,10 @@ namespace cybex_interactive::jtf
 
 		uint8_t BitDepth = 0;
 
+		JTF_Layout Layout = JTF_Layout::Linear;
+		JTF_Compression Compression = JTF_Compression::None;
+		bool ChunkDirectory = false; // 'HDIR' chunk before 'FEND', see JTF_WriteOptions::ChunkDirectory
+
 		int32_t BoundsLower = 0;
 		int32_t BoundsUpper = 0;
 		int32_t BoundsRange() const { return BoundsUpper - BoundsLower; }
@@ -35,4 +53,148 @@ namespace cybex_interactive::jtf
 		JTF_Head Header;
 		JTF_Heights Heights;
 	};
+
+	struct JTF_NativeHeights
+	{
+		// samples at the file's bit depth: 32 = float, 64 = double, 16 / 8 = raw UNORM uint16_t / uint8_t (monostate if HMAP was not read)
+		std::variant<std::monostate, std::vector<float>, std::vector<double>, std::vector<uint16_t>, std::vector<uint8_t>> HeightSamples;
+	};
+
+	struct JTF_Native
+	{
+		JTF_Head Header;
+		JTF_NativeHeights Heights;
+	};
+
+	struct JTF_Region
+	{
+		JTF_Head Header;
+
+		// region within the map, in samples
+		uint16_t X = 0;
+		uint16_t Y = 0;
+		uint16_t Width = 0;
+		uint16_t Height = 0;
+
+		// region samples in row-major order (Width * Height)
+		JTF_Heights Heights;
+	};
+
+	struct JTF_Lod
+	{
+		JTF_Head Header; // full resolution header
+
+		uint8_t Level = 0;		// 0 = full resolution, n = halved n times
+		uint8_t LevelCount = 0;	// downsampled levels stored in the file
+		uint16_t Width = 0;
+		uint16_t Height = 0;
+
+		// level samples in row-major order (Width * Height)
+		JTF_Heights Heights;
+	};
+
+	struct JTF_HeightTreeLevel
+	{
+		uint16_t CellsX = 0;
+		uint16_t CellsY = 0;
+
+		// min, max per cell in row-major order (CellsX * CellsY * 2), normalized like the samples
+		std::vector<double> Bounds;
+	};
+
+	/// <summary>
+	/// Min/max quadtree over the height samples. A leaf cell spans LeafSize quads per edge, sharing its border samples with its neighbours,
+	/// every level above halves the cell count per axis down to a single root cell.
+	/// </summary>
+	struct JTF_HeightTree
+	{
+		uint16_t Width = 0;		// map extents, in samples
+		uint16_t Height = 0;
+		uint16_t LeafSize = 0;
+
+		// root first, leaves last
+		std::vector<JTF_HeightTreeLevel> Levels;
+	};
+
+	struct JTF_HeightRange
+	{
+		double Min = 0.0;
+		double Max = 0.0;
+	};
+
+	/// <summary>Ray in grid space: x and y in samples (0 .. width - 1, 0 .. height - 1), z as normalized height.</summary>
+	struct JTF_Ray
+	{
+		double Origin[3] = { 0.0, 0.0, 0.0 };
+		double Direction[3] = { 0.0, 0.0, -1.0 };
+		double MaxDistance = 1e300; // in multiples of the direction length
+	};
+
+	struct JTF_RayHit
+	{
+		double Distance = 0.0; // in multiples of the direction length
+		double Position[3] = { 0.0, 0.0, 0.0 };
+	};
+
+	struct JTF_ChunkEntry
+	{
+		uint32_t Type = 0;		// chunk ID, e.g. CHUNK_ID_HMAP
+		uint32_t Length = 0;	// payload bytes
+		uint64_t Offset = 0;	// file offset of the chunk length field
+		uint32_t Crc = 0;		// chunk CRC-32
+	};
+
+	struct JTF_BatchResult
+	{
+		JTF Data;			// populated if Error is empty
+		std::string Error;	// empty on success, otherwise the read error message
+	};
+
+	/// <summary>Headers of many .jtf files, see JTFFile::ScanHeaders(). The arrays run parallel, one entry per file.</summary>
+	struct JTF_HeaderScan
+	{
+		std::vector<std::string> FilePaths;	// scanned files, in order
+		std::vector<JTF_Head> Headers;		// default constructed where the file failed
+		std::vector<std::string> Errors;	// empty on success, otherwise the read error message
+		size_t FailedCount = 0;
+	};
+
+	/// <summary>
+	/// Optional instrumentation of a read or write, passed through JTF_ReadOptions::Stats or JTF_WriteOptions::Stats.
+	/// Counters accumulate across calls, times are wall clock nanoseconds measured on the calling thread.
+	/// </summary>
+	struct JTF_Stats
+	{
+		uint64_t BytesRead = 0;
+		uint64_t BytesWritten = 0;
+		uint64_t IoNanoseconds = 0;			// file reads, payload skips and payload writes
+		uint64_t CrcNanoseconds = 0;		// chunk and file CRC computation
+		uint64_t ConvertNanoseconds = 0;	// sample conversion: widening, (de)quantization, tile assembly and HCMP coding, including CRC fused into an HMAP conversion sweep
+		uint64_t TotalNanoseconds = 0;		// whole call
+		uint64_t ChunksVisited = 0;			// chunk headers read
+		uint64_t ChunksSkipped = 0;			// chunks not requested, payload skipped
+		uint64_t Allocations = 0;			// payload, sample, staging and scratch buffer (re)allocations
+		uint64_t AllocatedBytes = 0;
+		uint64_t WriteCalls = 0;			// write system calls issued for the output file
+	};
+
+	struct JTF_WriteOptions
+	{
+		JTF_Layout Layout = JTF_Layout::Linear;
+		uint16_t TileSize = 256; // tile edge length in samples for JTF_Layout::Tiled
+		JTF_Compression Compression = JTF_Compression::None; // lossless, linear layout only
+		uint8_t BitDepth = 0; // 0 = bit depth of T, 16 / 8 = quantize to unsigned normalized integers
+		uint8_t LodLevels = 0; // downsampled levels stored in an 'HLOD' chunk for JTFFile::ReadLod(), each halving the previous, 0 = none
+		uint16_t HeightTreeLeafSize = 0; // quads per leaf cell edge of the min/max quadtree stored in an 'HQDT' chunk for JTFHeightQuery, 0 = none
+		bool ChunkDirectory = false; // 'HDIR' chunk listing every chunk, letting readers seek straight to the chunks they request
+		bool AtomicReplace = false; // write a temporary file, sync it and rename it over the target (or the file a symbolic link points to), readers never see a partially written file; costs a file and a directory sync, needs a writable parent directory and gives the file a new owner
+		uint32_t ThreadCount = 0; // worker threads encoding and hashing large payloads, 0 = hardware concurrency, 1 = serial
+		JTF_Stats* Stats = nullptr; // optional instrumentation, null = disabled
+	};
+
+	struct JTF_ReadOptions
+	{
+		uint32_t ThreadCount = 0; // worker threads verifying and decoding large payloads, 0 = hardware concurrency, 1 = serial
+		JTF_Stats* Stats = nullptr; // optional instrumentation, null = disabled
+	};
 }
\ No newline at end of file
@@ -4,8 +4,16 @@
 
 #pragma once
 
+#include "jtf_crc32.h"
+#include "jtf_stats.h"
+#include "jtf_types.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
+#include <initializer_list>
+#include <limits>
+#include <utility>
 
 namespace cybex_interactive::jtf
 {
@@ -51,10 +59,284 @@ namespace cybex_interactive::jtf
 		}
 	}
 
+	/// <summary>Unsigned integer type of the given byte size, used to handle sample bit patterns.</summary>
+	template<size_t Size> using UIntOfSize = std::conditional_t<Size == 1, uint8_t, std::conditional_t<Size == 2, uint16_t, std::conditional_t<Size == 4, uint32_t, uint64_t>>>;
+
+	/// <summary>Checks for a supported sample bit depth: 8 / 16 bit UNORM, 32 bit float, 64 bit double.</summary>
+	inline static bool IsSupportedBitDepth(uint8_t bitDepth)
+	{
+		return bitDepth == 8 || bitDepth == 16 || bitDepth == 32 || bitDepth == 64;
+	}
+
+	/// <summary>Quantize normalized samples to unsigned normalized integers, clamped to [0, 1] (NaN to 0) and rounded to nearest.</summary>
+	template<typename Q, typename T> inline static void QuantizeUnorm(const T* samples, size_t count, Q* quantized)
+	{
+		constexpr T scale = static_cast<T>(std::numeric_limits<Q>::max());
+		for (size_t i = 0; i < count; ++i)
+		{
+			T sample = samples[i];
+			sample = sample > T(0) ? (sample < T(1) ? sample : T(1)) : T(0);
+			quantized[i] = static_cast<Q>(sample * scale + T(0.5));
+		}
+	}
+
+	/// <summary>Quantize samples mapped to normalized samples by sample * scale + offset (multiply, then add), clamped and rounded as by QuantizeUnorm().</summary>
+	template<typename Q, typename T> inline static void QuantizeUnorm(const T* samples, size_t count, T scale, T offset, Q* quantized)
+	{
+		constexpr T range = static_cast<T>(std::numeric_limits<Q>::max());
+		for (size_t i = 0; i < count; ++i)
+		{
+			T sample = samples[i] * scale;
+			sample = sample + offset;
+			sample = sample > T(0) ? (sample < T(1) ? sample : T(1)) : T(0);
+			quantized[i] = static_cast<Q>(sample * range + T(0.5));
+		}
+	}
+
+	/// <summary>Dequantize unsigned normalized integers to normalized samples in [0, 1].</summary>
+	template<typename T, typename Q> inline static void DequantizeUnorm(const Q* quantized, size_t count, T* samples)
+	{
+		constexpr T scale = T(1) / static_cast<T>(std::numeric_limits<Q>::max());
+		for (size_t i = 0; i < count; ++i)
+			samples[i] = static_cast<T>(quantized[i]) * scale;
+	}
+
 	inline static void AppendToCrc(const uint8_t* source, size_t length, std::initializer_list<Crc32*> crcs)
 	{
+		StatsTimer timer(&JTF_Stats::CrcNanoseconds);
 		for (Crc32* crc : crcs)
 			if (crc)
 				crc->Append(source, length);
 	}
-}
\ No newline at end of file
+
+
+	inline static int32_t ReadInt32_LittleEndian(const uint8_t* pointer)
+	{
+		uint32_t raw = (static_cast<uint32_t>(pointer[0]))
+					 | (static_cast<uint32_t>(pointer[1]) << 8)
+					 | (static_cast<uint32_t>(pointer[2]) << 16)
+					 | (static_cast<uint32_t>(pointer[3]) << 24);
+		return static_cast<int32_t>(raw);
+	}
+
+	inline static uint8_t ReadUInt8_LittleEndian(const uint8_t* pointer)
+	{
+		return (static_cast<uint8_t>(pointer[0]));
+	}
+
+	inline static uint16_t ReadUInt16_LittleEndian(const uint8_t* pointer)
+	{
+		return (static_cast<uint16_t>(pointer[0]))
+			 | (static_cast<uint16_t>(pointer[1]) << 8);
+	}
+
+	inline static uint32_t ReadUInt32_LittleEndian(const uint8_t* pointer)
+	{
+		return (static_cast<uint32_t>(pointer[0]))
+			 | (static_cast<uint32_t>(pointer[1]) << 8)
+			 | (static_cast<uint32_t>(pointer[2]) << 16)
+			 | (static_cast<uint32_t>(pointer[3]) << 24);
+	}
+
+	inline static uint64_t ReadUInt64_LittleEndian(const uint8_t* pointer)
+	{
+		return (static_cast<uint64_t>(pointer[0]))
+			 | (static_cast<uint64_t>(pointer[1]) << 8)
+			 | (static_cast<uint64_t>(pointer[2]) << 16)
+			 | (static_cast<uint64_t>(pointer[3]) << 24)
+			 | (static_cast<uint64_t>(pointer[4]) << 32)
+			 | (static_cast<uint64_t>(pointer[5]) << 40)
+			 | (static_cast<uint64_t>(pointer[6]) << 48)
+			 | (static_cast<uint64_t>(pointer[7]) << 56);
+	}
+
+	inline static float ReadFloat_LittleEndian(const uint8_t* pointer)
+	{
+		uint32_t raw = (static_cast<uint32_t>(pointer[0]))
+					 | (static_cast<uint32_t>(pointer[1]) << 8)
+					 | (static_cast<uint32_t>(pointer[2]) << 16)
+					 | (static_cast<uint32_t>(pointer[3]) << 24);
+		float value;
+		static_assert(sizeof(value) == sizeof(raw));
+		std::memcpy(&value, &raw, sizeof(value));
+		return value;
+	}
+
+	inline static double ReadDouble_LittleEndian(const uint8_t* pointer)
+	{
+		uint64_t raw = (static_cast<uint64_t>(pointer[0]))
+					 | (static_cast<uint64_t>(pointer[1]) << 8)
+					 | (static_cast<uint64_t>(pointer[2]) << 16)
+					 | (static_cast<uint64_t>(pointer[3]) << 24)
+					 | (static_cast<uint64_t>(pointer[4]) << 32)
+					 | (static_cast<uint64_t>(pointer[5]) << 40)
+					 | (static_cast<uint64_t>(pointer[6]) << 48)
+					 | (static_cast<uint64_t>(pointer[7]) << 56);
+		double value;
+		static_assert(sizeof(value) == sizeof(raw));
+		std::memcpy(&value, &raw, sizeof(value));
+		return value;
+	}
+
+	inline static void StoreUInt16_LittleEndian(uint8_t* pointer, uint16_t value)
+	{
+		pointer[0] = static_cast<uint8_t>(value);
+		pointer[1] = static_cast<uint8_t>(value >> 8);
+	}
+
+	inline static void StoreUInt32_LittleEndian(uint8_t* pointer, uint32_t value)
+	{
+		for (int i = 0; i < 4; ++i)
+			pointer[i] = static_cast<uint8_t>(value >> (8 * i));
+	}
+
+	inline static void StoreUInt64_LittleEndian(uint8_t* pointer, uint64_t value)
+	{
+		for (int i = 0; i < 8; ++i)
+			pointer[i] = static_cast<uint8_t>(value >> (8 * i));
+	}
+
+	inline static void UInt64_BigEndian(uint64_t value, uint8_t* out)
+	{
+		for (int i = 7; i >= 0; --i)
+		{
+			out[i] = static_cast<uint8_t>(value & 0xFF);
+			value >>= 8;
+		}
+	}
+
+
+	/// <summary>Decode the fixed 32 byte 'HEAD' payload (CRC already verified).</summary>
+	inline static void DecodeHeadPayload(const uint8_t* payload, JTF_Head& header)
+	{
+		size_t offset = 0;
+
+		// version major
+		header.VersionMajor = ReadUInt8_LittleEndian(payload + offset);
+		offset++;
+		// version minor
+		header.VersionMinor = ReadUInt8_LittleEndian(payload + offset);
+		offset++;
+		// version patch
+		header.VersionPatch = ReadUInt8_LittleEndian(payload + offset);
+		offset++;
+
+		// dimensions
+		header.Width = ReadUInt16_LittleEndian(payload + offset);
+		offset += 2;
+		header.Height = ReadUInt16_LittleEndian(payload + offset);
+		offset += 2;
+
+		// bit depth
+		header.BitDepth = ReadUInt8_LittleEndian(payload + offset);
+		offset++;
+
+		// layout
+		header.Layout = static_cast<JTF_Layout>(ReadUInt8_LittleEndian(payload + offset));
+		offset++;
+
+		// compression
+		header.Compression = static_cast<JTF_Compression>(ReadUInt8_LittleEndian(payload + offset));
+		offset++;
+
+		// chunk directory
+		header.ChunkDirectory = ReadUInt8_LittleEndian(payload + offset) != 0;
+		offset++;
+
+		// RESERVED 5 BYTES ([11..16] = 0 by default)
+		offset += 5;
+
+		// bounds
+		header.BoundsLower = ReadInt32_LittleEndian(payload + offset);
+		offset += 4;
+		header.BoundsUpper = ReadInt32_LittleEndian(payload + offset);
+		offset += 4;
+
+		// RESERVED 8 BYTES ([24..32] = 0 by default)
+		offset += 8;
+	}
+
+
+	constexpr size_t HTIL_HEADER_SIZE = 8;		// tile size, tiles x, tiles y, reserved (UInt16 each)
+	constexpr size_t HTIL_INDEX_ENTRY_SIZE = 12;	// offset, size, CRC-32 (UInt32 each)
+
+	/// <summary>Tile arrangement of the 'HTIL' chunk, edge tiles are clipped to the map.</summary>
+	struct TileGrid
+	{
+		uint16_t Width = 0;
+		uint16_t Height = 0;
+		uint16_t TileSize = 0;
+		uint16_t TilesX = 0;
+		uint16_t TilesY = 0;
+
+		static TileGrid Create(uint16_t width, uint16_t height, uint16_t tileSize)
+		{
+			TileGrid grid;
+			grid.Width = width;
+			grid.Height = height;
+			grid.TileSize = tileSize;
+			grid.TilesX = static_cast<uint16_t>((width + tileSize - 1) / tileSize);
+			grid.TilesY = static_cast<uint16_t>((height + tileSize - 1) / tileSize);
+			return grid;
+		}
+
+		size_t TileCount() const { return size_t(TilesX) * size_t(TilesY); }
+		uint32_t TileWidth(uint32_t tileX) const { return std::min<uint32_t>(TileSize, Width - tileX * TileSize); }
+		uint32_t TileHeight(uint32_t tileY) const { return std::min<uint32_t>(TileSize, Height - tileY * TileSize); }
+		size_t IndexSize() const { return HTIL_HEADER_SIZE + TileCount() * HTIL_INDEX_ENTRY_SIZE; }
+	};
+
+
+	constexpr size_t HLOD_HEADER_SIZE = 4;			// level count, reserved (UInt16 each)
+	constexpr size_t HLOD_INDEX_ENTRY_SIZE = 16;	// width, height (UInt16 each), offset, size, CRC-32 (UInt32 each)
+	constexpr uint8_t LOD_LEVEL_LIMIT = 12;			// a 4097 map halves down to a single sample in 12 levels
+
+	/// <summary>Edge length of the next coarser 'HLOD' level, centered on every second sample of the finer level, corners included.</summary>
+	inline static uint16_t LodLevelSize(uint16_t size) { return static_cast<uint16_t>((size + 1) / 2); }
+
+	/// <summary>Number of 'HLOD' levels stored for a map, the pyramid stops once a level is a single sample.</summary>
+	inline static uint8_t LodLevelCount(uint16_t width, uint16_t height, uint8_t requested)
+	{
+		uint8_t count = 0;
+		while (count < requested && (width > 1 || height > 1))
+		{
+			width = LodLevelSize(width);
+			height = LodLevelSize(height);
+			++count;
+		}
+		return count;
+	}
+
+
+	constexpr size_t HQDT_HEADER_SIZE = 8;			// leaf size, level count (UInt16 each), reserved (UInt32)
+	constexpr uint16_t HEIGHT_TREE_LEAF_MIN = 2;
+	constexpr uint16_t HEIGHT_TREE_LEAF_MAX = 4096;
+
+	/// <summary>First and last sample (inclusive) covered by a cell of cellSize quads, neighbouring cells share their border sample.</summary>
+	inline static std::pair<uint32_t, uint32_t> HeightTreeCellSpan(uint32_t cell, uint32_t cellSize, uint16_t samples)
+	{
+		uint32_t first = cell * cellSize;
+		uint32_t last = std::min<uint32_t>(first + cellSize, std::max<uint32_t>(samples, 1) - 1);
+		return { first, std::max(first, last) };
+	}
+
+	/// <summary>Cells per axis of every 'HQDT' level, root first. Leaves span leafSize quads per edge, each level above halves the cell count.</summary>
+	inline static std::vector<std::pair<uint16_t, uint16_t>> HeightTreeLevelSizes(uint16_t width, uint16_t height, uint16_t leafSize)
+	{
+		auto leafCells = [leafSize](uint16_t samples) { return static_cast<uint16_t>(std::max<uint32_t>(1, (uint32_t(samples) + leafSize - 2) / leafSize)); };
+
+		std::vector<std::pair<uint16_t, uint16_t>> sizes{ { leafCells(width), leafCells(height) } };
+		while (sizes.back().first > 1 || sizes.back().second > 1)
+			sizes.push_back({ LodLevelSize(sizes.back().first), LodLevelSize(sizes.back().second) });
+		std::reverse(sizes.begin(), sizes.end());
+		return sizes;
+	}
+
+	constexpr size_t CHUNK_FRAME_SIZE = 12;			// chunk length, type, CRC-32 (UInt32 each) around every payload
+	constexpr size_t HEAD_PAYLOAD_SIZE = 32;
+	constexpr size_t HEAD_PREFIX_SIZE = 52;			// signature, 'HEAD' chunk frame and payload, the fixed-size start of every file
+	constexpr size_t HDIR_ENTRY_SIZE = 24;			// type, length (UInt32 each), offset (UInt64), CRC-32, reserved (UInt32 each)
+	constexpr size_t HDIR_TRAILER_SIZE = 4;			// entry count (UInt32), last in the payload so readers find it from the file end
+	constexpr size_t FILE_TAIL_SIZE = 16;			// 'FEND' chunk and file CRC-32 following the 'HDIR' chunk
+	constexpr size_t HDIR_TAIL_READ_SIZE = 4096;	// file tail read at once, holds the directory of files up to 169 chunks
+}
@@ -0,0 +1,76 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#pragma once
+
+#include "jtf_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace cybex_interactive::jtf
+{
+	/// <summary>
+	/// Read-only, zero-copy view of a .jtf file. The file is memory mapped, validated in place and
+	/// the height samples are exposed directly over the mapping, nothing is copied onto the heap.
+	/// </summary>
+	class JTFView final
+	{
+	public:
+		/// <summary>Map .jtf file and validate signature, chunk layout and CRCs in place.</summary>
+		/// <param name="filePath">File path.</param>
+		/// <param name="verifyPayloadCrc">Hash the HMAP payload to verify its chunk CRC (touches every page). HEAD, FEND and file CRC are always verified.</param>
+		explicit JTFView(const std::string& filePath, bool verifyPayloadCrc = true);
+		~JTFView();
+
+		JTFView(const JTFView&) = delete;
+		JTFView& operator=(const JTFView&) = delete;
+		JTFView(JTFView&& other) noexcept;
+		JTFView& operator=(JTFView&& other) noexcept;
+
+		/// <summary>Gets the decoded header.</summary>
+		[[nodiscard]] const JTF_Head& GetHeader() const noexcept { return m_header; }
+
+		/// <summary>Gets the number of height samples (width * height).</summary>
+		[[nodiscard]] size_t GetSampleCount() const noexcept { return m_sampleCount; }
+
+		/// <summary>Gets the raw little-endian HMAP payload bytes over the mapping.</summary>
+		[[nodiscard]] std::span<const std::byte> GetRawSamples() const noexcept { return { reinterpret_cast<const std::byte*>(m_samples), m_sampleBytes }; }
+
+		/// <summary>
+		/// Checks whether GetSamples&lt;T&gt;() can expose the payload as typed span: T matches the bit depth,
+		/// the host is little-endian and the payload is aligned for T within the mapping.
+		/// </summary>
+		template<typename T> [[nodiscard]] bool HasSampleSpan() const noexcept;
+
+		/// <summary>
+		/// Gets the height samples as typed span straight over the mapping (row-major, normalized). The HMAP payload of a file without
+		/// optional chunks starts at byte offset 60 (signature 8, HEAD chunk 44, HMAP frame 8), aligned for 8, 16 and 32-bit samples but not
+		/// for double: HasSampleSpan&lt;double&gt;() is false for such 64-bit files, read them through GetSample() or GetRawSamples().
+		/// </summary>
+		/// <returns>Span of uint8_t (8 bit), uint16_t (16 bit) raw UNORM, float (32 bit) or double (64 bit) samples. Throws if HasSampleSpan&lt;T&gt;() is false.</returns>
+		template<typename T> [[nodiscard]] std::span<const T> GetSamples() const;
+
+		/// <summary>Gets a single height sample widened (or dequantized) to double, independent of host endianness and alignment.</summary>
+		/// <param name="index">Row-major sample index (y * width + x).</param>
+		[[nodiscard]] double GetSample(size_t index) const;
+
+	private:
+		void Map();
+		void Unmap() noexcept;
+		void Validate(bool verifyPayloadCrc);
+
+		std::string m_filePath;
+
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+		void* m_mappingHandle = nullptr; // windows file mapping object
+
+		JTF_Head m_header;
+		const uint8_t* m_samples = nullptr;
+		size_t m_sampleBytes = 0;
+		size_t m_sampleCount = 0;
+	};
+}
\ No newline at end of file
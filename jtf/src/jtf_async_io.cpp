@@ -0,0 +1,373 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#include "jtf_async_io.h"
+#include "jtf_thread_pool.h"
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define JTF_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace cybex_interactive::jtf
+{
+	// reads are bound by the device rather than the core count
+	constexpr uint32_t ASYNC_IO_THREAD_COUNT = 4;
+
+	inline static std::string FileReadError(const std::string& filePath, const std::string& message)
+	{
+		return std::format("[JTF Read Error] '{}' {} File corrupted or not saved correctly.\n", filePath, message);
+	}
+
+	// blocking read of a whole file, run on the I/O pool
+	inline static std::vector<uint8_t> ReadWholeFile(const std::string& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		std::streamoff size = file.tellg();
+		std::vector<uint8_t> bytes(static_cast<size_t>(size));
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(bytes.data()), size))
+			throw std::runtime_error(FileReadError(filePath, "Unexpected EOF."));
+		return bytes;
+	}
+
+
+#if JTF_IO_URING
+	// submission slots, one read per file is in flight at a time
+	constexpr unsigned IO_URING_ENTRIES = 64;
+
+	// largest single read, longer files are read slice after slice
+	constexpr size_t IO_URING_READ_SLICE_SIZE = size_t(64) << 20;
+
+	/// <summary>
+	/// Minimal io_uring instance on the raw system calls: submissions are serialized by a mutex, one thread reaps the completions
+	/// and resubmits short reads. Requests beyond the submission slots wait in a backlog.
+	/// </summary>
+	class IoUring final
+	{
+	public:
+		/// <summary>Set up a ring, null if the kernel lacks io_uring (before 5.7) or a sandbox policy denies it.</summary>
+		static std::unique_ptr<IoUring> TryCreate();
+
+		~IoUring();
+
+		IoUring(const IoUring&) = delete;
+		IoUring& operator=(const IoUring&) = delete;
+
+		void Read(const std::string& filePath, AsyncFileReader::Completion onComplete);
+
+	private:
+		struct Request
+		{
+			int Fd = -1;
+			std::string FilePath;
+			std::vector<uint8_t> Bytes;
+			size_t Done = 0;
+			AsyncFileReader::Completion OnComplete;
+		};
+
+		IoUring() = default;
+
+		void SubmitLocked(uint8_t opcode, Request* request);
+		void Reap();
+		void Finish(Request* request, std::exception_ptr error);
+
+		int m_fd = -1;
+		void* m_sqRing = MAP_FAILED;
+		void* m_cqRing = MAP_FAILED;
+		void* m_sqes = MAP_FAILED;
+		size_t m_sqRingSize = 0;
+		size_t m_cqRingSize = 0;
+		size_t m_sqesSize = 0;
+
+		unsigned* m_sqHead = nullptr;
+		unsigned* m_sqTail = nullptr;
+		unsigned* m_sqMask = nullptr;
+		unsigned* m_sqArray = nullptr;
+		io_uring_sqe* m_sqEntries = nullptr;
+		unsigned* m_cqHead = nullptr;
+		unsigned* m_cqTail = nullptr;
+		unsigned* m_cqMask = nullptr;
+		io_uring_cqe* m_cqEntries = nullptr;
+		unsigned m_entries = 0;
+
+		std::mutex m_mutex;
+		std::deque<Request*> m_backlog;	// requests waiting for a submission slot
+		unsigned m_inFlight = 0;		// submitted and not reaped
+		bool m_stopping = false;
+		std::thread m_reaper;
+	};
+
+	std::unique_ptr<IoUring> IoUring::TryCreate()
+	{
+		io_uring_params params{};
+		int fd = static_cast<int>(syscall(__NR_io_uring_setup, IO_URING_ENTRIES, &params));
+		if (fd < 0)
+			return nullptr;
+
+		std::unique_ptr<IoUring> ring(new IoUring());
+		ring->m_fd = fd;
+
+		// IORING_OP_READ arrived in 5.6, the fast poll feature of 5.7 is the first feature flag implying it
+		if (!(params.features & IORING_FEAT_FAST_POLL))
+			return nullptr;
+
+		ring->m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		ring->m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (singleMap)
+			ring->m_sqRingSize = ring->m_cqRingSize = std::max(ring->m_sqRingSize, ring->m_cqRingSize);
+
+		ring->m_sqRing = mmap(nullptr, ring->m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		if (ring->m_sqRing == MAP_FAILED)
+			return nullptr;
+		ring->m_cqRing = singleMap ? ring->m_sqRing : mmap(nullptr, ring->m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (ring->m_cqRing == MAP_FAILED)
+			return nullptr;
+		ring->m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		ring->m_sqes = mmap(nullptr, ring->m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+		if (ring->m_sqes == MAP_FAILED)
+			return nullptr;
+
+		uint8_t* sq = static_cast<uint8_t*>(ring->m_sqRing);
+		ring->m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+		ring->m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		ring->m_sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		ring->m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+		ring->m_sqEntries = static_cast<io_uring_sqe*>(ring->m_sqes);
+
+		uint8_t* cq = static_cast<uint8_t*>(ring->m_cqRing);
+		ring->m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		ring->m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		ring->m_cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		ring->m_cqEntries = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		ring->m_entries = params.sq_entries;
+
+		ring->m_reaper = std::thread([ring = ring.get()]() { ring->Reap(); });
+		return ring;
+	}
+
+	IoUring::~IoUring()
+	{
+		if (m_reaper.joinable())
+		{
+			// a no-op completion wakes the reaper, which leaves once everything in flight is reaped
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stopping = true;
+				SubmitLocked(IORING_OP_NOP, nullptr);
+			}
+			m_reaper.join();
+		}
+
+		if (m_sqes != MAP_FAILED) munmap(m_sqes, m_sqesSize);
+		if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+		if (m_sqRing != MAP_FAILED) munmap(m_sqRing, m_sqRingSize);
+		if (m_fd >= 0) close(m_fd);
+	}
+
+	void IoUring::Read(const std::string& filePath, AsyncFileReader::Completion onComplete)
+	{
+		int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			onComplete({}, std::make_exception_ptr(std::runtime_error(FileReadError(filePath, "Cannot open file for reading."))));
+			return;
+		}
+
+		struct stat status;
+		if (fstat(fd, &status) != 0)
+		{
+			close(fd);
+			onComplete({}, std::make_exception_ptr(std::runtime_error(FileReadError(filePath, "Cannot query file size."))));
+			return;
+		}
+
+		std::unique_ptr<Request> request(new Request{ fd, filePath, {}, 0, std::move(onComplete) });
+		request->Bytes.resize(static_cast<size_t>(status.st_size));
+		if (request->Bytes.empty())
+		{
+			Finish(request.release(), nullptr);
+			return;
+		}
+
+		// one slot stays free for the no-op waking the reaper on shutdown
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_inFlight + 1 >= m_entries)
+			m_backlog.push_back(request.release());
+		else
+			SubmitLocked(IORING_OP_READ, request.release());
+	}
+
+	void IoUring::SubmitLocked(uint8_t opcode, Request* request)
+	{
+		// the submission tail is only written here, under the mutex
+		unsigned tail = *m_sqTail;
+		unsigned index = tail & *m_sqMask;
+		io_uring_sqe& entry = m_sqEntries[index];
+		std::memset(&entry, 0, sizeof(entry));
+		entry.opcode = opcode;
+		entry.fd = -1;
+		entry.user_data = reinterpret_cast<uint64_t>(request);
+		if (request)
+		{
+			entry.fd = request->Fd;
+			entry.addr = reinterpret_cast<uint64_t>(request->Bytes.data() + request->Done);
+			entry.len = static_cast<uint32_t>(std::min(request->Bytes.size() - request->Done, IO_URING_READ_SLICE_SIZE));
+			entry.off = request->Done;
+		}
+		m_sqArray[index] = index;
+		std::atomic_ref<unsigned>(*m_sqTail).store(tail + 1, std::memory_order_release);
+		++m_inFlight;
+
+		// an entry not taken now stays queued, the reaper submits it with its next wait
+		while (syscall(__NR_io_uring_enter, m_fd, 1, 0, 0, nullptr, 0) < 0 && errno == EINTR) {}
+	}
+
+	void IoUring::Reap()
+	{
+		while (true)
+		{
+			unsigned head = *m_cqHead;
+			if (head == std::atomic_ref<unsigned>(*m_cqTail).load(std::memory_order_acquire))
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (m_stopping && m_inFlight == 0 && m_backlog.empty())
+						return;
+				}
+				unsigned pending = std::atomic_ref<unsigned>(*m_sqTail).load(std::memory_order_acquire) - std::atomic_ref<unsigned>(*m_sqHead).load(std::memory_order_acquire);
+				syscall(__NR_io_uring_enter, m_fd, pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+				continue;
+			}
+
+			io_uring_cqe completion = m_cqEntries[head & *m_cqMask];
+			std::atomic_ref<unsigned>(*m_cqHead).store(head + 1, std::memory_order_release);
+
+			Request* request = reinterpret_cast<Request*>(completion.user_data);
+			std::exception_ptr error;
+			if (request)
+			{
+				if (completion.res < 0)
+					error = std::make_exception_ptr(std::runtime_error(FileReadError(request->FilePath, std::format("Read failed ({}).", std::strerror(-completion.res)))));
+				else if (completion.res == 0)
+					error = std::make_exception_ptr(std::runtime_error(FileReadError(request->FilePath, "Unexpected EOF.")));
+				else
+					request->Done += static_cast<size_t>(completion.res);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				--m_inFlight;
+
+				// short read, continue where it stopped
+				if (request && !error && request->Done < request->Bytes.size())
+				{
+					SubmitLocked(IORING_OP_READ, request);
+					continue;
+				}
+
+				// the slot is free for a waiting request
+				if (!m_backlog.empty())
+				{
+					SubmitLocked(IORING_OP_READ, m_backlog.front());
+					m_backlog.pop_front();
+				}
+			}
+
+			if (request)
+				Finish(request, error);
+		}
+	}
+
+	void IoUring::Finish(Request* request, std::exception_ptr error)
+	{
+		std::unique_ptr<Request> owned(request);
+		close(owned->Fd);
+		if (error)
+			owned->Bytes.clear();
+		owned->OnComplete(std::move(owned->Bytes), error);
+	}
+#endif
+
+
+	struct AsyncFileReader::Backend
+	{
+		// declared first, so it is destroyed after the I/O backends have drained their completions into it
+		ThreadPool Workers{ 0 };
+#if JTF_IO_URING
+		std::unique_ptr<IoUring> Ring;	// null when the kernel refuses io_uring
+#endif
+		std::unique_ptr<ThreadPool> Pool;	// fallback
+	};
+
+	AsyncFileReader& AsyncFileReader::Get()
+	{
+		static AsyncFileReader reader;
+		return reader;
+	}
+
+	AsyncFileReader::AsyncFileReader() : m_backend(std::make_unique<Backend>())
+	{
+#if JTF_IO_URING
+		m_backend->Ring = IoUring::TryCreate();
+		if (m_backend->Ring)
+			return;
+#endif
+		m_backend->Pool = std::make_unique<ThreadPool>(ASYNC_IO_THREAD_COUNT);
+	}
+
+	AsyncFileReader::~AsyncFileReader() = default;
+
+	void AsyncFileReader::Read(const std::string& filePath, Completion onComplete)
+	{
+#if JTF_IO_URING
+		if (m_backend->Ring)
+		{
+			m_backend->Ring->Read(filePath, std::move(onComplete));
+			return;
+		}
+#endif
+		m_backend->Pool->Submit([filePath, onComplete = std::move(onComplete)]()
+			{
+				std::vector<uint8_t> bytes;
+				std::exception_ptr error;
+				try { bytes = ReadWholeFile(filePath); }
+				catch (...) { error = std::current_exception(); }
+				onComplete(std::move(bytes), error);
+			});
+	}
+
+	void AsyncFileReader::Submit(std::function<void()> task)
+	{
+		m_backend->Workers.Submit(std::move(task));
+	}
+
+	const char* AsyncFileReader::GetBackendName() const noexcept
+	{
+#if JTF_IO_URING
+		if (m_backend->Ring)
+			return "io_uring";
+#endif
+		return "thread pool";
+	}
+}
\ No newline at end of file
@@ -8,6 +8,12 @@
 #include <format>
 #include <cstring>
 #include <cstdio>
+#include <variant>
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <optional>
+#include <utility>
 
 struct JTF
 {
@@ -25,6 +31,12 @@ struct JTF
 
 	double* HeightSamples = nullptr;
 	uint32_t HeightSampleCount = 0;
+
+	// native precision samples (ReadNative), element type given by BitDepth: 8 = uint8_t, 16 = uint16_t (raw UNORM), 32 = float, 64 = double
+	void* NativeHeightSamples = nullptr;
+
+	// owns NativeHeightSamples, not part of the interop layout
+	cybex_interactive::jtf::JTF_NativeHeights NativeStorage;
 };
 
 static inline JTF_Log BuildLog(JTF_Result result, const char* message)
@@ -36,6 +48,80 @@ static inline JTF_Log BuildLog(JTF_Result result, const char* message)
 	return log;
 }
 
+// copy header and widened samples into a new interop handle
+static inline JTF* CreateHandle(const cybex_interactive::jtf::JTF& jtf)
+{
+	std::unique_ptr<JTF> data(new JTF());
+
+	data->VersionMajor = jtf.Header.VersionMajor;
+	data->VersionMinor = jtf.Header.VersionMinor;
+	data->VersionPatch = jtf.Header.VersionPatch;
+	data->Width = jtf.Header.Width;
+	data->Height = jtf.Header.Height;
+	data->BitDepth = jtf.Header.BitDepth;
+	data->BoundsLower = jtf.Header.BoundsLower;
+	data->BoundsUpper = jtf.Header.BoundsUpper;
+
+	uint32_t heightSampleCount = static_cast<uint32_t>(jtf.Heights.HeightSamples.size());
+	data->HeightSampleCount = heightSampleCount;
+
+	if (heightSampleCount > 0)
+	{
+		data->HeightSamples = new double[heightSampleCount];
+		memcpy(data->HeightSamples, jtf.Heights.HeightSamples.data(), heightSampleCount * sizeof(double));
+	}
+	else data->HeightSamples = nullptr;
+
+	return data.release();
+}
+
+static inline JTF_Info BuildInfo(const cybex_interactive::jtf::JTF_Head& header)
+{
+	JTF_Info info{};
+	info.VersionMajor = header.VersionMajor;
+	info.VersionMinor = header.VersionMinor;
+	info.VersionPatch = header.VersionPatch;
+	info.BitDepth = header.BitDepth;
+	info.Layout = static_cast<uint8_t>(header.Layout);
+	info.Compression = static_cast<uint8_t>(header.Compression);
+	info.Width = header.Width;
+	info.Height = header.Height;
+	info.BoundsLower = header.BoundsLower;
+	info.BoundsUpper = header.BoundsUpper;
+	info.SampleCount = uint64_t(header.Width) * header.Height;
+	return info;
+}
+
+// decode into the caller buffer, shared by ReadIntoFloat and ReadIntoDouble
+template<typename T> static inline JTF_Log ReadIntoBuffer(const char* filePath, T* out_samples, uint64_t sampleCapacity, JTF_Info* out_info, std::optional<std::pair<double, double>> scaleOffset = std::nullopt)
+{
+	if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file path. File could not be read.\n");
+	if (!out_samples) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing sample buffer. File could not be read.\n");
+
+	try
+	{
+		std::span<T> destination(out_samples, static_cast<size_t>(std::min<uint64_t>(sampleCapacity, SIZE_MAX)));
+		cybex_interactive::jtf::JTF_Head header = scaleOffset
+			? cybex_interactive::jtf::JTFFile::ReadElevationsInto(filePath, destination, scaleOffset->first, scaleOffset->second)
+			: cybex_interactive::jtf::JTFFile::ReadInto(filePath, destination);
+		if (out_info) *out_info = BuildInfo(header);
+
+		return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF successfully from '{}'.", filePath).c_str());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		return BuildLog(JTF_INVALID_ARGUMENT, e.what());
+	}
+	catch (const std::exception& e)
+	{
+		return BuildLog(JTF_EXCEPTION, e.what());
+	}
+	catch (...)
+	{
+		return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during read. File could not be read.");
+	}
+}
+
 extern "C"
 {
 	JTF_API JTF* Create(void)
@@ -72,6 +158,84 @@ extern "C"
 		}
 	}
 
+	JTF_API JTF_Log WriteElevations(const char* filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const double* elevations, uint64_t sampleCount)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Missing file path. File could not be generated.\n");
+		if (!elevations) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Missing elevations. File could not be generated.\n");
+		if (sampleCount == 0) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Invalid height sample count [0]. File could not be generated.\n");
+
+		try
+		{
+			std::vector<double> map(elevations, elevations + sampleCount);
+			cybex_interactive::jtf::JTFFile::WriteElevations(std::string(filePath), width, height, boundsLower, boundsUpper, map);
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Write] Wrote JTF successfully to '{}'.", filePath).c_str());
+		}
+		catch (const std::invalid_argument& e)
+		{
+			return BuildLog(JTF_INVALID_ARGUMENT, e.what());
+		}
+		catch (const std::runtime_error& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Write Error] Unknown native exception during write. File could not be generated.");
+		}
+	}
+
+	JTF_API JTF_Log WriteElevationsAutoBounds(const char* filePath, uint16_t width, uint16_t height, const double* elevations, uint64_t sampleCount)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Missing file path. File could not be generated.\n");
+		if (!elevations) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Missing elevations. File could not be generated.\n");
+		if (sampleCount == 0) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Invalid height sample count [0]. File could not be generated.\n");
+
+		try
+		{
+			std::vector<double> map(elevations, elevations + sampleCount);
+			cybex_interactive::jtf::JTFFile::WriteElevations(std::string(filePath), width, height, map);
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Write] Wrote JTF successfully to '{}'.", filePath).c_str());
+		}
+		catch (const std::invalid_argument& e)
+		{
+			return BuildLog(JTF_INVALID_ARGUMENT, e.what());
+		}
+		catch (const std::runtime_error& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Write Error] Unknown native exception during write. File could not be generated.");
+		}
+	}
+
+	JTF_API JTF_Log WriteWithStats(const char* filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const double* heightSamples, uint64_t heightSampleCount, JTF_Stats* out_stats)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Missing file path. File could not be generated.\n");
+		if (!heightSamples) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Missing height samples. File could not be generated.\n");
+		if (heightSampleCount == 0) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Invalid height sample count [0]. File could not be generated.\n");
+		if (!out_stats) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Write Error] Missing stats out parameter. File could not be generated.\n");
+
+		*out_stats = JTF_Stats{};
+		try
+		{
+			std::vector<double> map(heightSamples, heightSamples + heightSampleCount);
+			cybex_interactive::jtf::JTF_WriteOptions options;
+			options.Stats = out_stats;
+			cybex_interactive::jtf::JTFFile::Write(std::string(filePath), width, height, boundsLower, boundsUpper, map, options);
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Write] Wrote JTF successfully to '{}'.", filePath).c_str());
+		}
+		catch (const std::runtime_error& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Write Error] Unknown native exception during write. File could not be generated.");
+		}
+	}
+
 	JTF_API JTF_Log Read(const char* filePath, JTF** out_data)
 	{
 		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file path. File could not be read.\n");
@@ -79,31 +243,35 @@ extern "C"
 
 		try
 		{
-			std::unique_ptr<JTF> data(new JTF());
-
 			cybex_interactive::jtf::JTF jtf = cybex_interactive::jtf::JTFFile::Read(filePath);
+			*out_data = CreateHandle(jtf);
+			
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF successfully from '{}'.", filePath).c_str());
+		}
+		catch (const std::exception& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during read. File could not be read.");
+		}
+	}
 
-			data->VersionMajor = jtf.Header.VersionMajor;
-			data->VersionMinor = jtf.Header.VersionMinor;
-			data->VersionPatch = jtf.Header.VersionPatch;
-			data->Width = jtf.Header.Width;
-			data->Height = jtf.Header.Height;
-			data->BitDepth = jtf.Header.BitDepth;
-			data->BoundsLower = jtf.Header.BoundsLower;
-			data->BoundsUpper = jtf.Header.BoundsUpper;
-
-			uint32_t heightSampleCount = static_cast<uint32_t>(jtf.Heights.HeightSamples.size());
-			data->HeightSampleCount = heightSampleCount;
+	JTF_API JTF_Log ReadWithStats(const char* filePath, JTF** out_data, JTF_Stats* out_stats)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file path. File could not be read.\n");
+		if (!out_data) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing out parameter. File could not be read.\n");
+		if (!out_stats) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing stats out parameter. File could not be read.\n");
 
-			if (heightSampleCount > 0)
-			{
-				data->HeightSamples = new double[heightSampleCount];
-				memcpy(data->HeightSamples, jtf.Heights.HeightSamples.data(), heightSampleCount * sizeof(double));
-			}
-			else data->HeightSamples = nullptr;
+		*out_stats = JTF_Stats{};
+		try
+		{
+			cybex_interactive::jtf::JTF_ReadOptions options;
+			options.Stats = out_stats;
+			cybex_interactive::jtf::JTF jtf = cybex_interactive::jtf::JTFFile::Read(filePath, options);
+			*out_data = CreateHandle(jtf);
 
-			*out_data = data.release();
-			
 			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF successfully from '{}'.", filePath).c_str());
 		}
 		catch (const std::exception& e)
@@ -123,14 +291,126 @@ extern "C"
 
 		try
 		{
-			std::unique_ptr<JTF> data(new JTF());
-
 			std::vector<std::string> chunks;
 			chunks.reserve(requestedChunks.count);
 			for (uint32_t i = 0; i < requestedChunks.count; ++i)
 				chunks.emplace_back(requestedChunks.items[i]);
 
 			cybex_interactive::jtf::JTF jtf = cybex_interactive::jtf::JTFFile::Read(filePath, chunks, verifyFileCrc);
+			*out_data = CreateHandle(jtf);
+
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF successfully from '{}'.", filePath).c_str());
+		}
+		catch (const std::exception& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during read. File could not be read.");
+		}
+	}
+
+	JTF_API JTF_Log ReadBatch(const char** filePaths, uint32_t fileCount, uint32_t threadCount, JTF** out_data, JTF_Log* out_logs)
+	{
+		if (!filePaths && fileCount > 0) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file paths. Files could not be read.\n");
+		if (!out_data && fileCount > 0) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing out parameter. Files could not be read.\n");
+		for (uint32_t i = 0; i < fileCount; ++i)
+			if (!filePaths[i]) return BuildLog(JTF_INVALID_ARGUMENT, std::format("[JTF Read Error] Missing file path [{}]. Files could not be read.\n", i).c_str());
+
+		std::fill(out_data, out_data + fileCount, nullptr);
+
+		try
+		{
+			std::vector<std::string> paths(filePaths, filePaths + fileCount);
+
+			cybex_interactive::jtf::JTF_ReadOptions options;
+			options.ThreadCount = threadCount;
+			std::vector<cybex_interactive::jtf::JTF_BatchResult> results = cybex_interactive::jtf::JTFFile::ReadBatch(paths, options);
+
+			uint32_t failed = 0;
+			for (uint32_t i = 0; i < fileCount; ++i)
+			{
+				JTF_Log log;
+				if (results[i].Error.empty())
+				{
+					out_data[i] = CreateHandle(results[i].Data);
+					log = BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF successfully from '{}'.", paths[i]).c_str());
+				}
+				else
+				{
+					++failed;
+					log = BuildLog(JTF_EXCEPTION, results[i].Error.c_str());
+				}
+				if (out_logs) out_logs[i] = log;
+			}
+
+			if (failed > 0)
+				return BuildLog(JTF_EXCEPTION, std::format("[JTF Read Error] [{}] of [{}] files could not be read.\n", failed, fileCount).c_str());
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read [{}] JTF files successfully.", fileCount).c_str());
+		}
+		catch (const std::exception& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during batch read. Files could not be read.");
+		}
+	}
+
+	JTF_API JTF_Log ReadAsync(const char* filePath, JTF_ReadCallback callback, void* userData)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file path. File could not be read.\n");
+		if (!callback) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing callback. File could not be read.\n");
+
+		try
+		{
+			std::string path(filePath);
+			cybex_interactive::jtf::JTFFile::ReadAsync(path, [path, callback, userData](cybex_interactive::jtf::JTF&& jtf, std::exception_ptr error)
+				{
+					JTF* data = nullptr;
+					JTF_Log log;
+					try
+					{
+						if (error)
+							std::rethrow_exception(error);
+						data = CreateHandle(jtf);
+						log = BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF successfully from '{}'.", path).c_str());
+					}
+					catch (const std::exception& e)
+					{
+						log = BuildLog(JTF_EXCEPTION, e.what());
+					}
+					catch (...)
+					{
+						log = BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during read. File could not be read.");
+					}
+					callback(userData, log, data);
+				});
+
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Queued reading JTF from '{}'.", filePath).c_str());
+		}
+		catch (const std::exception& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during read. File could not be queued.");
+		}
+	}
+
+	JTF_API JTF_Log ReadNative(const char* filePath, JTF** out_data)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file path. File could not be read.\n");
+		if (!out_data) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing out parameter. File could not be read.\n");
+
+		try
+		{
+			std::unique_ptr<JTF> data(new JTF());
+
+			cybex_interactive::jtf::JTF_Native jtf = cybex_interactive::jtf::JTFFile::ReadNative(filePath);
 
 			data->VersionMajor = jtf.Header.VersionMajor;
 			data->VersionMinor = jtf.Header.VersionMinor;
@@ -141,15 +421,16 @@ extern "C"
 			data->BoundsLower = jtf.Header.BoundsLower;
 			data->BoundsUpper = jtf.Header.BoundsUpper;
 
-			uint32_t heightSampleCount = static_cast<uint32_t>(jtf.Heights.HeightSamples.size());
-			data->HeightSampleCount = heightSampleCount;
-
-			if (heightSampleCount > 0)
-			{
-				data->HeightSamples = new double[heightSampleCount];
-				memcpy(data->HeightSamples, jtf.Heights.HeightSamples.data(), heightSampleCount * sizeof(double));
-			}
-			else data->HeightSamples = nullptr;
+			// take ownership of the samples, no further copy
+			data->NativeStorage = std::move(jtf.Heights);
+			std::visit([&data](auto& samples)
+				{
+					if constexpr (!std::is_same_v<std::decay_t<decltype(samples)>, std::monostate>)
+					{
+						data->HeightSampleCount = static_cast<uint32_t>(samples.size());
+						data->NativeHeightSamples = samples.empty() ? nullptr : samples.data();
+					}
+				}, data->NativeStorage.HeightSamples);
 
 			*out_data = data.release();
 
@@ -165,6 +446,119 @@ extern "C"
 		}
 	}
 
+	JTF_API JTF_Log ReadLod(const char* filePath, uint8_t level, JTF** out_data)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file path. File could not be read.\n");
+		if (!out_data) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing out parameter. File could not be read.\n");
+
+		try
+		{
+			cybex_interactive::jtf::JTF_Lod lod = cybex_interactive::jtf::JTFFile::ReadLod(filePath, level);
+
+			// the handle describes the level
+			cybex_interactive::jtf::JTF jtf;
+			jtf.Header = lod.Header;
+			jtf.Header.Width = lod.Width;
+			jtf.Header.Height = lod.Height;
+			jtf.Heights = std::move(lod.Heights);
+			*out_data = CreateHandle(jtf);
+
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF level [{}] successfully from '{}'.", level, filePath).c_str());
+		}
+		catch (const std::out_of_range& e)
+		{
+			return BuildLog(JTF_INVALID_ARGUMENT, e.what());
+		}
+		catch (const std::exception& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during read. File could not be read.");
+		}
+	}
+
+	JTF_API JTF_Log ReadInfo(const char* filePath, JTF_Info* out_info)
+	{
+		if (!filePath) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file path. File could not be read.\n");
+		if (!out_info) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing out parameter. File could not be read.\n");
+
+		try
+		{
+			*out_info = BuildInfo(cybex_interactive::jtf::JTFFile::ReadHeader(filePath));
+
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF header successfully from '{}'.", filePath).c_str());
+		}
+		catch (const std::exception& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during read. File could not be read.");
+		}
+	}
+
+	JTF_API JTF_Log ScanHeaders(const char** filePaths, uint32_t fileCount, uint32_t threadCount, JTF_Info* out_infos, JTF_Log* out_logs)
+	{
+		if (!filePaths && fileCount > 0) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing file paths. Files could not be read.\n");
+		if (!out_infos && fileCount > 0) return BuildLog(JTF_INVALID_ARGUMENT, "[JTF Read Error] Missing out parameter. Files could not be read.\n");
+		for (uint32_t i = 0; i < fileCount; ++i)
+			if (!filePaths[i]) return BuildLog(JTF_INVALID_ARGUMENT, std::format("[JTF Read Error] Missing file path [{}]. Files could not be read.\n", i).c_str());
+
+		try
+		{
+			std::vector<std::string> paths(filePaths, filePaths + fileCount);
+
+			cybex_interactive::jtf::JTF_ReadOptions options;
+			options.ThreadCount = threadCount;
+			cybex_interactive::jtf::JTF_HeaderScan scan = cybex_interactive::jtf::JTFFile::ScanHeaders(paths, options);
+
+			for (uint32_t i = 0; i < fileCount; ++i)
+			{
+				bool success = scan.Errors[i].empty();
+				out_infos[i] = success ? BuildInfo(scan.Headers[i]) : JTF_Info{};
+				if (out_logs)
+					out_logs[i] = success
+						? BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read JTF header successfully from '{}'.", paths[i]).c_str())
+						: BuildLog(JTF_EXCEPTION, scan.Errors[i].c_str());
+			}
+
+			if (scan.FailedCount > 0)
+				return BuildLog(JTF_EXCEPTION, std::format("[JTF Read Error] [{}] of [{}] file headers could not be read.\n", scan.FailedCount, fileCount).c_str());
+			return BuildLog(JTF_SUCCESS, std::format("[JTF Read] Read [{}] JTF headers successfully.", fileCount).c_str());
+		}
+		catch (const std::exception& e)
+		{
+			return BuildLog(JTF_EXCEPTION, e.what());
+		}
+		catch (...)
+		{
+			return BuildLog(JTF_EXCEPTION, "[JTF Read Error] Unknown native exception during header scan. Files could not be read.");
+		}
+	}
+
+	JTF_API JTF_Log ReadIntoFloat(const char* filePath, float* out_samples, uint64_t sampleCapacity, JTF_Info* out_info)
+	{
+		return ReadIntoBuffer(filePath, out_samples, sampleCapacity, out_info);
+	}
+
+	JTF_API JTF_Log ReadIntoDouble(const char* filePath, double* out_samples, uint64_t sampleCapacity, JTF_Info* out_info)
+	{
+		return ReadIntoBuffer(filePath, out_samples, sampleCapacity, out_info);
+	}
+
+	JTF_API JTF_Log ReadElevationsIntoFloat(const char* filePath, float* out_elevations, uint64_t sampleCapacity, double scale, double offset, JTF_Info* out_info)
+	{
+		return ReadIntoBuffer(filePath, out_elevations, sampleCapacity, out_info, std::make_pair(scale, offset));
+	}
+
+	JTF_API JTF_Log ReadElevationsIntoDouble(const char* filePath, double* out_elevations, uint64_t sampleCapacity, double scale, double offset, JTF_Info* out_info)
+	{
+		return ReadIntoBuffer(filePath, out_elevations, sampleCapacity, out_info, std::make_pair(scale, offset));
+	}
+
 	JTF_API const char* GetVersion(void)
 	{
 		static thread_local std::string buffer = std::format("v{}.{}.{}", JTF_VERSION_MAJOR, JTF_VERSION_MINOR, JTF_VERSION_PATCH);
@@ -0,0 +1,499 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#include "jtf_codec.h"
+#include "jtf_utility.h"
+#include "jtf_parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+namespace cybex_interactive::jtf
+{
+	// 'HCMP' payload:
+	// [0..2) rows per band (UInt16), [2..4) band count (UInt16), [4..8) reserved
+	// band table: encoded size per band (UInt32)
+	// bands: per byte plane, least significant first: mode (byte), size (UInt32), data
+	constexpr size_t HCMP_HEADER_SIZE = 8;
+	constexpr size_t HCMP_BAND_TARGET_SIZE = 256 * 1024; // raw bytes per band, keeps band scratch in L2
+
+	constexpr uint8_t PLANE_STORED = 0;
+	constexpr uint8_t PLANE_LZ = 1;
+
+	// LZ77 byte-oriented sequences: token (4 bit literal length, 4 bit match length - 4), length extensions, literals, UInt16 offset
+	constexpr size_t LZ_MIN_MATCH = 4;
+	constexpr size_t LZ_LAST_LITERALS = 5;	// sequences end on literals
+	constexpr size_t LZ_MATCH_LIMIT = 12;	// no match starts within the last bytes
+	constexpr size_t LZ_MAX_OFFSET = 65535;
+	constexpr uint32_t LZ_HASH_BITS = 14;
+	constexpr size_t LZ_SHORT_COPY = 16;	// short literal runs and matches are copied with one fixed size copy
+
+
+	inline static uint32_t LzHash(const uint8_t* pointer)
+	{
+		uint32_t value;
+		std::memcpy(&value, pointer, 4);
+		return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+	}
+
+	inline static void LzWriteLength(std::vector<uint8_t>& out, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			out.push_back(255);
+		out.push_back(static_cast<uint8_t>(length));
+	}
+
+	inline static bool LzReadLength(const uint8_t*& in, const uint8_t* inEnd, size_t& length)
+	{
+		uint8_t byte;
+		do
+		{
+			if (in == inEnd)
+				return false;
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	inline static void LzEmit(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount, size_t offset, size_t matchLength)
+	{
+		size_t matchCode = matchLength - LZ_MIN_MATCH;
+		out.push_back(static_cast<uint8_t>((std::min<size_t>(literalCount, 15) << 4) | (matchLength ? std::min<size_t>(matchCode, 15) : 0)));
+		if (literalCount >= 15)
+			LzWriteLength(out, literalCount - 15);
+		out.insert(out.end(), literals, literals + literalCount);
+		if (!matchLength)
+			return;
+
+		out.push_back(static_cast<uint8_t>(offset));
+		out.push_back(static_cast<uint8_t>(offset >> 8));
+		if (matchCode >= 15)
+			LzWriteLength(out, matchCode - 15);
+	}
+
+	/// <summary>Append LZ coded `source` to `out`. Greedy single-probe hash matching, skipping ahead faster on incompressible input.</summary>
+	inline static void LzCompress(const uint8_t* source, size_t size, std::vector<uint8_t>& out, std::vector<uint32_t>& table)
+	{
+		table.assign(size_t(1) << LZ_HASH_BITS, UINT32_MAX);
+
+		size_t anchor = 0;
+		size_t position = 0;
+		if (size > LZ_MATCH_LIMIT)
+		{
+			size_t searchEnd = size - LZ_MATCH_LIMIT;
+			size_t matchEnd = size - LZ_LAST_LITERALS;
+			while (position < searchEnd)
+			{
+				uint32_t& slot = table[LzHash(source + position)];
+				size_t candidate = slot;
+				slot = static_cast<uint32_t>(position);
+
+				if (candidate != UINT32_MAX && position - candidate <= LZ_MAX_OFFSET && std::memcmp(source + candidate, source + position, LZ_MIN_MATCH) == 0)
+				{
+					size_t length = LZ_MIN_MATCH;
+					while (position + length < matchEnd && source[candidate + length] == source[position + length])
+						++length;
+
+					LzEmit(out, source + anchor, position - anchor, position - candidate, length);
+					position += length;
+					anchor = position;
+				}
+				else position += 1 + ((position - anchor) >> 6);
+			}
+		}
+
+		// last literals
+		LzEmit(out, source + anchor, size - anchor, 0, 0);
+	}
+
+	inline static bool LzDecompress(const uint8_t* in, size_t inSize, uint8_t* out, size_t outSize)
+	{
+		const uint8_t* inEnd = in + inSize;
+		uint8_t* outBegin = out;
+		uint8_t* outEnd = out + outSize;
+
+		while (in < inEnd)
+		{
+			uint8_t token = *in++;
+
+			// literals
+			size_t literalCount = token >> 4;
+			if (literalCount == 15 && !LzReadLength(in, inEnd, literalCount))
+				return false;
+			if (literalCount > size_t(inEnd - in) || literalCount > size_t(outEnd - out))
+				return false;
+			if (literalCount <= LZ_SHORT_COPY && inEnd - in >= ptrdiff_t(LZ_SHORT_COPY) && outEnd - out >= ptrdiff_t(LZ_SHORT_COPY))
+				std::memcpy(out, in, LZ_SHORT_COPY); // fixed size copy, the excess is overwritten by the following sequences
+			else
+				std::memcpy(out, in, literalCount);
+			in += literalCount;
+			out += literalCount;
+
+			// last sequence holds literals only
+			if (in == inEnd)
+				return out == outEnd;
+
+			// match
+			if (inEnd - in < 2)
+				return false;
+			size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+			in += 2;
+			size_t matchLength = token & 15;
+			if (matchLength == 15 && !LzReadLength(in, inEnd, matchLength))
+				return false;
+			matchLength += LZ_MIN_MATCH;
+			if (offset == 0 || offset > size_t(out - outBegin) || matchLength > size_t(outEnd - out))
+				return false;
+
+			const uint8_t* match = out - offset;
+			if (matchLength <= LZ_SHORT_COPY && offset >= LZ_SHORT_COPY && outEnd - out >= ptrdiff_t(LZ_SHORT_COPY))
+			{
+				std::memcpy(out, match, LZ_SHORT_COPY);
+				out += matchLength;
+				continue;
+			}
+
+			// overlapping matches repeat with period offset, copy in non-overlapping steps of doubling distance
+			uint8_t* matchEnd = out + matchLength;
+			for (size_t distance = offset; out < matchEnd; distance *= 2)
+			{
+				size_t step = std::min<size_t>(distance, size_t(matchEnd - out));
+				std::memcpy(out, match, step);
+				out += step;
+			}
+		}
+		return false;
+	}
+
+
+	template<typename Raw> inline static Raw ZigZag(Raw value)
+	{
+		using Signed = std::make_signed_t<Raw>;
+		return static_cast<Raw>(value << 1) ^ static_cast<Raw>(static_cast<Signed>(value) >> (sizeof(Raw) * 8 - 1));
+	}
+
+	template<typename Raw> inline static Raw UnZigZag(Raw value)
+	{
+		return static_cast<Raw>(value >> 1) ^ static_cast<Raw>(Raw(0) - (value & 1));
+	}
+
+	/// <summary>Gradient prediction residuals of a band, shuffled into byte planes (plane k holds byte k of every residual).</summary>
+	template<typename Raw> inline static void PredictBand(const Raw* bits, uint32_t width, uint32_t rows, uint8_t* planes)
+	{
+		size_t count = size_t(width) * rows;
+		for (uint32_t row = 0; row < rows; ++row)
+		{
+			const Raw* line = bits + size_t(row) * width;
+			const Raw* up = line - width;
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				Raw prediction;
+				if (row == 0)
+					prediction = x == 0 ? Raw(0) : line[x - 1];
+				else
+					prediction = x == 0 ? up[0] : static_cast<Raw>(line[x - 1] + up[x] - up[x - 1]);
+
+				Raw residual = ZigZag(static_cast<Raw>(line[x] - prediction));
+				size_t i = size_t(row) * width + x;
+				for (size_t k = 0; k < sizeof(Raw); ++k)
+					planes[k * count + i] = static_cast<uint8_t>(residual >> (8 * k));
+			}
+		}
+	}
+
+	/// <summary>Gather one row of residuals from the byte planes. Plane pointers are held in locals so the loop vectorizes.</summary>
+	template<typename Raw> inline static void GatherPlanes(const uint8_t* const* planes, size_t offset, uint32_t width, Raw* line)
+	{
+		const uint8_t* p0 = planes[0] + offset;
+		if constexpr (sizeof(Raw) == 1)
+		{
+			std::memcpy(line, p0, width);
+		}
+		else if constexpr (sizeof(Raw) == 2)
+		{
+			const uint8_t* p1 = planes[1] + offset;
+			for (uint32_t x = 0; x < width; ++x)
+				line[x] = static_cast<Raw>(p0[x] | (p1[x] << 8));
+		}
+		else if constexpr (sizeof(Raw) == 4)
+		{
+			const uint8_t* p1 = planes[1] + offset;
+			const uint8_t* p2 = planes[2] + offset;
+			const uint8_t* p3 = planes[3] + offset;
+			for (uint32_t x = 0; x < width; ++x)
+				line[x] = Raw(p0[x]) | (Raw(p1[x]) << 8) | (Raw(p2[x]) << 16) | (Raw(p3[x]) << 24);
+		}
+		else
+		{
+			const uint8_t* p1 = planes[1] + offset;
+			const uint8_t* p2 = planes[2] + offset;
+			const uint8_t* p3 = planes[3] + offset;
+			const uint8_t* p4 = planes[4] + offset;
+			const uint8_t* p5 = planes[5] + offset;
+			const uint8_t* p6 = planes[6] + offset;
+			const uint8_t* p7 = planes[7] + offset;
+			for (uint32_t x = 0; x < width; ++x)
+				line[x] = Raw(p0[x]) | (Raw(p1[x]) << 8) | (Raw(p2[x]) << 16) | (Raw(p3[x]) << 24)
+					| (Raw(p4[x]) << 32) | (Raw(p5[x]) << 40) | (Raw(p6[x]) << 48) | (Raw(p7[x]) << 56);
+		}
+	}
+
+	/// <summary>Inverse of PredictBand: gather residuals from the byte planes, then undo the prediction, row by row.</summary>
+	template<typename Raw> inline static void ReconstructBand(const uint8_t* const* planes, uint32_t width, uint32_t rows, Raw* bits)
+	{
+		for (uint32_t row = 0; row < rows; ++row)
+		{
+			size_t rowStart = size_t(row) * width;
+			Raw* line = bits + rowStart;
+
+			GatherPlanes(planes, rowStart, width, line);
+
+			// vertical part of the prediction, independent per sample, the first row predicts from the left only
+			if (row == 0)
+			{
+				for (uint32_t x = 0; x < width; ++x)
+					line[x] = UnZigZag(line[x]);
+			}
+			else
+			{
+				const Raw* up = line - width;
+				line[0] = static_cast<Raw>(UnZigZag(line[0]) + up[0]);
+				for (uint32_t x = 1; x < width; ++x)
+					line[x] = static_cast<Raw>(UnZigZag(line[x]) + up[x] - up[x - 1]);
+			}
+
+			// horizontal part, a running sum over the row
+			Raw previous = line[0];
+			for (uint32_t x = 1; x < width; ++x)
+				line[x] = previous = static_cast<Raw>(previous + line[x]);
+		}
+	}
+
+
+	/// <summary>Predict, plane shuffle and LZ code one band, appending it to coded.</summary>
+	template<typename Raw> inline static void EncodeBand(const void* source, uint32_t width, uint32_t rows, Raw* bits, uint8_t* planes, std::vector<uint8_t>& coded, std::vector<uint32_t>& table)
+	{
+		size_t count = size_t(rows) * width;
+		std::memcpy(bits, source, count * sizeof(Raw));
+		PredictBand(bits, width, rows, planes);
+
+		for (size_t k = 0; k < sizeof(Raw); ++k)
+		{
+			const uint8_t* plane = planes + k * count;
+			size_t planeHeader = coded.size();
+			coded.resize(planeHeader + 5);
+
+			LzCompress(plane, count, coded, table);
+			size_t codedSize = coded.size() - planeHeader - 5;
+			uint8_t mode = PLANE_LZ;
+			if (codedSize >= count)
+			{
+				coded.resize(planeHeader + 5);
+				coded.insert(coded.end(), plane, plane + count);
+				codedSize = count;
+				mode = PLANE_STORED;
+			}
+
+			coded[planeHeader] = mode;
+			StoreUInt32_LittleEndian(coded.data() + planeHeader + 1, static_cast<uint32_t>(codedSize));
+		}
+	}
+
+	template<typename T> std::vector<uint8_t> HeightCodec::Encode(const T* samples, uint16_t width, uint16_t height, uint32_t threadCount)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint8_t>, "HeightCodec encodes only float, double, uint16_t or uint8_t samples.");
+		using Raw = UIntOfSize<sizeof(T)>;
+
+		uint32_t rowsPerBand = static_cast<uint32_t>(std::clamp<size_t>(HCMP_BAND_TARGET_SIZE / (size_t(width) * sizeof(T)), 1, height));
+		uint32_t bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+
+		// bands are independent, each worker codes a contiguous run of bands into its own buffer
+		uint32_t workerCount = ResolveThreadCount(threadCount, bandCount, 1);
+		uint32_t bandsPerWorker = (bandCount + workerCount - 1) / workerCount;
+		std::vector<std::vector<uint8_t>> coded(workerCount);
+		std::vector<uint32_t> bandSizes(bandCount);
+		ParallelFor(workerCount, [&](uint32_t worker)
+			{
+				std::vector<Raw> bits(size_t(rowsPerBand) * width);
+				std::vector<uint8_t> planes(bits.size() * sizeof(Raw));
+				std::vector<uint32_t> table;
+
+				uint32_t bandEnd = std::min(bandCount, (worker + 1) * bandsPerWorker);
+				for (uint32_t band = worker * bandsPerWorker; band < bandEnd; ++band)
+				{
+					uint32_t firstRow = band * rowsPerBand;
+					uint32_t rows = std::min<uint32_t>(rowsPerBand, height - firstRow);
+					size_t bandStart = coded[worker].size();
+					EncodeBand(samples + size_t(firstRow) * width, width, rows, bits.data(), planes.data(), coded[worker], table);
+					bandSizes[band] = static_cast<uint32_t>(coded[worker].size() - bandStart);
+				}
+			});
+
+		size_t payloadSize = HCMP_HEADER_SIZE + size_t(bandCount) * 4;
+		for (const std::vector<uint8_t>& bands : coded)
+			payloadSize += bands.size();
+
+		std::vector<uint8_t> payload(HCMP_HEADER_SIZE + size_t(bandCount) * 4, 0);
+		payload.reserve(payloadSize);
+		StoreUInt16_LittleEndian(payload.data(), static_cast<uint16_t>(rowsPerBand));
+		StoreUInt16_LittleEndian(payload.data() + 2, static_cast<uint16_t>(bandCount));
+		for (uint32_t band = 0; band < bandCount; ++band)
+			StoreUInt32_LittleEndian(payload.data() + HCMP_HEADER_SIZE + size_t(band) * 4, bandSizes[band]);
+		for (const std::vector<uint8_t>& bands : coded)
+			payload.insert(payload.end(), bands.begin(), bands.end());
+
+		return payload;
+	}
+
+	/// <summary>Decode the byte planes of one band and undo the prediction into destination.</summary>
+	template<typename Raw, typename T> inline static bool DecodeBand(const uint8_t* band, const uint8_t* bandEnd, uint32_t width, uint32_t rows, Raw* bits, uint8_t* scratch, T* destination)
+	{
+		// type of the coded samples, unsigned normalized integers for 8 and 16 bit
+		using Sample = std::conditional_t<sizeof(Raw) == 4, float, std::conditional_t<sizeof(Raw) == 8, double, Raw>>;
+
+		size_t count = size_t(rows) * width;
+
+		// stored planes are used in place, LZ planes are decoded into scratch
+		const uint8_t* planes[sizeof(Raw)];
+		const uint8_t* pointer = band;
+		for (size_t k = 0; k < sizeof(Raw); ++k)
+		{
+			if (bandEnd - pointer < 5)
+				return false;
+			uint8_t mode = pointer[0];
+			uint32_t size = ReadUInt32_LittleEndian(pointer + 1);
+			pointer += 5;
+			if (size > size_t(bandEnd - pointer))
+				return false;
+
+			if (mode == PLANE_STORED)
+			{
+				if (size != count)
+					return false;
+				planes[k] = pointer;
+			}
+			else if (mode == PLANE_LZ)
+			{
+				uint8_t* plane = scratch + k * count;
+				if (!LzDecompress(pointer, size, plane, count))
+					return false;
+				planes[k] = plane;
+			}
+			else return false;
+			pointer += size;
+		}
+		if (pointer != bandEnd)
+			return false;
+
+		ReconstructBand(planes, width, rows, bits);
+
+		if constexpr (std::is_same_v<T, Sample>)
+			std::memcpy(destination, bits, count * sizeof(T));
+		else if constexpr (std::is_same_v<Sample, Raw>)
+			DequantizeUnorm(bits, count, destination);
+		else
+			for (size_t i = 0; i < count; ++i)
+				destination[i] = static_cast<T>(std::bit_cast<Sample>(bits[i]));
+		return true;
+	}
+
+	template<typename Raw, typename T> inline static bool DecodeBands(const uint8_t* payload, size_t payloadSize, uint16_t width, uint16_t height, T* samples, uint32_t threadCount, std::vector<uint8_t>& scratch)
+	{
+		if (payloadSize < HCMP_HEADER_SIZE)
+			return false;
+		uint32_t rowsPerBand = ReadUInt16_LittleEndian(payload);
+		uint32_t bandCount = ReadUInt16_LittleEndian(payload + 2);
+		if (rowsPerBand == 0 || bandCount != (height + rowsPerBand - 1) / rowsPerBand)
+			return false;
+		if (payloadSize < HCMP_HEADER_SIZE + size_t(bandCount) * 4)
+			return false;
+
+		// scratch holds the band offsets, then per worker the band samples and the decoded byte planes
+		uint32_t workerCount = ResolveThreadCount(threadCount, bandCount, 1);
+		size_t bandSampleCount = size_t(rowsPerBand) * width;
+		size_t offsetsSize = (size_t(bandCount) + 1) * sizeof(size_t);
+		size_t workerSize = bandSampleCount * sizeof(Raw) * 2;
+		if (scratch.size() < offsetsSize + workerCount * workerSize)
+			ResizeTracked(scratch, offsetsSize + workerCount * workerSize);
+
+		// band offsets are validated up front, bands then decode independently
+		const uint8_t* bandTable = payload + HCMP_HEADER_SIZE;
+		size_t* bandOffsets = reinterpret_cast<size_t*>(scratch.data());
+		bandOffsets[0] = HCMP_HEADER_SIZE + size_t(bandCount) * 4;
+		for (uint32_t band = 0; band < bandCount; ++band)
+		{
+			uint32_t bandSize = ReadUInt32_LittleEndian(bandTable + size_t(band) * 4);
+			if (bandSize > payloadSize - bandOffsets[band])
+				return false;
+			bandOffsets[band + 1] = bandOffsets[band] + bandSize;
+		}
+		if (bandOffsets[bandCount] != payloadSize)
+			return false;
+
+		uint32_t bandsPerWorker = (bandCount + workerCount - 1) / workerCount;
+		std::atomic<bool> valid = true;
+		ParallelFor(workerCount, [&](uint32_t worker)
+			{
+				uint8_t* workerScratch = scratch.data() + offsetsSize + worker * workerSize;
+				Raw* bits = reinterpret_cast<Raw*>(workerScratch);
+				uint8_t* planes = workerScratch + bandSampleCount * sizeof(Raw);
+
+				uint32_t bandEnd = std::min(bandCount, (worker + 1) * bandsPerWorker);
+				for (uint32_t band = worker * bandsPerWorker; band < bandEnd && valid.load(std::memory_order_relaxed); ++band)
+				{
+					uint32_t firstRow = band * rowsPerBand;
+					uint32_t rows = std::min<uint32_t>(rowsPerBand, height - firstRow);
+					if (!DecodeBand(payload + bandOffsets[band], payload + bandOffsets[band + 1], width, rows, bits, planes, samples + size_t(firstRow) * width))
+						valid.store(false, std::memory_order_relaxed);
+				}
+			});
+
+		return valid.load();
+	}
+
+	template<typename T> bool HeightCodec::Decode(const uint8_t* payload, size_t payloadSize, uint16_t width, uint16_t height, uint8_t bitDepth, T* samples, uint32_t threadCount)
+	{
+		std::vector<uint8_t> scratch;
+		return Decode(payload, payloadSize, width, height, bitDepth, samples, threadCount, scratch);
+	}
+
+	template<typename T> bool HeightCodec::Decode(const uint8_t* payload, size_t payloadSize, uint16_t width, uint16_t height, uint8_t bitDepth, T* samples, uint32_t threadCount, std::vector<uint8_t>& scratch)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint8_t>, "HeightCodec decodes only into float, double, uint16_t or uint8_t samples.");
+
+		// integer destinations take raw samples of their own bit depth only, float destinations widen or narrow
+		constexpr bool isFloat = std::is_floating_point_v<T>;
+		if constexpr (isFloat || sizeof(T) == 1)
+			if (bitDepth == 8)
+				return DecodeBands<uint8_t>(payload, payloadSize, width, height, samples, threadCount, scratch);
+		if constexpr (isFloat || sizeof(T) == 2)
+			if (bitDepth == 16)
+				return DecodeBands<uint16_t>(payload, payloadSize, width, height, samples, threadCount, scratch);
+		if constexpr (isFloat)
+			if (bitDepth == 32)
+				return DecodeBands<uint32_t>(payload, payloadSize, width, height, samples, threadCount, scratch);
+		if constexpr (isFloat)
+			if (bitDepth == 64)
+				return DecodeBands<uint64_t>(payload, payloadSize, width, height, samples, threadCount, scratch);
+		return false;
+	}
+
+
+	// Explicit template instantiations
+	template std::vector<uint8_t> HeightCodec::Encode<float>(const float*, uint16_t, uint16_t, uint32_t);
+	template std::vector<uint8_t> HeightCodec::Encode<double>(const double*, uint16_t, uint16_t, uint32_t);
+	template std::vector<uint8_t> HeightCodec::Encode<uint16_t>(const uint16_t*, uint16_t, uint16_t, uint32_t);
+	template std::vector<uint8_t> HeightCodec::Encode<uint8_t>(const uint8_t*, uint16_t, uint16_t, uint32_t);
+	template bool HeightCodec::Decode<float>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, float*, uint32_t);
+	template bool HeightCodec::Decode<double>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, double*, uint32_t);
+	template bool HeightCodec::Decode<uint16_t>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, uint16_t*, uint32_t);
+	template bool HeightCodec::Decode<uint8_t>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, uint8_t*, uint32_t);
+	template bool HeightCodec::Decode<float>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, float*, uint32_t, std::vector<uint8_t>&);
+	template bool HeightCodec::Decode<double>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, double*, uint32_t, std::vector<uint8_t>&);
+	template bool HeightCodec::Decode<uint16_t>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, uint16_t*, uint32_t, std::vector<uint8_t>&);
+	template bool HeightCodec::Decode<uint8_t>(const uint8_t*, size_t, uint16_t, uint16_t, uint8_t, uint8_t*, uint32_t, std::vector<uint8_t>&);
+}
\ No newline at end of file
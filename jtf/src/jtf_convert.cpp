@@ -0,0 +1,797 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#include "jtf_convert.h"
+#include "jtf_utility.h"
+#include <bit>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+	#define JTF_CONVERT_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+	#define JTF_CONVERT_NEON
+	#include <arm_neon.h>
+#endif
+
+// per function instruction set targeting, the library itself is built for the baseline ISA
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define JTF_TARGET_SSE2
+	#define JTF_TARGET_AVX2
+	#define JTF_TARGET_AVX512
+#else
+	#define JTF_TARGET_SSE2 __attribute__((target("sse2")))
+	#define JTF_TARGET_AVX2 __attribute__((target("avx2")))
+	#define JTF_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+namespace cybex_interactive::jtf
+{
+	using WidenFunction = void(*)(const uint8_t* source, size_t count, double* destination);
+	using NarrowFunction = void(*)(const uint8_t* source, size_t count, float* destination);
+	using ByteSwapFunction = void(*)(const uint8_t* source, size_t count, uint8_t* destination);
+	template<typename T> using AffineFunction = void(*)(const T* source, size_t count, T scale, T offset, T* destination);
+	template<typename T> using MinMaxFunction = void(*)(const T* source, size_t count, T& minimum, T& maximum);
+
+	struct KernelTable
+	{
+		WidenFunction Widen;
+		NarrowFunction Narrow;
+		ByteSwapFunction ByteSwap16;
+		ByteSwapFunction ByteSwap32;
+		ByteSwapFunction ByteSwap64;
+		AffineFunction<float> AffineFloat;
+		AffineFunction<double> AffineDouble;
+		MinMaxFunction<float> MinMaxFloat;
+		MinMaxFunction<double> MinMaxDouble;
+	};
+
+
+	// scalar kernels, also finish the tails of the vector kernels
+	static void WidenScalar(const uint8_t* source, size_t count, double* destination)
+	{
+		for (size_t i = 0; i < count; ++i)
+			destination[i] = static_cast<double>(ReadFloat_LittleEndian(source + i * 4));
+	}
+
+	static void NarrowScalar(const uint8_t* source, size_t count, float* destination)
+	{
+		for (size_t i = 0; i < count; ++i)
+			destination[i] = static_cast<float>(ReadDouble_LittleEndian(source + i * 8));
+	}
+
+	template<typename Raw> static void ByteSwapScalar(const uint8_t* source, size_t count, uint8_t* destination)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			Raw value;
+			std::memcpy(&value, source + i * sizeof(Raw), sizeof(Raw));
+			value = byteswap(value);
+			std::memcpy(destination + i * sizeof(Raw), &value, sizeof(Raw));
+		}
+	}
+
+	template<typename T> static void AffineScalar(const T* source, size_t count, T scale, T offset, T* destination)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			T scaled = source[i] * scale;
+			destination[i] = scaled + offset;
+		}
+	}
+
+	// NaN compares false and leaves the range untouched, the vector kernels select lanes the same way
+	template<typename T> static void MinMaxScalar(const T* source, size_t count, T& minimum, T& maximum)
+	{
+		T lowest = minimum;
+		T highest = maximum;
+		for (size_t i = 0; i < count; ++i)
+		{
+			T value = source[i];
+			lowest = value < lowest ? value : lowest;
+			highest = value > highest ? value : highest;
+		}
+		minimum = lowest;
+		maximum = highest;
+	}
+
+	// fold the per-lane minima and maxima of a vector kernel into the range
+	template<typename T> static void MergeLanes(const T* lows, const T* highs, size_t laneCount, T& minimum, T& maximum)
+	{
+		for (size_t lane = 0; lane < laneCount; ++lane)
+		{
+			minimum = lows[lane] < minimum ? lows[lane] : minimum;
+			maximum = highs[lane] > maximum ? highs[lane] : maximum;
+		}
+	}
+
+	constexpr KernelTable SCALAR_KERNELS = { WidenScalar, NarrowScalar, ByteSwapScalar<uint16_t>, ByteSwapScalar<uint32_t>, ByteSwapScalar<uint64_t>, AffineScalar<float>, AffineScalar<double>, MinMaxScalar<float>, MinMaxScalar<double> };
+
+
+#if defined(JTF_CONVERT_X86)
+	JTF_TARGET_SSE2 static void WidenSse2(const uint8_t* source, size_t count, double* destination)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 floats = _mm_loadu_ps(reinterpret_cast<const float*>(source + i * 4));
+			_mm_storeu_pd(destination + i, _mm_cvtps_pd(floats));
+			_mm_storeu_pd(destination + i + 2, _mm_cvtps_pd(_mm_movehl_ps(floats, floats)));
+		}
+		WidenScalar(source + i * 4, count - i, destination + i);
+	}
+
+	JTF_TARGET_SSE2 static void NarrowSse2(const uint8_t* source, size_t count, float* destination)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 low = _mm_cvtpd_ps(_mm_loadu_pd(reinterpret_cast<const double*>(source + i * 8)));
+			__m128 high = _mm_cvtpd_ps(_mm_loadu_pd(reinterpret_cast<const double*>(source + i * 8 + 16)));
+			_mm_storeu_ps(destination + i, _mm_movelh_ps(low, high));
+		}
+		NarrowScalar(source + i * 8, count - i, destination + i);
+	}
+
+	// SSE2 lacks a byte shuffle: swap the bytes of every 16 bit lane, then reorder the lanes
+	JTF_TARGET_SSE2 static inline __m128i SwapBytes16Sse2(__m128i value)
+	{
+		return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+	}
+
+	JTF_TARGET_SSE2 static void ByteSwap16Sse2(const uint8_t* source, size_t count, uint8_t* destination)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 2), SwapBytes16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2))));
+		ByteSwapScalar<uint16_t>(source + i * 2, count - i, destination + i * 2);
+	}
+
+	JTF_TARGET_SSE2 static void ByteSwap32Sse2(const uint8_t* source, size_t count, uint8_t* destination)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+			value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), SwapBytes16Sse2(value));
+		}
+		ByteSwapScalar<uint32_t>(source + i * 4, count - i, destination + i * 4);
+	}
+
+	JTF_TARGET_SSE2 static void ByteSwap64Sse2(const uint8_t* source, size_t count, uint8_t* destination)
+	{
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 8));
+			value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 8), SwapBytes16Sse2(value));
+		}
+		ByteSwapScalar<uint64_t>(source + i * 8, count - i, destination + i * 8);
+	}
+
+	JTF_TARGET_SSE2 static void AffineFloatSse2(const float* source, size_t count, float scale, float offset, float* destination)
+	{
+		const __m128 scales = _mm_set1_ps(scale);
+		const __m128 offsets = _mm_set1_ps(offset);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(destination + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	JTF_TARGET_SSE2 static void AffineDoubleSse2(const double* source, size_t count, double scale, double offset, double* destination)
+	{
+		const __m128d scales = _mm_set1_pd(scale);
+		const __m128d offsets = _mm_set1_pd(offset);
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+			_mm_storeu_pd(destination + i, _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	JTF_TARGET_SSE2 static void MinMaxFloatSse2(const float* source, size_t count, float& minimum, float& maximum)
+	{
+		__m128 lows = _mm_set1_ps(minimum);
+		__m128 highs = _mm_set1_ps(maximum);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 values = _mm_loadu_ps(source + i);
+			lows = _mm_min_ps(values, lows);
+			highs = _mm_max_ps(values, highs);
+		}
+
+		alignas(64) float lanes[2][4];
+		_mm_store_ps(lanes[0], lows);
+		_mm_store_ps(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 4, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	JTF_TARGET_SSE2 static void MinMaxDoubleSse2(const double* source, size_t count, double& minimum, double& maximum)
+	{
+		__m128d lows = _mm_set1_pd(minimum);
+		__m128d highs = _mm_set1_pd(maximum);
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128d values = _mm_loadu_pd(source + i);
+			lows = _mm_min_pd(values, lows);
+			highs = _mm_max_pd(values, highs);
+		}
+
+		alignas(64) double lanes[2][2];
+		_mm_store_pd(lanes[0], lows);
+		_mm_store_pd(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 2, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	constexpr KernelTable SSE2_KERNELS = { WidenSse2, NarrowSse2, ByteSwap16Sse2, ByteSwap32Sse2, ByteSwap64Sse2, AffineFloatSse2, AffineDoubleSse2, MinMaxFloatSse2, MinMaxDoubleSse2 };
+
+
+	JTF_TARGET_AVX2 static void WidenAvx2(const uint8_t* source, size_t count, double* destination)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 floats = _mm256_loadu_ps(reinterpret_cast<const float*>(source + i * 4));
+			_mm256_storeu_pd(destination + i, _mm256_cvtps_pd(_mm256_castps256_ps128(floats)));
+			_mm256_storeu_pd(destination + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(floats, 1)));
+		}
+		WidenScalar(source + i * 4, count - i, destination + i);
+	}
+
+	JTF_TARGET_AVX2 static void NarrowAvx2(const uint8_t* source, size_t count, float* destination)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128 low = _mm256_cvtpd_ps(_mm256_loadu_pd(reinterpret_cast<const double*>(source + i * 8)));
+			__m128 high = _mm256_cvtpd_ps(_mm256_loadu_pd(reinterpret_cast<const double*>(source + i * 8 + 32)));
+			_mm256_storeu_ps(destination + i, _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1));
+		}
+		NarrowScalar(source + i * 8, count - i, destination + i);
+	}
+
+	// byte order reversal within every element of Size bytes, repeated per 128 bit lane
+	template<size_t Size> JTF_TARGET_AVX2 static inline __m256i ByteSwapMask256()
+	{
+		alignas(16) uint8_t mask[16];
+		for (size_t byte = 0; byte < 16; ++byte)
+			mask[byte] = static_cast<uint8_t>(byte / Size * Size + (Size - 1 - byte % Size));
+		return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+	}
+
+	template<typename Raw> JTF_TARGET_AVX2 static void ByteSwapAvx2(const uint8_t* source, size_t count, uint8_t* destination)
+	{
+		constexpr size_t perVector = 32 / sizeof(Raw);
+		const __m256i mask = ByteSwapMask256<sizeof(Raw)>();
+		size_t i = 0;
+		for (; i + perVector <= count; i += perVector)
+		{
+			__m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * sizeof(Raw)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * sizeof(Raw)), _mm256_shuffle_epi8(value, mask));
+		}
+		ByteSwapScalar<Raw>(source + i * sizeof(Raw), count - i, destination + i * sizeof(Raw));
+	}
+
+	JTF_TARGET_AVX2 static void AffineFloatAvx2(const float* source, size_t count, float scale, float offset, float* destination)
+	{
+		const __m256 scales = _mm256_set1_ps(scale);
+		const __m256 offsets = _mm256_set1_ps(offset);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(destination + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	JTF_TARGET_AVX2 static void AffineDoubleAvx2(const double* source, size_t count, double scale, double offset, double* destination)
+	{
+		const __m256d scales = _mm256_set1_pd(scale);
+		const __m256d offsets = _mm256_set1_pd(offset);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			_mm256_storeu_pd(destination + i, _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	JTF_TARGET_AVX2 static void MinMaxFloatAvx2(const float* source, size_t count, float& minimum, float& maximum)
+	{
+		__m256 lows = _mm256_set1_ps(minimum);
+		__m256 highs = _mm256_set1_ps(maximum);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 values = _mm256_loadu_ps(source + i);
+			lows = _mm256_min_ps(values, lows);
+			highs = _mm256_max_ps(values, highs);
+		}
+
+		alignas(64) float lanes[2][8];
+		_mm256_store_ps(lanes[0], lows);
+		_mm256_store_ps(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 8, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	JTF_TARGET_AVX2 static void MinMaxDoubleAvx2(const double* source, size_t count, double& minimum, double& maximum)
+	{
+		__m256d lows = _mm256_set1_pd(minimum);
+		__m256d highs = _mm256_set1_pd(maximum);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m256d values = _mm256_loadu_pd(source + i);
+			lows = _mm256_min_pd(values, lows);
+			highs = _mm256_max_pd(values, highs);
+		}
+
+		alignas(64) double lanes[2][4];
+		_mm256_store_pd(lanes[0], lows);
+		_mm256_store_pd(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 4, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	constexpr KernelTable AVX2_KERNELS = { WidenAvx2, NarrowAvx2, ByteSwapAvx2<uint16_t>, ByteSwapAvx2<uint32_t>, ByteSwapAvx2<uint64_t>, AffineFloatAvx2, AffineDoubleAvx2, MinMaxFloatAvx2, MinMaxDoubleAvx2 };
+
+
+	// the zero-masked conversions equal the plain ones, whose GCC 12 header versions trip -Wuninitialized on their undefined pass-through
+	constexpr __mmask8 ALL_LANES_8 = 0xFF;
+	constexpr __mmask16 ALL_LANES_16 = 0xFFFF;
+
+	JTF_TARGET_AVX512 static void WidenAvx512(const uint8_t* source, size_t count, double* destination)
+	{
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m256 low = _mm256_loadu_ps(reinterpret_cast<const float*>(source + i * 4));
+			__m256 high = _mm256_loadu_ps(reinterpret_cast<const float*>(source + i * 4 + 32));
+			_mm512_storeu_pd(destination + i, _mm512_maskz_cvtps_pd(ALL_LANES_8, low));
+			_mm512_storeu_pd(destination + i + 8, _mm512_maskz_cvtps_pd(ALL_LANES_8, high));
+		}
+		WidenScalar(source + i * 4, count - i, destination + i);
+	}
+
+	JTF_TARGET_AVX512 static void NarrowAvx512(const uint8_t* source, size_t count, float* destination)
+	{
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m256 low = _mm512_maskz_cvtpd_ps(ALL_LANES_8, _mm512_loadu_pd(reinterpret_cast<const double*>(source + i * 8)));
+			__m256 high = _mm512_maskz_cvtpd_ps(ALL_LANES_8, _mm512_loadu_pd(reinterpret_cast<const double*>(source + i * 8 + 64)));
+			_mm256_storeu_ps(destination + i, low);
+			_mm256_storeu_ps(destination + i + 8, high);
+		}
+		NarrowScalar(source + i * 8, count - i, destination + i);
+	}
+
+	template<typename Raw> JTF_TARGET_AVX512 static void ByteSwapAvx512(const uint8_t* source, size_t count, uint8_t* destination)
+	{
+		alignas(64) uint8_t bytes[64];
+		for (size_t byte = 0; byte < 64; ++byte)
+			bytes[byte] = static_cast<uint8_t>(byte % 16 / sizeof(Raw) * sizeof(Raw) + (sizeof(Raw) - 1 - byte % sizeof(Raw)));
+		const __m512i mask = _mm512_load_si512(bytes);
+
+		constexpr size_t perVector = 64 / sizeof(Raw);
+		size_t i = 0;
+		for (; i + perVector <= count; i += perVector)
+		{
+			__m512i value = _mm512_loadu_si512(source + i * sizeof(Raw));
+			_mm512_storeu_si512(destination + i * sizeof(Raw), _mm512_shuffle_epi8(value, mask));
+		}
+		ByteSwapScalar<Raw>(source + i * sizeof(Raw), count - i, destination + i * sizeof(Raw));
+	}
+
+	JTF_TARGET_AVX512 static void AffineFloatAvx512(const float* source, size_t count, float scale, float offset, float* destination)
+	{
+		const __m512 scales = _mm512_set1_ps(scale);
+		const __m512 offsets = _mm512_set1_ps(offset);
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+			_mm512_storeu_ps(destination + i, _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	JTF_TARGET_AVX512 static void AffineDoubleAvx512(const double* source, size_t count, double scale, double offset, double* destination)
+	{
+		const __m512d scales = _mm512_set1_pd(scale);
+		const __m512d offsets = _mm512_set1_pd(offset);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			_mm512_storeu_pd(destination + i, _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	JTF_TARGET_AVX512 static void MinMaxFloatAvx512(const float* source, size_t count, float& minimum, float& maximum)
+	{
+		__m512 lows = _mm512_set1_ps(minimum);
+		__m512 highs = _mm512_set1_ps(maximum);
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m512 values = _mm512_loadu_ps(source + i);
+			lows = _mm512_maskz_min_ps(ALL_LANES_16, values, lows);
+			highs = _mm512_maskz_max_ps(ALL_LANES_16, values, highs);
+		}
+
+		alignas(64) float lanes[2][16];
+		_mm512_store_ps(lanes[0], lows);
+		_mm512_store_ps(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 16, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	JTF_TARGET_AVX512 static void MinMaxDoubleAvx512(const double* source, size_t count, double& minimum, double& maximum)
+	{
+		__m512d lows = _mm512_set1_pd(minimum);
+		__m512d highs = _mm512_set1_pd(maximum);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m512d values = _mm512_loadu_pd(source + i);
+			lows = _mm512_maskz_min_pd(ALL_LANES_8, values, lows);
+			highs = _mm512_maskz_max_pd(ALL_LANES_8, values, highs);
+		}
+
+		alignas(64) double lanes[2][8];
+		_mm512_store_pd(lanes[0], lows);
+		_mm512_store_pd(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 8, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	constexpr KernelTable AVX512_KERNELS = { WidenAvx512, NarrowAvx512, ByteSwapAvx512<uint16_t>, ByteSwapAvx512<uint32_t>, ByteSwapAvx512<uint64_t>, AffineFloatAvx512, AffineDoubleAvx512, MinMaxFloatAvx512, MinMaxDoubleAvx512 };
+
+
+	static SampleKernel SelectX86Kernel() noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int registers[4] = {};
+		__cpuid(registers, 0);
+		int maxLeaf = registers[0];
+		__cpuid(registers, 1);
+		bool sse2 = (registers[3] & (1 << 26)) != 0;
+		bool osXsave = (registers[2] & (1 << 27)) != 0;
+		bool avx = (registers[2] & (1 << 28)) != 0;
+		uint64_t xcr0 = osXsave ? _xgetbv(0) : 0;
+		bool ymmState = (xcr0 & 0x06) == 0x06;
+		bool zmmState = (xcr0 & 0xE6) == 0xE6;
+		bool avx2 = false, avx512 = false;
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(registers, 7, 0);
+			avx2 = avx && ymmState && (registers[1] & (1 << 5)) != 0;
+			avx512 = zmmState && (registers[1] & (1 << 16)) != 0 && (registers[1] & (1 << 30)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		bool sse2 = __builtin_cpu_supports("sse2");
+		bool avx2 = __builtin_cpu_supports("avx2");
+		bool avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+		if (avx512) return SampleKernel::Avx512;
+		if (avx2) return SampleKernel::Avx2;
+		if (sse2) return SampleKernel::Sse2;
+		return SampleKernel::Scalar;
+	}
+#endif // JTF_CONVERT_X86
+
+
+#if defined(JTF_CONVERT_NEON)
+	static void WidenNeon(const uint8_t* source, size_t count, double* destination)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x4_t floats = vld1q_f32(reinterpret_cast<const float*>(source + i * 4));
+			vst1q_f64(destination + i, vcvt_f64_f32(vget_low_f32(floats)));
+			vst1q_f64(destination + i + 2, vcvt_high_f64_f32(floats));
+		}
+		WidenScalar(source + i * 4, count - i, destination + i);
+	}
+
+	static void NarrowNeon(const uint8_t* source, size_t count, float* destination)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x2_t low = vcvt_f32_f64(vld1q_f64(reinterpret_cast<const double*>(source + i * 8)));
+			vst1q_f32(destination + i, vcvt_high_f32_f64(low, vld1q_f64(reinterpret_cast<const double*>(source + i * 8 + 16))));
+		}
+		NarrowScalar(source + i * 8, count - i, destination + i);
+	}
+
+	template<typename Raw> static void ByteSwapNeon(const uint8_t* source, size_t count, uint8_t* destination)
+	{
+		constexpr size_t perVector = 16 / sizeof(Raw);
+		size_t i = 0;
+		for (; i + perVector <= count; i += perVector)
+		{
+			uint8x16_t value = vld1q_u8(source + i * sizeof(Raw));
+			if constexpr (sizeof(Raw) == 2) value = vrev16q_u8(value);
+			else if constexpr (sizeof(Raw) == 4) value = vrev32q_u8(value);
+			else value = vrev64q_u8(value);
+			vst1q_u8(destination + i * sizeof(Raw), value);
+		}
+		ByteSwapScalar<Raw>(source + i * sizeof(Raw), count - i, destination + i * sizeof(Raw));
+	}
+
+	static void AffineFloatNeon(const float* source, size_t count, float scale, float offset, float* destination)
+	{
+		const float32x4_t scales = vdupq_n_f32(scale);
+		const float32x4_t offsets = vdupq_n_f32(offset);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			vst1q_f32(destination + i, vaddq_f32(vmulq_f32(vld1q_f32(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	static void AffineDoubleNeon(const double* source, size_t count, double scale, double offset, double* destination)
+	{
+		const float64x2_t scales = vdupq_n_f64(scale);
+		const float64x2_t offsets = vdupq_n_f64(offset);
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+			vst1q_f64(destination + i, vaddq_f64(vmulq_f64(vld1q_f64(source + i), scales), offsets));
+		AffineScalar(source + i, count - i, scale, offset, destination + i);
+	}
+
+	static void MinMaxFloatNeon(const float* source, size_t count, float& minimum, float& maximum)
+	{
+		float32x4_t lows = vdupq_n_f32(minimum);
+		float32x4_t highs = vdupq_n_f32(maximum);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x4_t values = vld1q_f32(source + i);
+			lows = vbslq_f32(vcltq_f32(values, lows), values, lows);
+			highs = vbslq_f32(vcgtq_f32(values, highs), values, highs);
+		}
+
+		alignas(64) float lanes[2][4];
+		vst1q_f32(lanes[0], lows);
+		vst1q_f32(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 4, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	static void MinMaxDoubleNeon(const double* source, size_t count, double& minimum, double& maximum)
+	{
+		float64x2_t lows = vdupq_n_f64(minimum);
+		float64x2_t highs = vdupq_n_f64(maximum);
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			float64x2_t values = vld1q_f64(source + i);
+			lows = vbslq_f64(vcltq_f64(values, lows), values, lows);
+			highs = vbslq_f64(vcgtq_f64(values, highs), values, highs);
+		}
+
+		alignas(64) double lanes[2][2];
+		vst1q_f64(lanes[0], lows);
+		vst1q_f64(lanes[1], highs);
+		MergeLanes(lanes[0], lanes[1], 2, minimum, maximum);
+		MinMaxScalar(source + i, count - i, minimum, maximum);
+	}
+
+	constexpr KernelTable NEON_KERNELS = { WidenNeon, NarrowNeon, ByteSwapNeon<uint16_t>, ByteSwapNeon<uint32_t>, ByteSwapNeon<uint64_t>, AffineFloatNeon, AffineDoubleNeon, MinMaxFloatNeon, MinMaxDoubleNeon };
+#endif // JTF_CONVERT_NEON
+
+
+	static SampleKernel SelectKernel() noexcept
+	{
+		// the vector kernels reinterpret payload bytes as native lanes, which only matches little-endian hosts
+		if constexpr (std::endian::native != std::endian::little)
+			return SampleKernel::Scalar;
+#if defined(JTF_CONVERT_X86)
+		return SelectX86Kernel();
+#elif defined(JTF_CONVERT_NEON)
+		return SampleKernel::Neon; // Advanced SIMD is mandatory on ARM64
+#else
+		return SampleKernel::Scalar;
+#endif
+	}
+
+	static const KernelTable& ResolveKernels(SampleKernel kernel) noexcept
+	{
+		switch (kernel)
+		{
+#if defined(JTF_CONVERT_X86)
+		case SampleKernel::Sse2:
+			return SSE2_KERNELS;
+		case SampleKernel::Avx2:
+			return AVX2_KERNELS;
+		case SampleKernel::Avx512:
+			return AVX512_KERNELS;
+#endif
+#if defined(JTF_CONVERT_NEON)
+		case SampleKernel::Neon:
+			return NEON_KERNELS;
+#endif
+		default:
+			return SCALAR_KERNELS;
+		}
+	}
+
+	// function local statics, conversions may run during static initialization of other translation units
+	static SampleKernel GetSelectedKernel() noexcept
+	{
+		static const SampleKernel kernel = SelectKernel();
+		return kernel;
+	}
+
+	static const KernelTable& GetSelectedKernels() noexcept
+	{
+		static const KernelTable& kernels = ResolveKernels(GetSelectedKernel());
+		return kernels;
+	}
+
+	static const KernelTable& GetKernels(SampleKernel kernel) noexcept
+	{
+		return SampleConverter::IsKernelSupported(kernel) ? ResolveKernels(kernel) : SCALAR_KERNELS;
+	}
+
+	static void ByteSwapWith(const KernelTable& kernels, const uint8_t* source, size_t count, size_t sampleSize, uint8_t* destination) noexcept
+	{
+		switch (sampleSize)
+		{
+		case 2:
+			kernels.ByteSwap16(source, count, destination);
+			break;
+		case 4:
+			kernels.ByteSwap32(source, count, destination);
+			break;
+		case 8:
+			kernels.ByteSwap64(source, count, destination);
+			break;
+		default:
+			if (source != destination)
+				std::memmove(destination, source, count * sampleSize);
+			break;
+		}
+	}
+
+
+	void SampleConverter::Load_LittleEndian(const uint8_t* source, size_t count, float* destination) noexcept
+	{
+		if constexpr (std::endian::native == std::endian::little)
+			std::memcpy(destination, source, count * sizeof(float));
+		else
+			GetSelectedKernels().ByteSwap32(source, count, reinterpret_cast<uint8_t*>(destination));
+	}
+
+	void SampleConverter::Load_LittleEndian(const uint8_t* source, size_t count, double* destination) noexcept
+	{
+		if constexpr (std::endian::native == std::endian::little)
+			std::memcpy(destination, source, count * sizeof(double));
+		else
+			GetSelectedKernels().ByteSwap64(source, count, reinterpret_cast<uint8_t*>(destination));
+	}
+
+	void SampleConverter::Widen_LittleEndian(const uint8_t* source, size_t count, double* destination) noexcept
+	{
+		GetSelectedKernels().Widen(source, count, destination);
+	}
+
+	void SampleConverter::Narrow_LittleEndian(const uint8_t* source, size_t count, float* destination) noexcept
+	{
+		GetSelectedKernels().Narrow(source, count, destination);
+	}
+
+	void SampleConverter::Affine(const float* source, size_t count, float scale, float offset, float* destination) noexcept
+	{
+		GetSelectedKernels().AffineFloat(source, count, scale, offset, destination);
+	}
+
+	void SampleConverter::Affine(const double* source, size_t count, double scale, double offset, double* destination) noexcept
+	{
+		GetSelectedKernels().AffineDouble(source, count, scale, offset, destination);
+	}
+
+	void SampleConverter::MinMax(const float* source, size_t count, float& minimum, float& maximum) noexcept
+	{
+		GetSelectedKernels().MinMaxFloat(source, count, minimum, maximum);
+	}
+
+	void SampleConverter::MinMax(const double* source, size_t count, double& minimum, double& maximum) noexcept
+	{
+		GetSelectedKernels().MinMaxDouble(source, count, minimum, maximum);
+	}
+
+	void SampleConverter::ByteSwap(const uint8_t* source, size_t count, size_t sampleSize, uint8_t* destination) noexcept
+	{
+		ByteSwapWith(GetSelectedKernels(), source, count, sampleSize, destination);
+	}
+
+	SampleKernel SampleConverter::GetKernel() noexcept
+	{
+		return GetSelectedKernel();
+	}
+
+	const char* SampleConverter::GetKernelName() noexcept
+	{
+		switch (GetSelectedKernel())
+		{
+		case SampleKernel::Scalar:
+			return "scalar";
+		case SampleKernel::Sse2:
+			return "sse2";
+		case SampleKernel::Avx2:
+			return "avx2";
+		case SampleKernel::Avx512:
+			return "avx512";
+		case SampleKernel::Neon:
+			return "neon";
+		default:
+			return "unknown";
+		}
+	}
+
+	bool SampleConverter::IsKernelSupported(SampleKernel kernel) noexcept
+	{
+		switch (kernel)
+		{
+		case SampleKernel::Scalar:
+			return true;
+#if defined(JTF_CONVERT_X86)
+		case SampleKernel::Sse2:
+		case SampleKernel::Avx2:
+		case SampleKernel::Avx512:
+		{
+			// each x86 tier implies the ones below it, the selected kernel is the highest supported
+			SampleKernel selected = GetSelectedKernel();
+			return selected != SampleKernel::Scalar && kernel <= selected;
+		}
+#endif
+#if defined(JTF_CONVERT_NEON)
+		case SampleKernel::Neon:
+			return GetSelectedKernel() == SampleKernel::Neon;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	void SampleConverter::Widen_LittleEndian(SampleKernel kernel, const uint8_t* source, size_t count, double* destination) noexcept
+	{
+		GetKernels(kernel).Widen(source, count, destination);
+	}
+
+	void SampleConverter::Narrow_LittleEndian(SampleKernel kernel, const uint8_t* source, size_t count, float* destination) noexcept
+	{
+		GetKernels(kernel).Narrow(source, count, destination);
+	}
+
+	void SampleConverter::Affine(SampleKernel kernel, const float* source, size_t count, float scale, float offset, float* destination) noexcept
+	{
+		GetKernels(kernel).AffineFloat(source, count, scale, offset, destination);
+	}
+
+	void SampleConverter::Affine(SampleKernel kernel, const double* source, size_t count, double scale, double offset, double* destination) noexcept
+	{
+		GetKernels(kernel).AffineDouble(source, count, scale, offset, destination);
+	}
+
+	void SampleConverter::MinMax(SampleKernel kernel, const float* source, size_t count, float& minimum, float& maximum) noexcept
+	{
+		GetKernels(kernel).MinMaxFloat(source, count, minimum, maximum);
+	}
+
+	void SampleConverter::MinMax(SampleKernel kernel, const double* source, size_t count, double& minimum, double& maximum) noexcept
+	{
+		GetKernels(kernel).MinMaxDouble(source, count, minimum, maximum);
+	}
+
+	void SampleConverter::ByteSwap(SampleKernel kernel, const uint8_t* source, size_t count, size_t sampleSize, uint8_t* destination) noexcept
+	{
+		ByteSwapWith(GetKernels(kernel), source, count, sampleSize, destination);
+	}
+}
\ No newline at end of file
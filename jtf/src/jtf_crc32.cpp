@@ -3,18 +3,373 @@
 // See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
 
 #include "jtf_crc32.h"
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+	#define JTF_CRC32_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+	#define JTF_CRC32_ARM
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define WIN32_LEAN_AND_MEAN
+		#include <windows.h>
+	#else
+		#include <arm_acle.h>
+		#if defined(__linux__)
+			#include <sys/auxv.h>
+			#include <asm/hwcap.h>
+		#endif
+	#endif
+#endif
+
+// per function instruction set targeting, the library itself is built for the baseline ISA
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define JTF_TARGET_PCLMUL
+	#define JTF_TARGET_ARM_CRC
+#elif defined(__clang__)
+	#define JTF_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+	#define JTF_TARGET_ARM_CRC __attribute__((target("crc")))
+#else
+	#define JTF_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+	#define JTF_TARGET_ARM_CRC __attribute__((target("+crc")))
+#endif
 
 namespace cybex_interactive::jtf
 {
-	void Crc32::Append(const uint8_t* data, size_t length) noexcept
+	using AppendFunction = uint32_t(*)(uint32_t crc, const uint8_t* data, size_t length);
+
+	constexpr uint32_t CRC32_POLYNOMIAL_REFLECTED = 0xEDB88320u;
+
+	// slice tables, [0] is the classic byte table, [k] advances a byte through k additional zero bytes
+	static constexpr std::array<std::array<uint32_t, 256>, 16> BuildSliceTables() noexcept
 	{
-		const uint8_t* bytes = static_cast<const uint8_t*>(data);
-		uint32_t crc = m_value;
+		std::array<std::array<uint32_t, 256>, 16> tables{};
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t crc = i;
+			for (int bit = 0; bit < 8; ++bit)
+				crc = (crc & 1u) ? (crc >> 1) ^ CRC32_POLYNOMIAL_REFLECTED : (crc >> 1);
+			tables[0][i] = crc;
+		}
+		for (size_t k = 1; k < 16; ++k)
+			for (size_t i = 0; i < 256; ++i)
+				tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+		return tables;
+	}
 
+	static constexpr std::array<std::array<uint32_t, 256>, 16> SLICE_TABLES = BuildSliceTables();
+
+
+	inline static uint32_t LoadUInt32_LittleEndian(const uint8_t* pointer) noexcept
+	{
+		return (static_cast<uint32_t>(pointer[0]))
+			 | (static_cast<uint32_t>(pointer[1]) << 8)
+			 | (static_cast<uint32_t>(pointer[2]) << 16)
+			 | (static_cast<uint32_t>(pointer[3]) << 24);
+	}
+
+	uint32_t Crc32::AppendTable(uint32_t crc, const uint8_t* bytes, size_t length) noexcept
+	{
 		for (size_t i = 0; i < length; ++i)
 			crc = (crc >> 8) ^ m_table[(crc ^ bytes[i]) & 0xFF];
+		return crc;
+	}
+
+	static uint32_t AppendSliceBy16(uint32_t crc, const uint8_t* bytes, size_t length) noexcept
+	{
+		const std::array<std::array<uint32_t, 256>, 16>& t = SLICE_TABLES;
+
+		while (length >= 16)
+		{
+			uint32_t w0 = LoadUInt32_LittleEndian(bytes) ^ crc;
+			uint32_t w1 = LoadUInt32_LittleEndian(bytes + 4);
+			uint32_t w2 = LoadUInt32_LittleEndian(bytes + 8);
+			uint32_t w3 = LoadUInt32_LittleEndian(bytes + 12);
+
+			crc = t[15][w0 & 0xFF] ^ t[14][(w0 >> 8) & 0xFF] ^ t[13][(w0 >> 16) & 0xFF] ^ t[12][w0 >> 24]
+				^ t[11][w1 & 0xFF] ^ t[10][(w1 >> 8) & 0xFF] ^ t[9][(w1 >> 16) & 0xFF] ^ t[8][w1 >> 24]
+				^ t[7][w2 & 0xFF] ^ t[6][(w2 >> 8) & 0xFF] ^ t[5][(w2 >> 16) & 0xFF] ^ t[4][w2 >> 24]
+				^ t[3][w3 & 0xFF] ^ t[2][(w3 >> 8) & 0xFF] ^ t[1][(w3 >> 16) & 0xFF] ^ t[0][w3 >> 24];
+
+			bytes += 16;
+			length -= 16;
+		}
+
+		for (size_t i = 0; i < length; ++i)
+			crc = (crc >> 8) ^ t[0][(crc ^ bytes[i]) & 0xFF];
+		return crc;
+	}
+
+
+#if defined(JTF_CRC32_X86)
+	// folding constants for the reflected CRC-32 IEEE polynomial (Intel, "Fast CRC Computation Using PCLMULQDQ")
+	alignas(16) static const uint64_t PCLMUL_K1K2[2] = { 0x0154442BD4ull, 0x01C6E41596ull };	// fold by 4 x 128 bit
+	alignas(16) static const uint64_t PCLMUL_K3K4[2] = { 0x01751997D0ull, 0x00CCAA009Eull };	// fold by 1 x 128 bit
+	alignas(16) static const uint64_t PCLMUL_K5K0[2] = { 0x0163CD6124ull, 0x0000000000ull };	// fold 128 to 64 bit
+	alignas(16) static const uint64_t PCLMUL_POLY[2] = { 0x01DB710641ull, 0x01F7011641ull };	// Barrett reduction
+
+	constexpr size_t PCLMUL_MINIMUM_LENGTH = 64;
 
-		m_value = crc;
+	/// <summary>Folds a multiple of 16 bytes (at least 64) into the CRC, four 128 bit lanes at a time.</summary>
+	JTF_TARGET_PCLMUL static uint32_t FoldPclmul(uint32_t crc, const uint8_t* bytes, size_t length) noexcept
+	{
+		__m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x00));
+		__m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x10));
+		__m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x20));
+		__m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x30));
+		x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+
+		__m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(PCLMUL_K1K2));
+		bytes += 64;
+		length -= 64;
+
+		// fold 512 bits per iteration
+		while (length >= 64)
+		{
+			__m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+			__m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+			__m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+			__m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+
+			x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x00)));
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x10)));
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x20)));
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 0x30)));
+
+			bytes += 64;
+			length -= 64;
+		}
+
+		// fold the four lanes into one
+		k = _mm_load_si128(reinterpret_cast<const __m128i*>(PCLMUL_K3K4));
+
+		__m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+		x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+		x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+		// fold remaining 128 bit blocks
+		while (length >= 16)
+		{
+			x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+			x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+			bytes += 16;
+			length -= 16;
+		}
+
+		// fold 128 bits to 64 bits
+		x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+		x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+		x1 = _mm_srli_si128(x1, 8);
+		x1 = _mm_xor_si128(x1, x2);
+
+		k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(PCLMUL_K5K0));
+		x2 = _mm_srli_si128(x1, 4);
+		x1 = _mm_and_si128(x1, x3);
+		x1 = _mm_clmulepi64_si128(x1, k, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		// Barrett reduction to 32 bits
+		k = _mm_load_si128(reinterpret_cast<const __m128i*>(PCLMUL_POLY));
+		x2 = _mm_and_si128(x1, x3);
+		x2 = _mm_clmulepi64_si128(x2, k, 0x10);
+		x2 = _mm_and_si128(x2, x3);
+		x2 = _mm_clmulepi64_si128(x2, k, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+	}
+
+	static uint32_t AppendPclmul(uint32_t crc, const uint8_t* bytes, size_t length) noexcept
+	{
+		if (length >= PCLMUL_MINIMUM_LENGTH)
+		{
+			size_t folded = length & ~static_cast<size_t>(15);
+			crc = FoldPclmul(crc, bytes, folded);
+			bytes += folded;
+			length -= folded;
+		}
+		return AppendSliceBy16(crc, bytes, length);
+	}
+
+	static bool CpuSupportsPclmul() noexcept
+	{
+		constexpr unsigned int ECX_PCLMULQDQ = 1u << 1;
+		constexpr unsigned int ECX_SSE41 = 1u << 19;
+#if defined(_MSC_VER)
+		int registers[4] = {};
+		__cpuid(registers, 1);
+		unsigned int ecx = static_cast<unsigned int>(registers[2]);
+#else
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			return false;
+#endif
+		return (ecx & ECX_PCLMULQDQ) && (ecx & ECX_SSE41);
+	}
+#endif // JTF_CRC32_X86
+
+
+#if defined(JTF_CRC32_ARM)
+	JTF_TARGET_ARM_CRC static uint32_t AppendArmCrc(uint32_t crc, const uint8_t* bytes, size_t length) noexcept
+	{
+		// the CRC32X/B instructions consume little-endian data, matching the reflected table loop
+		while (length >= 32)
+		{
+			uint64_t d0, d1, d2, d3;
+			std::memcpy(&d0, bytes + 0, 8);
+			std::memcpy(&d1, bytes + 8, 8);
+			std::memcpy(&d2, bytes + 16, 8);
+			std::memcpy(&d3, bytes + 24, 8);
+			crc = __crc32d(crc, d0);
+			crc = __crc32d(crc, d1);
+			crc = __crc32d(crc, d2);
+			crc = __crc32d(crc, d3);
+			bytes += 32;
+			length -= 32;
+		}
+		while (length >= 8)
+		{
+			uint64_t d;
+			std::memcpy(&d, bytes, 8);
+			crc = __crc32d(crc, d);
+			bytes += 8;
+			length -= 8;
+		}
+		while (length--)
+			crc = __crc32b(crc, *bytes++);
+		return crc;
+	}
+
+	static bool CpuSupportsArmCrc() noexcept
+	{
+#if defined(_MSC_VER)
+		return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != 0;
+#elif defined(__APPLE__)
+		return true; // every Apple arm64 core implements ARMv8.1 CRC32
+#elif defined(__linux__)
+		return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+		return false;
+#endif
+	}
+#endif // JTF_CRC32_ARM
+
+
+	static Crc32Engine SelectEngine() noexcept
+	{
+#if defined(JTF_CRC32_X86)
+		if (CpuSupportsPclmul())
+			return Crc32Engine::Pclmul;
+#elif defined(JTF_CRC32_ARM)
+		if (CpuSupportsArmCrc())
+			return Crc32Engine::ArmCrc;
+#endif
+		return Crc32Engine::SliceBy16;
+	}
+
+	static AppendFunction ResolveAppend(Crc32Engine engine) noexcept
+	{
+		switch (engine)
+		{
+#if defined(JTF_CRC32_X86)
+		case Crc32Engine::Pclmul:
+			return AppendPclmul;
+#endif
+#if defined(JTF_CRC32_ARM)
+		case Crc32Engine::ArmCrc:
+			return AppendArmCrc;
+#endif
+		case Crc32Engine::SliceBy16:
+			return AppendSliceBy16;
+		default:
+			return AppendSliceBy16;
+		}
+	}
+
+	// polynomial arithmetic modulo the reflected CRC-32 polynomial, bit 31 holds x^0
+	static constexpr uint32_t MultiplyModP(uint32_t a, uint32_t b) noexcept
+	{
+		uint32_t product = 0;
+		for (uint32_t mask = 1u << 31; mask != 0; mask >>= 1)
+		{
+			if (a & mask)
+				product ^= b;
+			b = b & 1 ? (b >> 1) ^ CRC32_POLYNOMIAL_REFLECTED : b >> 1;
+		}
+		return product;
+	}
+
+	// x^(2^k) modulo the polynomial, k = 0..31
+	static constexpr std::array<uint32_t, 32> BuildPowerTable() noexcept
+	{
+		std::array<uint32_t, 32> table{};
+		uint32_t power = 1u << 30; // x^1
+		for (size_t k = 0; k < table.size(); ++k)
+		{
+			table[k] = power;
+			power = MultiplyModP(power, power);
+		}
+		return table;
+	}
+
+	static constexpr std::array<uint32_t, 32> POWER_TABLE = BuildPowerTable();
+
+	// x^(n * 2^k) modulo the polynomial
+	static uint32_t PowerModP(size_t n, uint32_t k) noexcept
+	{
+		uint32_t power = 1u << 31; // x^0
+		for (; n != 0; n >>= 1, ++k)
+			if (n & 1)
+				power = MultiplyModP(POWER_TABLE[k & 31], power);
+		return power;
+	}
+
+	// function local statics, Append may run during static initialization of other translation units
+	static Crc32Engine GetSelectedEngine() noexcept
+	{
+		static const Crc32Engine engine = SelectEngine();
+		return engine;
+	}
+
+	static AppendFunction GetSelectedAppend() noexcept
+	{
+		static const AppendFunction append = ResolveAppend(GetSelectedEngine());
+		return append;
+	}
+
+
+	void Crc32::Append(const uint8_t* data, size_t length) noexcept
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+		// table loop for short runs (chunk types, CRC fields), dispatch overhead would dominate
+		if (length < 16)
+			m_value = AppendTable(m_value, bytes, length);
+		else
+			m_value = GetSelectedAppend()(m_value, bytes, length);
 	}
 
 	uint32_t Crc32::Hash(const uint8_t* data, size_t length) noexcept
@@ -23,4 +378,56 @@ namespace cybex_interactive::jtf
 		crc.Append(data, length);
 		return crc.GetCurrentHashAsUInt32();
 	}
+
+	uint32_t Crc32::Combine(uint32_t crcA, uint32_t crcB, size_t lengthB) noexcept
+	{
+		// shift crcA over lengthB zero bytes, the register pre and post conditioning cancels out
+		return MultiplyModP(PowerModP(lengthB, 3), crcA) ^ crcB;
+	}
+
+	Crc32Engine Crc32::GetEngine() noexcept
+	{
+		return GetSelectedEngine();
+	}
+
+	const char* Crc32::GetEngineName() noexcept
+	{
+		switch (GetSelectedEngine())
+		{
+		case Crc32Engine::SliceBy16:
+			return "slice-by-16";
+		case Crc32Engine::Pclmul:
+			return "pclmul";
+		case Crc32Engine::ArmCrc:
+			return "armv8-crc";
+		default:
+			return "unknown";
+		}
+	}
+
+	bool Crc32::IsEngineSupported(Crc32Engine engine) noexcept
+	{
+		switch (engine)
+		{
+		case Crc32Engine::SliceBy16:
+			return true;
+#if defined(JTF_CRC32_X86)
+		case Crc32Engine::Pclmul:
+			return CpuSupportsPclmul();
+#endif
+#if defined(JTF_CRC32_ARM)
+		case Crc32Engine::ArmCrc:
+			return CpuSupportsArmCrc();
+#endif
+		default:
+			return false;
+		}
+	}
+
+	uint32_t Crc32::Hash(Crc32Engine engine, const uint8_t* data, size_t length) noexcept
+	{
+		// the engine runs every length, short runs included
+		AppendFunction append = IsEngineSupported(engine) ? ResolveAppend(engine) : AppendSliceBy16;
+		return append(0xFFFFFFFFu, data, length) ^ 0xFFFFFFFFu;
+	}
 }
\ No newline at end of file
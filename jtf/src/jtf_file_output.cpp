@@ -0,0 +1,315 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#include "jtf_file_output.h"
+#include "jtf_stats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
+
+namespace cybex_interactive::jtf
+{
+	// attempts at a unique temporary file name before giving up
+	constexpr int TEMP_NAME_ATTEMPTS = 16;
+
+	// temporary file next to the target, so the rename stays on one file system
+	inline static std::string TempFilePath(const std::string& filePath)
+	{
+		static std::atomic<uint64_t> counter = 0;
+#if defined(_WIN32)
+		uint64_t process = GetCurrentProcessId();
+#else
+		uint64_t process = static_cast<uint64_t>(::getpid());
+#endif
+		uint64_t nonce = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^ (process << 32) ^ (counter++ * 0x9E3779B97F4A7C15ull);
+		return std::format("{}.{:016x}.tmp", filePath, nonce);
+	}
+
+	// a symbolic link is kept, the file it points to is replaced
+	inline static std::string ReplacedFilePath(const std::string& filePath)
+	{
+		std::error_code error;
+		if (!std::filesystem::is_symlink(filePath, error))
+			return filePath;
+		std::filesystem::path target = std::filesystem::weakly_canonical(filePath, error);
+		return error ? filePath : target.string();
+	}
+
+
+#if defined(_WIN32)
+	inline static HANDLE ToHandle(intptr_t file) { return reinterpret_cast<HANDLE>(file); }
+
+	FileOutputBuffer::FileOutputBuffer(const std::string& filePath, bool atomicReplace) : m_filePath(atomicReplace ? ReplacedFilePath(filePath) : filePath)
+	{
+		HANDLE file = INVALID_HANDLE_VALUE;
+		if (atomicReplace)
+		{
+			for (int attempt = 0; attempt < TEMP_NAME_ATTEMPTS && file == INVALID_HANDLE_VALUE; ++attempt)
+			{
+				m_tempPath = TempFilePath(m_filePath);
+				file = CreateFileW(std::filesystem::path(m_tempPath).c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (file == INVALID_HANDLE_VALUE && GetLastError() != ERROR_FILE_EXISTS)
+					break;
+			}
+		}
+		else
+			file = CreateFileW(std::filesystem::path(filePath).c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			m_tempPath.clear();
+			return;
+		}
+		m_file = reinterpret_cast<intptr_t>(file);
+		ResizeTracked(m_staging, OUTPUT_STAGING_SIZE);
+		setp(m_staging.data(), m_staging.data() + m_staging.size());
+	}
+
+	bool FileOutputBuffer::IsOpen() const noexcept
+	{
+		return ToHandle(m_file) != INVALID_HANDLE_VALUE;
+	}
+
+	bool FileOutputBuffer::WriteOut(const char* data, size_t size)
+	{
+		if (m_failed)
+			return false;
+
+		// buffered handles have no gather write, one WriteFile per region
+		size_t staged = static_cast<size_t>(pptr() - pbase());
+		for (auto [region, length] : { std::pair<const char*, size_t>{ pbase(), staged }, std::pair<const char*, size_t>{ data, size } })
+		{
+			while (length > 0)
+			{
+				DWORD written = 0;
+				DWORD part = static_cast<DWORD>(std::min<size_t>(length, size_t(1) << 30));
+				CountStat(&JTF_Stats::WriteCalls, 1);
+				if (!WriteFile(ToHandle(m_file), region, part, &written, nullptr) || written == 0)
+				{
+					m_failed = true;
+					return false;
+				}
+				region += written;
+				length -= written;
+			}
+		}
+
+		m_written += staged + size;
+		setp(m_staging.data(), m_staging.data() + m_staging.size());
+		return true;
+	}
+
+	bool FileOutputBuffer::Close() noexcept
+	{
+		if (!IsOpen())
+			return true;
+		BOOL closed = CloseHandle(ToHandle(m_file));
+		m_file = reinterpret_cast<intptr_t>(INVALID_HANDLE_VALUE);
+		return closed != 0;
+	}
+
+	bool FileOutputBuffer::Commit()
+	{
+		if (m_committed)
+			return true;
+		if (!IsOpen() || !WriteOut(nullptr, 0))
+			return false;
+
+		if (!m_tempPath.empty() && !FlushFileBuffers(ToHandle(m_file)))
+			return false;
+		if (!Close())
+			return false;
+		if (!m_tempPath.empty() && !MoveFileExW(std::filesystem::path(m_tempPath).c_str(), std::filesystem::path(m_filePath).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+			return false;
+
+		m_committed = true;
+		return true;
+	}
+#else
+	FileOutputBuffer::FileOutputBuffer(const std::string& filePath, bool atomicReplace) : m_filePath(atomicReplace ? ReplacedFilePath(filePath) : filePath)
+	{
+		int file = -1;
+		if (atomicReplace)
+		{
+			for (int attempt = 0; attempt < TEMP_NAME_ATTEMPTS && file < 0; ++attempt)
+			{
+				m_tempPath = TempFilePath(m_filePath);
+				file = ::open(m_tempPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+				if (file < 0 && errno != EEXIST)
+					break;
+			}
+
+			// a replaced file keeps its permissions
+			struct stat target;
+			if (file >= 0 && ::stat(m_filePath.c_str(), &target) == 0 && S_ISREG(target.st_mode))
+				::fchmod(file, target.st_mode & 07777);
+		}
+		else
+			file = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+
+		if (file < 0)
+		{
+			m_tempPath.clear();
+			return;
+		}
+		m_file = file;
+		ResizeTracked(m_staging, OUTPUT_STAGING_SIZE);
+		setp(m_staging.data(), m_staging.data() + m_staging.size());
+	}
+
+	bool FileOutputBuffer::IsOpen() const noexcept
+	{
+		return m_file >= 0;
+	}
+
+	bool FileOutputBuffer::WriteOut(const char* data, size_t size)
+	{
+		if (m_failed)
+			return false;
+
+		// staged bytes and payload in one vectored write, repeated for whatever a partial write left
+		size_t staged = static_cast<size_t>(pptr() - pbase());
+		iovec vectors[2];
+		int count = 0;
+		if (staged > 0) vectors[count++] = { pbase(), staged };
+		if (size > 0) vectors[count++] = { const_cast<char*>(data), size };
+
+		iovec* next = vectors;
+		while (count > 0)
+		{
+			CountStat(&JTF_Stats::WriteCalls, 1);
+			ssize_t written = ::writev(static_cast<int>(m_file), next, count);
+			if (written < 0 && errno == EINTR)
+				continue;
+			if (written <= 0)
+			{
+				m_failed = true;
+				return false;
+			}
+
+			size_t remaining = static_cast<size_t>(written);
+			while (count > 0 && next->iov_len <= remaining)
+			{
+				remaining -= next->iov_len;
+				++next;
+				--count;
+			}
+			if (count > 0)
+			{
+				next->iov_base = static_cast<char*>(next->iov_base) + remaining;
+				next->iov_len -= remaining;
+			}
+		}
+
+		m_written += staged + size;
+		setp(m_staging.data(), m_staging.data() + m_staging.size());
+		return true;
+	}
+
+	bool FileOutputBuffer::Close() noexcept
+	{
+		if (!IsOpen())
+			return true;
+		int closed = ::close(static_cast<int>(m_file));
+		m_file = -1;
+		return closed == 0;
+	}
+
+	bool FileOutputBuffer::Commit()
+	{
+		if (m_committed)
+			return true;
+		if (!IsOpen() || !WriteOut(nullptr, 0))
+			return false;
+
+		if (!m_tempPath.empty() && ::fsync(static_cast<int>(m_file)) != 0)
+			return false;
+		if (!Close())
+			return false;
+		if (!m_tempPath.empty())
+		{
+			if (::rename(m_tempPath.c_str(), m_filePath.c_str()) != 0)
+				return false;
+
+			// persist the rename itself, best effort as not every file system syncs directories
+			std::string directory = std::filesystem::path(m_filePath).parent_path().string();
+			int directoryFile = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (directoryFile >= 0)
+			{
+				::fsync(directoryFile);
+				::close(directoryFile);
+			}
+		}
+
+		m_committed = true;
+		return true;
+	}
+#endif
+
+	FileOutputBuffer::~FileOutputBuffer()
+	{
+		Close();
+		if (!m_committed && !m_tempPath.empty())
+		{
+			std::error_code error;
+			std::filesystem::remove(m_tempPath, error);
+		}
+	}
+
+	FileOutputBuffer::int_type FileOutputBuffer::overflow(int_type character)
+	{
+		if (!IsOpen() || !WriteOut(nullptr, 0))
+			return traits_type::eof();
+		if (!traits_type::eq_int_type(character, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(character);
+			pbump(1);
+		}
+		return traits_type::not_eof(character);
+	}
+
+	std::streamsize FileOutputBuffer::xsputn(const char_type* data, std::streamsize count)
+	{
+		if (!IsOpen() || count <= 0)
+			return 0;
+
+		size_t size = static_cast<size_t>(count);
+		if (size >= OUTPUT_GATHER_SIZE)
+			return WriteOut(data, size) ? count : 0;
+
+		if (size > static_cast<size_t>(epptr() - pptr()) && !WriteOut(nullptr, 0))
+			return 0;
+		std::memcpy(pptr(), data, size);
+		pbump(static_cast<int>(size));
+		return count;
+	}
+
+	int FileOutputBuffer::sync()
+	{
+		return IsOpen() && WriteOut(nullptr, 0) ? 0 : -1;
+	}
+
+	FileOutputBuffer::pos_type FileOutputBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which)
+	{
+		// position queries only, the writers never seek back
+		if (offset != 0 || direction != std::ios_base::cur || !(which & std::ios_base::out))
+			return pos_type(off_type(-1));
+		return pos_type(off_type(m_written + static_cast<uint64_t>(pptr() - pbase())));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,346 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#include "jtf_query.h"
+#include "jtf_height_tree.h"
+#include "jtf_utility.h"
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace cybex_interactive::jtf
+{
+	inline static std::string QueryError(const std::string& message)
+	{
+		return std::format("[JTF Query Error] {}\n", message);
+	}
+
+	// what a region traversal does with a cell after looking at its bounds
+	enum class CellVisit : uint8_t { Skip, Descend, Stop };
+
+	inline static constexpr double INFINITE_HEIGHT = std::numeric_limits<double>::infinity();
+
+	// lowest and highest sample, cells inside the range seen so far cannot widen it
+	struct RangeVisitor
+	{
+		JTF_HeightRange Range{ INFINITE_HEIGHT, -INFINITE_HEIGHT };
+
+		CellVisit Visit(double low, double high, bool covered)
+		{
+			if (low >= Range.Min && high <= Range.Max)
+				return CellVisit::Skip;
+			if (!covered)
+				return CellVisit::Descend;
+			Range.Min = std::min(Range.Min, low);
+			Range.Max = std::max(Range.Max, high);
+			return CellVisit::Skip;
+		}
+
+		bool Sample(double value)
+		{
+			Range.Min = std::min(Range.Min, value);
+			Range.Max = std::max(Range.Max, value);
+			return false;
+		}
+	};
+
+	// range that stops as soon as it spans more than the tolerance
+	struct FlatVisitor : RangeVisitor
+	{
+		double Tolerance = 0.0;
+
+		CellVisit Visit(double low, double high, bool covered)
+		{
+			CellVisit visit = RangeVisitor::Visit(low, high, covered);
+			return Range.Max - Range.Min > Tolerance ? CellVisit::Stop : visit;
+		}
+
+		bool Sample(double value)
+		{
+			RangeVisitor::Sample(value);
+			return Range.Max - Range.Min > Tolerance;
+		}
+	};
+
+	// any sample within [Min, Max]: cells outside are skipped, a covered cell whose lowest or highest sample falls within decides
+	struct OverlapVisitor
+	{
+		double Min = 0.0;
+		double Max = 0.0;
+
+		CellVisit Visit(double low, double high, bool covered) const
+		{
+			if (high < Min || low > Max)
+				return CellVisit::Skip;
+			if (covered && ((low >= Min && low <= Max) || (high >= Min && high <= Max)))
+				return CellVisit::Stop;
+			return CellVisit::Descend;
+		}
+
+		bool Sample(double value) const { return value >= Min && value <= Max; }
+	};
+
+	// Möller-Trumbore, shortens nearest on a hit closer than nearest
+	inline static bool IntersectTriangle(const JTF_Ray& ray, const double (&a)[3], const double (&b)[3], const double (&c)[3], double& nearest)
+	{
+		constexpr double EDGE_TOLERANCE = 1e-12; // closes cracks along shared triangle edges
+
+		double edge1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		double edge2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		const double* direction = ray.Direction;
+		double p[3] = {
+			direction[1] * edge2[2] - direction[2] * edge2[1],
+			direction[2] * edge2[0] - direction[0] * edge2[2],
+			direction[0] * edge2[1] - direction[1] * edge2[0] };
+		double determinant = edge1[0] * p[0] + edge1[1] * p[1] + edge1[2] * p[2];
+		if (determinant == 0.0)
+			return false; // parallel to the triangle
+
+		double inverse = 1.0 / determinant;
+		double s[3] = { ray.Origin[0] - a[0], ray.Origin[1] - a[1], ray.Origin[2] - a[2] };
+		double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+		if (u < -EDGE_TOLERANCE || u > 1.0 + EDGE_TOLERANCE)
+			return false;
+
+		double q[3] = {
+			s[1] * edge1[2] - s[2] * edge1[1],
+			s[2] * edge1[0] - s[0] * edge1[2],
+			s[0] * edge1[1] - s[1] * edge1[0] };
+		double v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverse;
+		if (v < -EDGE_TOLERANCE || u + v > 1.0 + EDGE_TOLERANCE)
+			return false;
+
+		double distance = (edge2[0] * q[0] + edge2[1] * q[1] + edge2[2] * q[2]) * inverse;
+		if (distance < 0.0 || distance >= nearest)
+			return false;
+		nearest = distance;
+		return true;
+	}
+
+
+	JTFHeightQuery::JTFHeightQuery(const JTF_HeightTree& tree, std::span<const double> heights)
+		: m_tree(tree), m_heights(heights)
+	{
+		if (tree.Width == 0 || tree.Height == 0)
+			throw std::invalid_argument(QueryError(std::format("Tree map size [{}x{}] subceeds limit of 1.", tree.Width, tree.Height)));
+		if (tree.LeafSize < HEIGHT_TREE_LEAF_MIN || tree.LeafSize > HEIGHT_TREE_LEAF_MAX)
+			throw std::invalid_argument(QueryError(std::format("Tree leaf size [{}] outside of [{}..{}].", tree.LeafSize, HEIGHT_TREE_LEAF_MIN, HEIGHT_TREE_LEAF_MAX)));
+		if (heights.size() != size_t(tree.Width) * tree.Height)
+			throw std::invalid_argument(QueryError("heights size mismatch with tree map size (width * height)."));
+
+		std::vector<std::pair<uint16_t, uint16_t>> sizes = HeightTreeLevelSizes(tree.Width, tree.Height, tree.LeafSize);
+		bool matches = tree.Levels.size() == sizes.size();
+		for (size_t level = 0; matches && level < sizes.size(); ++level)
+		{
+			const JTF_HeightTreeLevel& cells = tree.Levels[level];
+			matches = cells.CellsX == sizes[level].first && cells.CellsY == sizes[level].second && cells.Bounds.size() == size_t(cells.CellsX) * cells.CellsY * 2;
+		}
+		if (!matches)
+			throw std::invalid_argument(QueryError(std::format("Tree levels do not match [{}x{}] map with leaf size [{}].", tree.Width, tree.Height, tree.LeafSize)));
+	}
+
+	JTF_HeightTree JTFHeightQuery::BuildTree(std::span<const double> heights, uint16_t width, uint16_t height, uint16_t leafSize, uint32_t threadCount)
+	{
+		if (width == 0 || height == 0)
+			throw std::invalid_argument(QueryError(std::format("width [{}] and/or height [{}] subceeds limit of 1.", width, height)));
+		if (leafSize < HEIGHT_TREE_LEAF_MIN || leafSize > HEIGHT_TREE_LEAF_MAX)
+			throw std::invalid_argument(QueryError(std::format("leaf size [{}] outside of [{}..{}].", leafSize, HEIGHT_TREE_LEAF_MIN, HEIGHT_TREE_LEAF_MAX)));
+		if (heights.size() != size_t(width) * height)
+			throw std::invalid_argument(QueryError("heights size mismatch with map size (width * height)."));
+
+		std::vector<std::pair<uint16_t, uint16_t>> sizes = HeightTreeLevelSizes(width, height, leafSize);
+		std::vector<std::vector<double>> levels = BuildHeightTreeBounds(heights.data(), width, height, leafSize, threadCount);
+
+		JTF_HeightTree tree;
+		tree.Width = width;
+		tree.Height = height;
+		tree.LeafSize = leafSize;
+		tree.Levels.resize(levels.size());
+		for (size_t level = 0; level < levels.size(); ++level)
+		{
+			tree.Levels[level].CellsX = sizes[level].first;
+			tree.Levels[level].CellsY = sizes[level].second;
+			tree.Levels[level].Bounds = std::move(levels[level]);
+		}
+		return tree;
+	}
+
+	JTF_HeightRange JTFHeightQuery::GetRange(uint16_t x, uint16_t y, uint16_t width, uint16_t height) const
+	{
+		RangeVisitor visitor;
+		VisitRegion(0, 0, 0, MakeRegion(x, y, width, height), visitor);
+		return visitor.Range;
+	}
+
+	bool JTFHeightQuery::Overlaps(uint16_t x, uint16_t y, uint16_t width, uint16_t height, double minHeight, double maxHeight) const
+	{
+		if (minHeight > maxHeight)
+			throw std::invalid_argument(QueryError(std::format("min height [{}] exceeds max height [{}].", minHeight, maxHeight)));
+
+		OverlapVisitor visitor{ minHeight, maxHeight };
+		return VisitRegion(0, 0, 0, MakeRegion(x, y, width, height), visitor);
+	}
+
+	bool JTFHeightQuery::IsFlat(uint16_t x, uint16_t y, uint16_t width, uint16_t height, double tolerance) const
+	{
+		FlatVisitor visitor;
+		visitor.Tolerance = tolerance;
+		return !VisitRegion(0, 0, 0, MakeRegion(x, y, width, height), visitor);
+	}
+
+	bool JTFHeightQuery::Raycast(const JTF_Ray& ray, JTF_RayHit& hit) const
+	{
+		if (ray.Direction[0] == 0.0 && ray.Direction[1] == 0.0 && ray.Direction[2] == 0.0)
+			throw std::invalid_argument(QueryError("Ray direction is zero."));
+
+		double nearest = ray.MaxDistance;
+		double enter;
+		if (!IntersectCell(0, 0, 0, ray, nearest, enter) || !RaycastCell(0, 0, 0, ray, nearest))
+			return false;
+
+		hit.Distance = nearest;
+		for (int axis = 0; axis < 3; ++axis)
+			hit.Position[axis] = ray.Origin[axis] + ray.Direction[axis] * nearest;
+		return true;
+	}
+
+	JTFHeightQuery::SampleRect JTFHeightQuery::MakeRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height) const
+	{
+		if (width == 0 || height == 0 || uint32_t(x) + width > m_tree.Width || uint32_t(y) + height > m_tree.Height)
+			throw std::out_of_range(QueryError(std::format("Region [{}, {}, {}x{}] outside of [{}x{}] map.", x, y, width, height, m_tree.Width, m_tree.Height)));
+		return { x, y, uint32_t(x) + width - 1, uint32_t(y) + height - 1 };
+	}
+
+	JTFHeightQuery::SampleRect JTFHeightQuery::CellRect(size_t level, uint32_t cellX, uint32_t cellY) const
+	{
+		// cells double in size with every level above the leaves
+		uint32_t cellSize = uint32_t(m_tree.LeafSize) << (m_tree.Levels.size() - 1 - level);
+		auto [firstX, lastX] = HeightTreeCellSpan(cellX, cellSize, m_tree.Width);
+		auto [firstY, lastY] = HeightTreeCellSpan(cellY, cellSize, m_tree.Height);
+		return { firstX, firstY, lastX, lastY };
+	}
+
+	template<typename Visitor> bool JTFHeightQuery::VisitRegion(size_t level, uint32_t cellX, uint32_t cellY, const SampleRect& region, Visitor& visitor) const
+	{
+		SampleRect cell = CellRect(level, cellX, cellY);
+		if (cell.LastX < region.FirstX || cell.FirstX > region.LastX || cell.LastY < region.FirstY || cell.FirstY > region.LastY)
+			return false;
+
+		const JTF_HeightTreeLevel& cells = m_tree.Levels[level];
+		size_t index = (size_t(cellY) * cells.CellsX + cellX) * 2;
+		bool covered = cell.FirstX >= region.FirstX && cell.LastX <= region.LastX && cell.FirstY >= region.FirstY && cell.LastY <= region.LastY;
+		CellVisit visit = visitor.Visit(cells.Bounds[index], cells.Bounds[index + 1], covered);
+		if (visit != CellVisit::Descend)
+			return visit == CellVisit::Stop;
+
+		// leaf the bounds did not decide, scan its samples within the region
+		if (level + 1 == m_tree.Levels.size())
+		{
+			for (uint32_t y = std::max(cell.FirstY, region.FirstY); y <= std::min(cell.LastY, region.LastY); ++y)
+			{
+				const double* row = m_heights.data() + size_t(y) * m_tree.Width;
+				for (uint32_t x = std::max(cell.FirstX, region.FirstX); x <= std::min(cell.LastX, region.LastX); ++x)
+					if (visitor.Sample(row[x]))
+						return true;
+			}
+			return false;
+		}
+
+		const JTF_HeightTreeLevel& children = m_tree.Levels[level + 1];
+		for (uint32_t childY = cellY * 2; childY < std::min<uint32_t>(cellY * 2 + 2, children.CellsY); ++childY)
+			for (uint32_t childX = cellX * 2; childX < std::min<uint32_t>(cellX * 2 + 2, children.CellsX); ++childX)
+				if (VisitRegion(level + 1, childX, childY, region, visitor))
+					return true;
+		return false;
+	}
+
+	bool JTFHeightQuery::IntersectCell(size_t level, uint32_t cellX, uint32_t cellY, const JTF_Ray& ray, double nearest, double& enter) const
+	{
+		SampleRect cell = CellRect(level, cellX, cellY);
+		const JTF_HeightTreeLevel& cells = m_tree.Levels[level];
+		size_t index = (size_t(cellY) * cells.CellsX + cellX) * 2;
+		const double lower[3] = { double(cell.FirstX), double(cell.FirstY), cells.Bounds[index] };
+		const double upper[3] = { double(cell.LastX), double(cell.LastY), cells.Bounds[index + 1] };
+
+		// slab test of the cell's bounding box, clipped to [0, nearest]
+		enter = 0.0;
+		double exit = nearest;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (ray.Direction[axis] == 0.0)
+			{
+				if (ray.Origin[axis] < lower[axis] || ray.Origin[axis] > upper[axis])
+					return false;
+				continue;
+			}
+
+			double inverse = 1.0 / ray.Direction[axis];
+			double slabEnter = (lower[axis] - ray.Origin[axis]) * inverse;
+			double slabExit = (upper[axis] - ray.Origin[axis]) * inverse;
+			if (slabEnter > slabExit)
+				std::swap(slabEnter, slabExit);
+			enter = std::max(enter, slabEnter);
+			exit = std::min(exit, slabExit);
+			if (enter > exit)
+				return false;
+		}
+		return true;
+	}
+
+	bool JTFHeightQuery::RaycastCell(size_t level, uint32_t cellX, uint32_t cellY, const JTF_Ray& ray, double& nearest) const
+	{
+		// leaf, two triangles per quad
+		if (level + 1 == m_tree.Levels.size())
+		{
+			SampleRect cell = CellRect(level, cellX, cellY);
+			bool hit = false;
+			for (uint32_t y = cell.FirstY; y < cell.LastY; ++y)
+			{
+				const double* row = m_heights.data() + size_t(y) * m_tree.Width;
+				const double* nextRow = row + m_tree.Width;
+				for (uint32_t x = cell.FirstX; x < cell.LastX; ++x)
+				{
+					const double corner00[3] = { double(x), double(y), row[x] };
+					const double corner10[3] = { double(x + 1), double(y), row[x + 1] };
+					const double corner11[3] = { double(x + 1), double(y + 1), nextRow[x + 1] };
+					const double corner01[3] = { double(x), double(y + 1), nextRow[x] };
+					hit |= IntersectTriangle(ray, corner00, corner10, corner11, nearest);
+					hit |= IntersectTriangle(ray, corner00, corner11, corner01, nearest);
+				}
+			}
+			return hit;
+		}
+
+		// children the ray enters, nearest first
+		struct Child { double Enter; uint32_t X, Y; };
+		Child children[4];
+		size_t childCount = 0;
+		const JTF_HeightTreeLevel& childCells = m_tree.Levels[level + 1];
+		for (uint32_t childY = cellY * 2; childY < std::min<uint32_t>(cellY * 2 + 2, childCells.CellsY); ++childY)
+			for (uint32_t childX = cellX * 2; childX < std::min<uint32_t>(cellX * 2 + 2, childCells.CellsX); ++childX)
+			{
+				double enter;
+				if (!IntersectCell(level + 1, childX, childY, ray, nearest, enter))
+					continue;
+
+				// insertion keeps the at most four children sorted by entry distance
+				size_t slot = childCount++;
+				for (; slot > 0 && children[slot - 1].Enter > enter; --slot)
+					children[slot] = children[slot - 1];
+				children[slot] = { enter, childX, childY };
+			}
+
+		// a child entered beyond the nearest hit so far cannot hold a nearer one
+		bool hit = false;
+		for (size_t child = 0; child < childCount; ++child)
+		{
+			if (children[child].Enter > nearest)
+				break;
+			hit |= RaycastCell(level + 1, children[child].X, children[child].Y, ray, nearest);
+		}
+		return hit;
+	}
+}
\ No newline at end of file
@@ -4,11 +4,29 @@
 
 #include "jtf.h"
 #include "jtf_utility.h"
+#include "jtf_codec.h"
+#include "jtf_convert.h"
+#include "jtf_parallel.h"
+#include "jtf_thread_pool.h"
+#include "jtf_async_io.h"
 #include <cstring>
 #include <cstdint>
 #include <format>
+#include <mutex>
 #include <optional>
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
 
 namespace cybex_interactive::jtf
 {
@@ -18,87 +36,21 @@ namespace cybex_interactive::jtf
 	}
 
 
-	inline static void ReadToBuffer(const std::string& filePath, std::ifstream& file, void* buffer, size_t size)
+	inline static void ReadToBuffer(const std::string& filePath, std::istream& file, void* buffer, size_t size)
 	{
+		StatsTimer timer(&JTF_Stats::IoNanoseconds);
 		file.read(reinterpret_cast<char*>(buffer), size);
 		if (!file || static_cast<std::size_t>(file.gcount()) != size)
 			throw std::runtime_error(FileReadError(filePath, "Unexpected EOF."));
+		CountStat(&JTF_Stats::BytesRead, size);
 	}
 
 
-	inline static int32_t ReadInt32_LittleEndian(const uint8_t* pointer)
-	{
-		uint32_t raw = (static_cast<uint32_t>(pointer[0]))
-					 | (static_cast<uint32_t>(pointer[1]) << 8)
-					 | (static_cast<uint32_t>(pointer[2]) << 16)
-					 | (static_cast<uint32_t>(pointer[3]) << 24);
-		return static_cast<int32_t>(raw);
-	}
-
-	inline static uint8_t ReadUInt8_LittleEndian(const uint8_t* pointer)
-	{
-		return (static_cast<uint8_t>(pointer[0]));
-	}
-
-	inline static uint16_t ReadUInt16_LittleEndian(const uint8_t* pointer)
-	{
-		return (static_cast<uint16_t>(pointer[0]))
-			 | (static_cast<uint16_t>(pointer[1]) << 8);
-	}
-
-	inline static uint32_t ReadUInt32_LittleEndian(const uint8_t* pointer)
-	{
-		return (static_cast<uint32_t>(pointer[0]))
-			 | (static_cast<uint32_t>(pointer[1]) << 8)
-			 | (static_cast<uint32_t>(pointer[2]) << 16)
-			 | (static_cast<uint32_t>(pointer[3]) << 24);
-	}
-
-	inline static uint64_t ReadUInt64_LittleEndian(const uint8_t* pointer)
-	{
-		return (static_cast<uint64_t>(pointer[0]))
-			 | (static_cast<uint64_t>(pointer[1]) << 8)
-			 | (static_cast<uint64_t>(pointer[2]) << 16)
-			 | (static_cast<uint64_t>(pointer[3]) << 24)
-			 | (static_cast<uint64_t>(pointer[4]) << 32)
-			 | (static_cast<uint64_t>(pointer[5]) << 40)
-			 | (static_cast<uint64_t>(pointer[6]) << 48)
-			 | (static_cast<uint64_t>(pointer[7]) << 56);
-	}
-
-	inline static float ReadFloat_LittleEndian(const uint8_t* pointer)
-	{
-		uint32_t raw = (static_cast<uint32_t>(pointer[0]))
-					 | (static_cast<uint32_t>(pointer[1]) << 8)
-					 | (static_cast<uint32_t>(pointer[2]) << 16)
-					 | (static_cast<uint32_t>(pointer[3]) << 24);
-		float value;
-		static_assert(sizeof(value) == sizeof(raw));
-		std::memcpy(&value, &raw, sizeof(value));
-		return value;
-	}
-
-	inline static double ReadDouble_LittleEndian(const uint8_t* pointer)
-	{
-		uint64_t raw = (static_cast<uint64_t>(pointer[0]))
-					 | (static_cast<uint64_t>(pointer[1]) << 8)
-					 | (static_cast<uint64_t>(pointer[2]) << 16)
-					 | (static_cast<uint64_t>(pointer[3]) << 24)
-					 | (static_cast<uint64_t>(pointer[4]) << 32)
-					 | (static_cast<uint64_t>(pointer[5]) << 40)
-					 | (static_cast<uint64_t>(pointer[6]) << 48)
-					 | (static_cast<uint64_t>(pointer[7]) << 56);
-		double value;
-		static_assert(sizeof(value) == sizeof(raw));
-		std::memcpy(&value, &raw, sizeof(value));
-		return value;
-	}
-
-
-	uint32_t JTFFile::ReadChunkType(const std::string& filePath, std::ifstream& file)
+	uint32_t JTFFile::ReadChunkType(const std::string& filePath, std::istream& file)
 	{
 		uint8_t bytes[4];
 		ReadToBuffer(filePath, file, bytes, 4);
+		CountStat(&JTF_Stats::ChunksVisited, 1);
 
 		uint32_t chunkType =
 			(static_cast<uint32_t>(bytes[0])) |
@@ -109,6 +61,8 @@ namespace cybex_interactive::jtf
 		return chunkType;
 	}
 
+	constexpr uint32_t HeightChunkIds[] = { CHUNK_ID_HMAP, CHUNK_ID_HTIL, CHUNK_ID_HCMP };
+
 	inline static bool VerifySignature(const uint8_t* bytes)
 	{
 		uint64_t signature = JTF_SIGNATURE;
@@ -122,45 +76,32 @@ namespace cybex_interactive::jtf
 	}
 
 
-	static const std::unordered_map<std::string, uint32_t>& GetRequestableChunkNamesMap()
-	{
-		static const std::unordered_map<std::string, uint32_t> map = []()
-			{
-				std::unordered_map<std::string, uint32_t> m;
-				for (const RequestableChunkName& entry : RequestableChunkNames)
-					m.emplace(std::string(entry.name), entry.id);
-				return m;
-			}();
-		return map;
-	}
-
 	std::optional<uint32_t> LookupChunkID(std::string_view name)
 	{
-		// convert to uppercase
-		std::string key{ name };
-		std::transform(key.begin(), key.end(), key.begin(),
-			[](unsigned char c) -> char
-			{
-				return static_cast<char>(std::toupper(c));
-			});
-
-		const std::unordered_map<std::string, uint32_t>& map = GetRequestableChunkNamesMap();
-		std::unordered_map<std::string, uint32_t>::const_iterator iterator = map.find(std::string(key));
-		if (iterator != map.end())
-			return iterator->second;
+		// case insensitive scan of the few requestable names, no key string is built
+		for (const RequestableChunkName& entry : RequestableChunkNames)
+			if (std::equal(name.begin(), name.end(), entry.name.begin(), entry.name.end(),
+				[](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == b; }))
+				return entry.id;
 		return std::nullopt;
 	}
 
 
-	JTF JTFFile::Read(const std::string& filePath)
+	template<typename Data> Data JTFFile::ReadChunks(const std::string& filePath, const JTF_ReadOptions& options)
 	{
-		JTF jtf;
-
 		// file existance check
 		std::ifstream file(filePath, std::ios::binary);
 		if (!file)
 			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
 
+		return ReadChunks<Data>(filePath, file, options);
+	}
+
+	template<typename Data> Data JTFFile::ReadChunks(const std::string& filePath, std::istream& file, const JTF_ReadOptions& options)
+	{
+		StatsScope scope(options.Stats);
+		Data jtf;
+
 		ReadValidateSignature(filePath, file);
 
 		// read chunks
@@ -180,11 +121,25 @@ namespace cybex_interactive::jtf
 			switch (chunkType)
 			{
 				case CHUNK_ID_HEAD:
-					ReadHeadChunk(filePath, file, payloadSize, fileCrc, jtf);
+					ReadHeadChunk(filePath, file, payloadSize, fileCrc, jtf.Header);
 					break;
 
 				case CHUNK_ID_HMAP:
-					ReadHmapChunk(filePath, file, payloadSize, fileCrc, jtf);
+					ReadHmapChunk(filePath, file, payloadSize, fileCrc, jtf.Header, jtf.Heights, options.ThreadCount);
+					break;
+
+				case CHUNK_ID_HTIL:
+					ReadHtilChunk(filePath, file, payloadSize, fileCrc, jtf.Header, jtf.Heights, options.ThreadCount);
+					break;
+
+				case CHUNK_ID_HCMP:
+					ReadHcmpChunk(filePath, file, payloadSize, fileCrc, jtf.Header, jtf.Heights, options.ThreadCount);
+					break;
+
+				case CHUNK_ID_HLOD:
+				case CHUNK_ID_HQDT:
+				case CHUNK_ID_HDIR:
+					SkipChunk(filePath, file, payloadSize, fileCrc);
 					break;
 
 				case CHUNK_ID_FEND:
@@ -202,9 +157,10 @@ namespace cybex_interactive::jtf
 		return jtf;
 	}
 
-	JTF JTFFile::Read(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc)
+	template<typename Data> Data JTFFile::ReadChunks(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc, const JTF_ReadOptions& options)
 	{
-		JTF jtf;
+		StatsScope scope(options.Stats);
+		Data jtf;
 
 		// file existance check
 		std::ifstream file(filePath, std::ios::binary);
@@ -220,50 +176,101 @@ namespace cybex_interactive::jtf
 		{
 			std::optional<uint32_t> id = LookupChunkID(name);
 			if (!id)
-				throw std::runtime_error(FileReadError(filePath, std::format("Requested unsupported chunk name '{}'. Allowed names are: HEAD, HMAP, FEND.", name)));
+				throw std::runtime_error(FileReadError(filePath, std::format("Requested unsupported chunk name '{}'. Allowed names are: HEAD, HMAP, HTIL, HCMP, FEND.", name)));
 			if (*id == CHUNK_ID_HEAD)
 				continue;
 			requestedChunkIds.push_back(*id);
 		}
 
-		ReadValidateSignature(filePath, file);
-
-		// read chunks
-		Crc32 fileCrc;
-		bool fendReached = false;
-		size_t chunksRemaining = requestedChunkIds.size();
-		while (file && !fendReached)
+		// height data is stored linear, tiled or compressed, depending on the file layout and compression
+		bool heightsRequested = std::find_first_of(requestedChunkIds.begin(), requestedChunkIds.end(), std::begin(HeightChunkIds), std::end(HeightChunkIds)) != requestedChunkIds.end();
+		if (heightsRequested)
 		{
-			// read chunk length
-			uint8_t payloadSizeBytes[4];
-			ReadToBuffer(filePath, file, &payloadSizeBytes, sizeof(payloadSizeBytes));
-			uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+			std::erase_if(requestedChunkIds, [](uint32_t id) { return std::find(std::begin(HeightChunkIds), std::end(HeightChunkIds), id) != std::end(HeightChunkIds); });
+			requestedChunkIds.insert(requestedChunkIds.end(), std::begin(HeightChunkIds), std::end(HeightChunkIds));
+		}
 
-			// read chunk type
-			uint32_t chunkType = ReadChunkType(filePath, file);
+		ReadValidateSignature(filePath, file);
 
-			// dispatch
-			bool requested = std::find(requestedChunkIds.begin(), requestedChunkIds.end(), chunkType) != requestedChunkIds.end();
-			if (requested)
+		// reads a requested chunk, the file positioned at its payload
+		auto readChunk = [&](uint32_t chunkType, uint32_t payloadSize, Crc32& fileCrc)
 			{
 				switch (chunkType)
 				{
 					case CHUNK_ID_HEAD:
-						ReadHeadChunk(filePath, file, payloadSize, fileCrc, jtf);
+						ReadHeadChunk(filePath, file, payloadSize, fileCrc, jtf.Header);
 						break;
 
 					case CHUNK_ID_HMAP:
-						ReadHmapChunk(filePath, file, payloadSize, fileCrc, jtf);
+						ReadHmapChunk(filePath, file, payloadSize, fileCrc, jtf.Header, jtf.Heights, options.ThreadCount);
+						break;
+
+					case CHUNK_ID_HTIL:
+						ReadHtilChunk(filePath, file, payloadSize, fileCrc, jtf.Header, jtf.Heights, options.ThreadCount);
+						break;
+
+					case CHUNK_ID_HCMP:
+						ReadHcmpChunk(filePath, file, payloadSize, fileCrc, jtf.Header, jtf.Heights, options.ThreadCount);
 						break;
 
 					case CHUNK_ID_FEND:
 						ReadFendChunk(filePath, file, payloadSize, fileCrc);
-						fendReached = true;
 						break;
 
 					default:
 						throw std::runtime_error(FileReadError(filePath, std::format("Unknown chunk type '{}'.", DecodeChunkID(chunkType))));
 				}
+			};
+
+		// seek straight to the requested chunks, reading the directory verified the file CRC over all chunk CRCs
+		std::vector<JTF_ChunkEntry> directory;
+		if (ReadHdirChunk(filePath, file, directory))
+		{
+			for (const JTF_ChunkEntry& entry : directory)
+			{
+				if (std::find(requestedChunkIds.begin(), requestedChunkIds.end(), entry.Type) == requestedChunkIds.end())
+				{
+					CountStat(&JTF_Stats::ChunksSkipped, 1);
+					continue;
+				}
+
+				file.seekg(static_cast<std::streamoff>(entry.Offset + 8));
+				if (!file)
+					throw std::runtime_error(FileReadError(filePath, "Unexpected EOF while seeking chunk."));
+				CountStat(&JTF_Stats::ChunksVisited, 1);
+
+				// the chunk reader verifies the payload against the stored chunk CRC, which must be the one the directory lists
+				Crc32 storedCrc;
+				readChunk(entry.Type, entry.Length, storedCrc);
+				uint8_t listedCrc[4];
+				StoreUInt32_LittleEndian(listedCrc, entry.Crc);
+				if (storedCrc.GetCurrentHashAsUInt32() != Crc32::Hash(listedCrc, sizeof(listedCrc)))
+					throw std::runtime_error(FileReadError(filePath, std::format("{} CRC does not match HDIR entry.", DecodeChunkID(entry.Type))));
+			}
+			return jtf;
+		}
+		file.seekg(static_cast<std::streamoff>(sizeof(JTF_SIGNATURE)));
+
+		// read chunks
+		Crc32 fileCrc;
+		bool fendReached = false;
+		size_t chunksRemaining = requestedChunkIds.size() - (heightsRequested ? std::size(HeightChunkIds) - 1 : 0); // a file holds only one of the height chunks
+		while (file && !fendReached)
+		{
+			// read chunk length
+			uint8_t payloadSizeBytes[4];
+			ReadToBuffer(filePath, file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+			uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+			// read chunk type
+			uint32_t chunkType = ReadChunkType(filePath, file);
+
+			// dispatch
+			bool requested = std::find(requestedChunkIds.begin(), requestedChunkIds.end(), chunkType) != requestedChunkIds.end();
+			if (requested)
+			{
+				readChunk(chunkType, payloadSize, fileCrc);
+				if (chunkType == CHUNK_ID_FEND) fendReached = true;
 
 				chunksRemaining--;
 
@@ -272,19 +279,7 @@ namespace cybex_interactive::jtf
 			}
 			else
 			{
-				// skip payload
-				if (payloadSize > 0)
-				{
-					file.seekg(static_cast<std::streamoff>(payloadSize), std::ios::cur);
-					if (!file)
-						throw std::runtime_error(FileReadError(filePath, "Unexpected EOF while skipping payload."));
-				}
-
-				// read expected chunk crc
-				uint8_t expectedCrcBytes[4];
-				ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
-				AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &fileCrc });
-
+				SkipChunk(filePath, file, payloadSize, fileCrc);
 				if (chunkType == CHUNK_ID_FEND) fendReached = true;
 			}
 		}
@@ -294,7 +289,141 @@ namespace cybex_interactive::jtf
 		return jtf;
 	}
 
-	void JTFFile::ReadValidateSignature(const std::string& filePath, std::ifstream& file)
+	JTF JTFFile::Read(const std::string& filePath)
+	{
+		return ReadChunks<JTF>(filePath, JTF_ReadOptions{});
+	}
+
+	JTF JTFFile::Read(const std::string& filePath, const JTF_ReadOptions& options)
+	{
+		return ReadChunks<JTF>(filePath, options);
+	}
+
+	JTF JTFFile::Read(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc)
+	{
+		return ReadChunks<JTF>(filePath, requestedChunks, verifyFileCrc, JTF_ReadOptions{});
+	}
+
+	JTF JTFFile::Read(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc, const JTF_ReadOptions& options)
+	{
+		return ReadChunks<JTF>(filePath, requestedChunks, verifyFileCrc, options);
+	}
+
+	JTF_Native JTFFile::ReadNative(const std::string& filePath)
+	{
+		return ReadChunks<JTF_Native>(filePath, JTF_ReadOptions{});
+	}
+
+	JTF_Native JTFFile::ReadNative(const std::string& filePath, const JTF_ReadOptions& options)
+	{
+		return ReadChunks<JTF_Native>(filePath, options);
+	}
+
+	JTF_Native JTFFile::ReadNative(const std::string& filePath, const std::vector<std::string>& requestedChunks, bool verifyFileCrc)
+	{
+		return ReadChunks<JTF_Native>(filePath, requestedChunks, verifyFileCrc, JTF_ReadOptions{});
+	}
+
+	std::vector<JTF_BatchResult> JTFFile::ReadBatch(const std::vector<std::string>& filePaths, const JTF_ReadOptions& options)
+	{
+		std::vector<JTF_BatchResult> results(filePaths.size());
+		if (filePaths.empty())
+			return results;
+
+		// parallelism is spread across files, every file is read on a single pool thread
+		JTF_ReadOptions fileOptions = options;
+		fileOptions.ThreadCount = 1;
+
+		// every file collects its own stats, merged into the caller's once read
+		std::mutex statsMutex;
+
+		ThreadPool pool(ResolveThreadCount(options.ThreadCount, filePaths.size(), 1));
+		for (size_t i = 0; i < filePaths.size(); ++i)
+			pool.Submit([&, i]()
+				{
+					JTF_Stats stats;
+					JTF_ReadOptions taskOptions = fileOptions;
+					taskOptions.Stats = options.Stats ? &stats : nullptr;
+					try
+					{
+						results[i].Data = Read(filePaths[i], taskOptions);
+					}
+					catch (const std::exception& e)
+					{
+						results[i].Error = e.what();
+					}
+					catch (...)
+					{
+						results[i].Error = FileReadError(filePaths[i], "Unknown native exception during read.");
+					}
+
+					if (options.Stats)
+					{
+						std::lock_guard<std::mutex> lock(statsMutex);
+						MergeStats(*options.Stats, stats);
+					}
+				});
+		pool.Wait();
+
+		return results;
+	}
+
+	void JTFFile::ReadAsync(const std::string& filePath, std::function<void(JTF&& data, std::exception_ptr error)> onComplete, const JTF_ReadOptions& options)
+	{
+		// decoding runs on the reader's worker pool apart from the I/O threads, so the next read is issued while this file is verified and decoded
+		AsyncFileReader& reader = AsyncFileReader::Get();
+
+		// parallelism is spread across reads, every file is decoded on a single pool thread
+		JTF_ReadOptions fileOptions = options;
+		fileOptions.ThreadCount = 1;
+
+		reader.Read(filePath, [&reader, filePath, fileOptions, onComplete = std::move(onComplete)](std::vector<uint8_t>&& bytes, std::exception_ptr error) mutable
+			{
+				if (error)
+				{
+					onComplete(JTF{}, error);
+					return;
+				}
+
+				reader.Submit([filePath, fileOptions, onComplete = std::move(onComplete), bytes = std::move(bytes)]()
+					{
+						JTF jtf;
+						std::exception_ptr error;
+						try
+						{
+							MemoryStreamBuffer buffer(bytes.data(), bytes.size());
+							std::istream file(&buffer);
+							jtf = ReadChunks<JTF>(filePath, file, fileOptions);
+						}
+						catch (...)
+						{
+							error = std::current_exception();
+						}
+						onComplete(std::move(jtf), error);
+					});
+			});
+	}
+
+	std::future<JTF> JTFFile::ReadAsync(const std::string& filePath, const JTF_ReadOptions& options)
+	{
+		auto promise = std::make_shared<std::promise<JTF>>();
+		std::future<JTF> future = promise->get_future();
+		ReadAsync(filePath, [promise](JTF&& data, std::exception_ptr error)
+			{
+				if (error)
+					promise->set_exception(error);
+				else
+					promise->set_value(std::move(data));
+			}, options);
+		return future;
+	}
+
+	const char* JTFFile::GetAsyncBackendName()
+	{
+		return AsyncFileReader::Get().GetBackendName();
+	}
+
+	void JTFFile::ReadValidateSignature(const std::string& filePath, std::istream& file)
 	{
 		// read and verify signature
 		uint8_t signature[8];
@@ -303,19 +432,27 @@ namespace cybex_interactive::jtf
 			throw std::runtime_error(FileReadError(filePath, "Invalid file signature."));
 	}
 
-	void JTFFile::ReadHeadChunk(const std::string& filePath, std::ifstream& file, uint32_t payloadSize, Crc32& fileCrc, JTF& jtf)
+	inline static void ValidateHead(const std::string& filePath, const JTF_Head& header)
 	{
-		if (payloadSize != 32)
+		if (header.Layout != JTF_Layout::Linear && header.Layout != JTF_Layout::Tiled)
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported layout [{}].", static_cast<uint8_t>(header.Layout))));
+		if (header.Compression != JTF_Compression::None && header.Compression != JTF_Compression::PredictiveLZ)
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported compression [{}].", static_cast<uint8_t>(header.Compression))));
+	}
+
+	void JTFFile::ReadHeadChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, JTF_Head& header)
+	{
+		if (payloadSize != HEAD_PAYLOAD_SIZE)
 			throw std::runtime_error(FileReadError(filePath, std::format("Invalid HEAD payload size, expected [32] got [{}].", payloadSize)));
 
-		std::vector<uint8_t> payload(payloadSize);
-		ReadToBuffer(filePath, file, payload.data(), payloadSize);
+		uint8_t payload[HEAD_PAYLOAD_SIZE];
+		ReadToBuffer(filePath, file, payload, payloadSize);
 
 		Crc32 chunkCrc;
 
 		constexpr char expectedChunkTypeName[4] = { 'H','E','A','D' };
 		AppendToCrc(reinterpret_cast<const uint8_t*>(expectedChunkTypeName), 4, { &chunkCrc });
-		AppendToCrc(payload.data(), payloadSize, { &chunkCrc });
+		AppendToCrc(payload, payloadSize, { &chunkCrc });
 
 		// read expected chunk crc
 		uint8_t expectedCrcBytes[4];
@@ -328,52 +465,90 @@ namespace cybex_interactive::jtf
 		if (expectedCrc != computedCrc)
 			throw std::runtime_error(FileReadError(filePath, "HEAD CRC mismatch."));
 
-		// decode fields
-		size_t offset = 0;
-
-		// version major
-		jtf.Header.VersionMajor = ReadUInt8_LittleEndian(payload.data() + offset);
-		offset++;
-		// version minor
-		jtf.Header.VersionMinor = ReadUInt8_LittleEndian(payload.data() + offset);
-		offset++;
-		// version patch
-		jtf.Header.VersionPatch = ReadUInt8_LittleEndian(payload.data() + offset);
-		offset++;
-
-		// dimensions
-		jtf.Header.Width = ReadUInt16_LittleEndian(payload.data() + offset);
-		offset += 2;
-		jtf.Header.Height = ReadUInt16_LittleEndian(payload.data() + offset);
-		offset += 2;
-
-		// bit depth
-		jtf.Header.BitDepth = ReadUInt8_LittleEndian(payload.data() + offset);
-		offset++;
-
-		// RESERVED 8 BYTES ([8..16] = 0 by default)
-		offset += 8;
+		DecodeHeadPayload(payload, header);
+		ValidateHead(filePath, header);
+	}
 
-		// bounds
-		jtf.Header.BoundsLower = ReadInt32_LittleEndian(payload.data() + offset);
-		offset += 4;
-		jtf.Header.BoundsUpper = ReadInt32_LittleEndian(payload.data() + offset);
-		offset += 4;
+	template<typename T> inline static void DecodeSamples_LittleEndian(const uint8_t* source, size_t sampleCount, uint8_t bitDepth, T* destination)
+	{
+		if constexpr (std::is_integral_v<T>)
+		{
+			// raw unsigned normalized samples, bit depth matches T
+			if constexpr (sizeof(T) == 1)
+				std::memcpy(destination, source, sampleCount);
+			else
+				for (size_t i = 0; i < sampleCount; ++i)
+					destination[i] = ReadUInt16_LittleEndian(source + i * 2);
+		}
+		else if (bitDepth == 8)
+			DequantizeUnorm(source, sampleCount, destination);
+		else if (bitDepth == 16)
+		{
+			constexpr T scale = T(1) / T(std::numeric_limits<uint16_t>::max());
+			for (size_t i = 0; i < sampleCount; ++i)
+				destination[i] = static_cast<T>(ReadUInt16_LittleEndian(source + i * 2)) * scale;
+		}
+		else if (bitDepth == 32)
+		{
+			if constexpr (std::is_same_v<T, double>)
+				SampleConverter::Widen_LittleEndian(source, sampleCount, destination);
+			else
+				SampleConverter::Load_LittleEndian(source, sampleCount, destination);
+		}
+		else
+		{
+			if constexpr (std::is_same_v<T, float>)
+				SampleConverter::Narrow_LittleEndian(source, sampleCount, destination);
+			else
+				SampleConverter::Load_LittleEndian(source, sampleCount, destination);
+		}
+	}
 
-		// RESERVED 8 BYTES ([24..32] = 0 by default)
-		offset += 8;
+	/// <summary>Emplace the native sample vector matching the bit depth and pass it to fill.</summary>
+	template<typename Fill> inline static void EmplaceNativeSamples(JTF_NativeHeights& heights, uint8_t bitDepth, Fill&& fill)
+	{
+		switch (bitDepth)
+		{
+			case 8: fill(heights.HeightSamples.emplace<std::vector<uint8_t>>()); break;
+			case 16: fill(heights.HeightSamples.emplace<std::vector<uint16_t>>()); break;
+			case 32: fill(heights.HeightSamples.emplace<std::vector<float>>()); break;
+			default: fill(heights.HeightSamples.emplace<std::vector<double>>()); break;
+		}
 	}
 
-	void JTFFile::ReadHmapChunk(const std::string& filePath, std::ifstream& file, uint32_t payloadSize, Crc32& fileCrc, JTF& jtf)
+	void JTFFile::ReadHmapChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_Heights& heights, uint32_t threadCount)
 	{
+		if (header.Layout != JTF_Layout::Linear || header.Compression != JTF_Compression::None)
+			throw std::runtime_error(FileReadError(filePath, "HMAP chunk in tiled or compressed file."));
+		if (!IsSupportedBitDepth(header.BitDepth))
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HMAP chunk, expected [8], [16], [32] or [64] got [{}].", header.BitDepth)));
+
+		if (payloadSize % (header.BitDepth / 8) != 0)
+			throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match bit depth requirement."));
+		if (payloadSize % (header.Width * header.Height) != 0)
+			throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match (width * height) requirement."));
+
 		Crc32 chunkCrc;
 
 		constexpr char expectedChunkTypeName[4] = { 'H','M','A','P' };
 		AppendToCrc(reinterpret_cast<const uint8_t*>(expectedChunkTypeName), 4, { &chunkCrc });
 
-		std::vector<uint8_t> payload(payloadSize);
+		std::vector<uint8_t> payload;
+		ResizeTracked(payload, payloadSize);
 		ReadToBuffer(filePath, file, payload.data(), payloadSize);
-		AppendToCrc(payload.data(), payloadSize, { &chunkCrc });
+
+		size_t sampleSize = header.BitDepth / 8;
+		size_t sampleCount = payloadSize / sampleSize;
+		ResizeTracked(heights.HeightSamples, sampleCount);
+
+		// widen and hash in one sweep of parallel bands, samples are only valid once the CRC matched below
+		{
+			StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+			ConvertAndAppendToCrcParallel(payload.data(), sampleCount, sampleSize, chunkCrc, threadCount, [&](size_t begin, size_t end)
+				{
+					DecodeSamples_LittleEndian(payload.data() + begin * sampleSize, end - begin, header.BitDepth, heights.HeightSamples.data() + begin);
+				});
+		}
 
 		// read expected chunk crc
 		uint8_t expectedCrcBytes[4];
@@ -385,64 +560,1308 @@ namespace cybex_interactive::jtf
 		uint32_t computedCrc = chunkCrc.GetCurrentHashAsUInt32();
 		if (expectedCrc != computedCrc)
 			throw std::runtime_error(FileReadError(filePath, "HMAP CRC mismatch."));
+	}
 
-		if (payloadSize % (jtf.Header.BitDepth / 8) != 0)
-			throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match bit depth requirement."));
-		if (payloadSize % (jtf.Header.Width * jtf.Header.Height) != 0)
-			throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match (width * height) requirement."));
-
-		size_t sampleCount = payloadSize / (jtf.Header.BitDepth / 8);
-		jtf.Heights.HeightSamples.resize(sampleCount);
+	template<typename T> inline static void ReadSamples_LittleEndian(const std::string& filePath, std::istream& file, T* samples, size_t sampleCount, Crc32& chunkCrc, uint32_t threadCount)
+	{
+		// read straight into the sample storage, the payload is the little-endian sample array
+		uint8_t* bytes = reinterpret_cast<uint8_t*>(samples);
+		ReadToBuffer(filePath, file, bytes, sampleCount * sizeof(T));
+		AppendToCrcParallel(bytes, sampleCount * sizeof(T), chunkCrc, threadCount);
 
-		if (jtf.Header.BitDepth == 32)
+		if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1)
 		{
-			for (size_t i = 0; i < sampleCount; ++i)
-			{
-				const uint8_t* pointer = payload.data() + i * 4;
-				jtf.Heights.HeightSamples[i] = static_cast<double>(ReadFloat_LittleEndian(pointer));
-			}
-		}
-		else if (jtf.Header.BitDepth == 64)
-		{
-			for (size_t i = 0; i < sampleCount; ++i)
-			{
-				const uint8_t* pointer = payload.data() + i * 8;
-				jtf.Heights.HeightSamples[i] = ReadDouble_LittleEndian(pointer);
-			}
+			ParallelForBands(sampleCount, PARALLEL_MIN_SLICE_SIZE / sizeof(T), threadCount, [&](size_t begin, size_t end)
+				{
+					SampleConverter::ByteSwap(bytes + begin * sizeof(T), end - begin, sizeof(T), bytes + begin * sizeof(T));
+				});
 		}
-		else throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HMAP chunk, expected [32] or [64] got [{}].", jtf.Header.BitDepth)));
 	}
 
-	void JTFFile::ReadFendChunk(const std::string& filePath, std::ifstream& file, uint32_t payloadSize, Crc32& fileCrc)
+	void JTFFile::ReadHmapChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_NativeHeights& heights, uint32_t threadCount)
 	{
-		if (payloadSize != 0)
-			throw std::runtime_error(FileReadError(filePath, std::format("Invalid FEND payload size, expected [0] got [{}].", payloadSize)));
+		if (header.Layout != JTF_Layout::Linear || header.Compression != JTF_Compression::None)
+			throw std::runtime_error(FileReadError(filePath, "HMAP chunk in tiled or compressed file."));
+		if (!IsSupportedBitDepth(header.BitDepth))
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HMAP chunk, expected [8], [16], [32] or [64] got [{}].", header.BitDepth)));
+		if (payloadSize % (header.BitDepth / 8) != 0)
+			throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match bit depth requirement."));
+		if (payloadSize % (header.Width * header.Height) != 0)
+			throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match (width * height) requirement."));
 
 		Crc32 chunkCrc;
 
-		constexpr char expectedChunkTypeName[4] = { 'F','E','N','D' };
+		constexpr char expectedChunkTypeName[4] = { 'H','M','A','P' };
 		AppendToCrc(reinterpret_cast<const uint8_t*>(expectedChunkTypeName), 4, { &chunkCrc });
 
+		size_t sampleCount = payloadSize / (header.BitDepth / 8);
+		EmplaceNativeSamples(heights, header.BitDepth, [&](auto& samples)
+			{
+				ResizeTracked(samples, sampleCount);
+				ReadSamples_LittleEndian(filePath, file, samples.data(), sampleCount, chunkCrc, threadCount);
+			});
+
 		// read expected chunk crc
 		uint8_t expectedCrcBytes[4];
 		ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
 		AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &fileCrc });
 		uint32_t expectedCrc = ReadUInt32_LittleEndian(expectedCrcBytes);
 
+		// crc compare
 		uint32_t computedCrc = chunkCrc.GetCurrentHashAsUInt32();
 		if (expectedCrc != computedCrc)
-			throw std::runtime_error(FileReadError(filePath, "FEND CRC mismatch."));
+			throw std::runtime_error(FileReadError(filePath, "HMAP CRC mismatch."));
+	}
+
+	struct TileIndexEntry
+	{
+		uint32_t Offset = 0; // relative to the first tile
+		uint32_t Size = 0;
+		uint32_t Crc = 0;
+	};
+
+	inline static TileGrid DecodeTileGrid(const std::string& filePath, const uint8_t* tileHeader, const JTF_Head& header)
+	{
+		if (header.Layout != JTF_Layout::Tiled || header.Compression != JTF_Compression::None)
+			throw std::runtime_error(FileReadError(filePath, "HTIL chunk in linear or compressed file."));
+		if (!IsSupportedBitDepth(header.BitDepth))
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HTIL chunk, expected [8], [16], [32] or [64] got [{}].", header.BitDepth)));
+
+		uint16_t tileSize = ReadUInt16_LittleEndian(tileHeader);
+		if (tileSize < TILE_SIZE_MIN || tileSize > TILE_SIZE_MAX)
+			throw std::runtime_error(FileReadError(filePath, std::format("Invalid HTIL tile size, expected [{}..{}] got [{}].", TILE_SIZE_MIN, TILE_SIZE_MAX, tileSize)));
+
+		TileGrid grid = TileGrid::Create(header.Width, header.Height, tileSize);
+		if (ReadUInt16_LittleEndian(tileHeader + 2) != grid.TilesX || ReadUInt16_LittleEndian(tileHeader + 4) != grid.TilesY)
+			throw std::runtime_error(FileReadError(filePath, "HTIL tile count does not match (width, height, tile size) requirement."));
+		return grid;
+	}
+
+	inline static TileIndexEntry DecodeTileIndexEntry(const std::string& filePath, const uint8_t* index, const TileGrid& grid, size_t tile, uint8_t bitDepth, size_t tileDataSize)
+	{
+		const uint8_t* pointer = index + tile * HTIL_INDEX_ENTRY_SIZE;
+		TileIndexEntry entry{ ReadUInt32_LittleEndian(pointer), ReadUInt32_LittleEndian(pointer + 4), ReadUInt32_LittleEndian(pointer + 8) };
+
+		uint32_t tileX = static_cast<uint32_t>(tile % grid.TilesX);
+		uint32_t tileY = static_cast<uint32_t>(tile / grid.TilesX);
+		if (entry.Size != uint64_t(grid.TileWidth(tileX)) * grid.TileHeight(tileY) * (bitDepth / 8) || uint64_t(entry.Offset) + entry.Size > tileDataSize)
+			throw std::runtime_error(FileReadError(filePath, std::format("HTIL tile index entry [{}] corrupted.", tile)));
+		return entry;
+	}
+
+	template<typename T> inline static void DecodeTiles(const std::string& filePath, const uint8_t* payload, size_t payloadSize, const JTF_Head& header, T* samples, uint32_t threadCount)
+	{
+		if (payloadSize < HTIL_HEADER_SIZE)
+			throw std::runtime_error(FileReadError(filePath, "HTIL payload size does not match tile header requirement."));
+		TileGrid grid = DecodeTileGrid(filePath, payload, header);
+		if (payloadSize < grid.IndexSize())
+			throw std::runtime_error(FileReadError(filePath, "HTIL payload size does not match tile index requirement."));
+
+		const uint8_t* index = payload + HTIL_HEADER_SIZE;
+		const uint8_t* tileData = payload + grid.IndexSize();
+		size_t tileDataSize = payloadSize - grid.IndexSize();
+		size_t sampleSize = header.BitDepth / 8;
+
+		// tiles cover disjoint rectangles, runs of tiles decode in parallel
+		StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+		size_t tileBytes = size_t(grid.TileSize) * grid.TileSize * sampleSize;
+		ParallelForBands(grid.TileCount(), PARALLEL_MIN_SLICE_SIZE / tileBytes, threadCount, [&](size_t tileBegin, size_t tileEnd)
+			{
+				for (size_t tile = tileBegin; tile < tileEnd; ++tile)
+				{
+					TileIndexEntry entry = DecodeTileIndexEntry(filePath, index, grid, tile, header.BitDepth, tileDataSize);
+
+					uint32_t tileX = static_cast<uint32_t>(tile % grid.TilesX);
+					uint32_t tileY = static_cast<uint32_t>(tile / grid.TilesX);
+					uint32_t tileWidth = grid.TileWidth(tileX);
+					T* destination = samples + size_t(tileY) * grid.TileSize * header.Width + size_t(tileX) * grid.TileSize;
+					for (uint32_t row = 0; row < grid.TileHeight(tileY); ++row)
+						DecodeSamples_LittleEndian(tileData + entry.Offset + size_t(row) * tileWidth * sampleSize, tileWidth, header.BitDepth, destination + size_t(row) * header.Width);
+				}
+			});
 	}
 
-	void JTFFile::ReadFileCrc(const std::string& filePath, std::ifstream& file, Crc32& fileCrc)
+	inline static void ReadVerifiedPayload(const std::string& filePath, std::istream& file, uint32_t chunkType, uint32_t payloadSize, Crc32& fileCrc, std::vector<uint8_t>& payload, uint32_t threadCount)
 	{
+		Crc32 chunkCrc;
+
+		const uint8_t chunkTypeName[4] = { uint8_t(chunkType), uint8_t(chunkType >> 8), uint8_t(chunkType >> 16), uint8_t(chunkType >> 24) };
+		AppendToCrc(chunkTypeName, 4, { &chunkCrc });
+
+		ResizeTracked(payload, payloadSize);
+		ReadToBuffer(filePath, file, payload.data(), payloadSize);
+		AppendToCrcParallel(payload.data(), payloadSize, chunkCrc, threadCount);
+
 		// read expected chunk crc
 		uint8_t expectedCrcBytes[4];
 		ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
+		AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &fileCrc });
 		uint32_t expectedCrc = ReadUInt32_LittleEndian(expectedCrcBytes);
 
-		uint32_t computedCrc = fileCrc.GetCurrentHashAsUInt32();
+		// crc compare
+		uint32_t computedCrc = chunkCrc.GetCurrentHashAsUInt32();
 		if (expectedCrc != computedCrc)
-			throw std::runtime_error(FileReadError(filePath, "File CRC mismatch."));
+			throw std::runtime_error(FileReadError(filePath, std::format("{} CRC mismatch.", DecodeChunkID(chunkType))));
+	}
+
+	void JTFFile::ReadHtilChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_Heights& heights, uint32_t threadCount)
+	{
+		std::vector<uint8_t> payload;
+		ReadVerifiedPayload(filePath, file, CHUNK_ID_HTIL, payloadSize, fileCrc, payload, threadCount);
+		ResizeTracked(heights.HeightSamples, size_t(header.Width) * size_t(header.Height));
+		DecodeTiles(filePath, payload.data(), payloadSize, header, heights.HeightSamples.data(), threadCount);
+	}
+
+	void JTFFile::ReadHtilChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_NativeHeights& heights, uint32_t threadCount)
+	{
+		std::vector<uint8_t> payload;
+		ReadVerifiedPayload(filePath, file, CHUNK_ID_HTIL, payloadSize, fileCrc, payload, threadCount);
+		EmplaceNativeSamples(heights, header.BitDepth, [&](auto& samples)
+			{
+				ResizeTracked(samples, size_t(header.Width) * size_t(header.Height));
+				DecodeTiles(filePath, payload.data(), payloadSize, header, samples.data(), threadCount);
+			});
+	}
+
+	template<typename T> inline static void DecodeCompressed(const std::string& filePath, const std::vector<uint8_t>& payload, const JTF_Head& header, T* samples, uint32_t threadCount, std::vector<uint8_t>& scratch)
+	{
+		if (header.Layout != JTF_Layout::Linear || header.Compression != JTF_Compression::PredictiveLZ)
+			throw std::runtime_error(FileReadError(filePath, "HCMP chunk in uncompressed or tiled file."));
+		if (!IsSupportedBitDepth(header.BitDepth))
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HCMP chunk, expected [8], [16], [32] or [64] got [{}].", header.BitDepth)));
+
+		StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+		if (!HeightCodec::Decode(payload.data(), payload.size(), header.Width, header.Height, header.BitDepth, samples, threadCount, scratch))
+			throw std::runtime_error(FileReadError(filePath, "HCMP payload cannot be decoded."));
+	}
+
+	void JTFFile::ReadHcmpChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_Heights& heights, uint32_t threadCount)
+	{
+		std::vector<uint8_t> payload;
+		std::vector<uint8_t> scratch;
+		ReadVerifiedPayload(filePath, file, CHUNK_ID_HCMP, payloadSize, fileCrc, payload, threadCount);
+		ResizeTracked(heights.HeightSamples, size_t(header.Width) * size_t(header.Height));
+		DecodeCompressed(filePath, payload, header, heights.HeightSamples.data(), threadCount, scratch);
+	}
+
+	void JTFFile::ReadHcmpChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, JTF_NativeHeights& heights, uint32_t threadCount)
+	{
+		std::vector<uint8_t> payload;
+		std::vector<uint8_t> scratch;
+		ReadVerifiedPayload(filePath, file, CHUNK_ID_HCMP, payloadSize, fileCrc, payload, threadCount);
+		EmplaceNativeSamples(heights, header.BitDepth, [&](auto& samples)
+			{
+				ResizeTracked(samples, size_t(header.Width) * size_t(header.Height));
+				DecodeCompressed(filePath, payload, header, samples.data(), threadCount, scratch);
+			});
 	}
+
+	void JTFFile::ReadHtilRegion(const std::string& filePath, std::istream& file, uint32_t payloadSize, JTF_Region& region)
+	{
+		const JTF_Head& header = region.Header;
+
+		if (payloadSize < HTIL_HEADER_SIZE)
+			throw std::runtime_error(FileReadError(filePath, "HTIL payload size does not match tile header requirement."));
+		uint8_t tileHeader[HTIL_HEADER_SIZE];
+		ReadToBuffer(filePath, file, tileHeader, sizeof(tileHeader));
+		TileGrid grid = DecodeTileGrid(filePath, tileHeader, header);
+		if (payloadSize < grid.IndexSize())
+			throw std::runtime_error(FileReadError(filePath, "HTIL payload size does not match tile index requirement."));
+
+		std::vector<uint8_t> index(grid.TileCount() * HTIL_INDEX_ENTRY_SIZE);
+		ReadToBuffer(filePath, file, index.data(), index.size());
+		std::streamoff tileDataStart = file.tellg();
+		size_t tileDataSize = payloadSize - grid.IndexSize();
+		size_t sampleSize = header.BitDepth / 8;
+
+		uint32_t tileX0 = region.X / grid.TileSize;
+		uint32_t tileX1 = (uint32_t(region.X) + region.Width - 1) / grid.TileSize;
+		uint32_t tileY0 = region.Y / grid.TileSize;
+		uint32_t tileY1 = (uint32_t(region.Y) + region.Height - 1) / grid.TileSize;
+
+		region.Heights.HeightSamples.resize(size_t(region.Width) * size_t(region.Height));
+
+		std::vector<TileIndexEntry> entries(tileX1 - tileX0 + 1);
+		std::vector<uint8_t> tiles;
+		for (uint32_t tileY = tileY0; tileY <= tileY1; ++tileY)
+		{
+			// overlapping tiles of a tile row are read as one span
+			uint32_t spanBegin = UINT32_MAX;
+			uint32_t spanEnd = 0;
+			for (uint32_t tileX = tileX0; tileX <= tileX1; ++tileX)
+			{
+				TileIndexEntry& entry = entries[tileX - tileX0];
+				entry = DecodeTileIndexEntry(filePath, index.data(), grid, size_t(tileY) * grid.TilesX + tileX, header.BitDepth, tileDataSize);
+				spanBegin = std::min(spanBegin, entry.Offset);
+				spanEnd = std::max(spanEnd, entry.Offset + entry.Size);
+			}
+
+			tiles.resize(spanEnd - spanBegin);
+			file.seekg(tileDataStart + static_cast<std::streamoff>(spanBegin));
+			if (!file)
+				throw std::runtime_error(FileReadError(filePath, "Unexpected EOF while seeking tile."));
+			ReadToBuffer(filePath, file, tiles.data(), tiles.size());
+
+			uint32_t tileTop = tileY * grid.TileSize;
+			uint32_t rowBegin = std::max<uint32_t>(region.Y, tileTop);
+			uint32_t rowEnd = std::min<uint32_t>(uint32_t(region.Y) + region.Height, tileTop + grid.TileHeight(tileY));
+			for (uint32_t tileX = tileX0; tileX <= tileX1; ++tileX)
+			{
+				const TileIndexEntry& entry = entries[tileX - tileX0];
+				const uint8_t* tile = tiles.data() + (entry.Offset - spanBegin);
+				if (Crc32::Hash(tile, entry.Size) != entry.Crc)
+					throw std::runtime_error(FileReadError(filePath, std::format("HTIL tile [{}, {}] CRC mismatch.", tileX, tileY)));
+
+				uint32_t tileLeft = tileX * grid.TileSize;
+				uint32_t tileWidth = grid.TileWidth(tileX);
+				uint32_t columnBegin = std::max<uint32_t>(region.X, tileLeft);
+				uint32_t columnEnd = std::min<uint32_t>(uint32_t(region.X) + region.Width, tileLeft + tileWidth);
+				for (uint32_t row = rowBegin; row < rowEnd; ++row)
+				{
+					const uint8_t* source = tile + (size_t(row - tileTop) * tileWidth + (columnBegin - tileLeft)) * sampleSize;
+					double* destination = region.Heights.HeightSamples.data() + size_t(row - region.Y) * region.Width + (columnBegin - region.X);
+					DecodeSamples_LittleEndian(source, columnEnd - columnBegin, header.BitDepth, destination);
+				}
+			}
+		}
+	}
+
+	JTF_Region JTFFile::ReadRegion(const std::string& filePath, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+	{
+		return ReadRegion(filePath, x, y, width, height, JTF_ReadOptions{});
+	}
+
+	JTF_Region JTFFile::ReadRegion(const std::string& filePath, uint16_t x, uint16_t y, uint16_t width, uint16_t height, const JTF_ReadOptions& options)
+	{
+		StatsScope scope(options.Stats);
+		JTF_Region region;
+		region.X = x;
+		region.Y = y;
+		region.Width = width;
+		region.Height = height;
+
+		// file existance check
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		ReadValidateSignature(filePath, file);
+
+		// read chunks up to the height chunk, skip the rest for the file CRC over the stored chunk CRCs
+		Crc32 fileCrc;
+		bool headRead = false;
+		bool heightsRead = false;
+		while (true)
+		{
+			// read chunk length
+			uint8_t payloadSizeBytes[4];
+			ReadToBuffer(filePath, file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+			uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+			// read chunk type
+			uint32_t chunkType = ReadChunkType(filePath, file);
+
+			if (chunkType != CHUNK_ID_HEAD && !headRead)
+				throw std::runtime_error(FileReadError(filePath, std::format("{} chunk precedes HEAD chunk.", DecodeChunkID(chunkType))));
+
+			switch (chunkType)
+			{
+				case CHUNK_ID_HEAD:
+				{
+					ReadHeadChunk(filePath, file, payloadSize, fileCrc, region.Header);
+					headRead = true;
+					if (width == 0 || height == 0 || uint32_t(x) + width > region.Header.Width || uint32_t(y) + height > region.Header.Height)
+						throw std::out_of_range(std::format("[JTF Read Error] '{}' Region [{}, {}, {}x{}] outside of [{}x{}] map.\n", filePath, x, y, width, height, region.Header.Width, region.Header.Height));
+					break;
+				}
+
+				case CHUNK_ID_HMAP:
+				case CHUNK_ID_HCMP:
+				{
+					// linear layout, the chunk is read and verified as a whole and then cropped
+					JTF_Heights heights;
+					if (chunkType == CHUNK_ID_HMAP)
+						ReadHmapChunk(filePath, file, payloadSize, fileCrc, region.Header, heights, options.ThreadCount);
+					else
+						ReadHcmpChunk(filePath, file, payloadSize, fileCrc, region.Header, heights, options.ThreadCount);
+					ResizeTracked(region.Heights.HeightSamples, size_t(width) * size_t(height));
+					for (uint32_t row = 0; row < height; ++row)
+						std::copy_n(heights.HeightSamples.begin() + (size_t(y) + row) * region.Header.Width + x, width, region.Heights.HeightSamples.begin() + size_t(row) * width);
+					heightsRead = true;
+					break;
+				}
+
+				case CHUNK_ID_HTIL:
+				{
+					// tiles outside the region stay unread, each read tile is verified by its own CRC
+					std::streamoff payloadStart = file.tellg();
+					ReadHtilRegion(filePath, file, payloadSize, region);
+					file.seekg(payloadStart + static_cast<std::streamoff>(payloadSize));
+					if (!file)
+						throw std::runtime_error(FileReadError(filePath, "Unexpected EOF while skipping payload."));
+					uint8_t expectedCrcBytes[4];
+					ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
+					AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &fileCrc });
+					heightsRead = true;
+					break;
+				}
+
+				case CHUNK_ID_HLOD:
+				case CHUNK_ID_HQDT:
+				case CHUNK_ID_HDIR:
+					SkipChunk(filePath, file, payloadSize, fileCrc);
+					break;
+
+				case CHUNK_ID_FEND:
+					if (!heightsRead)
+						throw std::runtime_error(FileReadError(filePath, "Missing HMAP, HTIL or HCMP chunk."));
+					ReadFendChunk(filePath, file, payloadSize, fileCrc);
+					ReadFileCrc(filePath, file, fileCrc);
+					return region;
+
+				default:
+					throw std::runtime_error(FileReadError(filePath, std::format("Unknown chunk type '{}'.", DecodeChunkID(chunkType))));
+			}
+		}
+	}
+
+	void JTFFile::ReadHlodLevel(const std::string& filePath, std::istream& file, uint32_t payloadSize, JTF_Lod& lod)
+	{
+		const JTF_Head& header = lod.Header;
+		if (!IsSupportedBitDepth(header.BitDepth))
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HLOD chunk, expected [8], [16], [32] or [64] got [{}].", header.BitDepth)));
+		if (payloadSize < HLOD_HEADER_SIZE)
+			throw std::runtime_error(FileReadError(filePath, "HLOD payload size does not match level header requirement."));
+
+		uint8_t levelHeader[HLOD_HEADER_SIZE];
+		ReadToBuffer(filePath, file, levelHeader, sizeof(levelHeader));
+		uint16_t levelCount = ReadUInt16_LittleEndian(levelHeader);
+		if (levelCount == 0 || levelCount > LOD_LEVEL_LIMIT || LodLevelCount(header.Width, header.Height, static_cast<uint8_t>(levelCount)) != levelCount)
+			throw std::runtime_error(FileReadError(filePath, std::format("HLOD level count [{}] does not match [{}x{}] map.", levelCount, header.Width, header.Height)));
+
+		size_t indexSize = HLOD_HEADER_SIZE + size_t(levelCount) * HLOD_INDEX_ENTRY_SIZE;
+		if (payloadSize < indexSize)
+			throw std::runtime_error(FileReadError(filePath, "HLOD payload size does not match level index requirement."));
+
+		uint8_t index[LOD_LEVEL_LIMIT * HLOD_INDEX_ENTRY_SIZE];
+		ReadToBuffer(filePath, file, index, indexSize - HLOD_HEADER_SIZE);
+		lod.LevelCount = static_cast<uint8_t>(levelCount);
+
+		// every entry is checked against the halved extents, a damaged index fails level 0 reads as well
+		uint16_t levelWidth = header.Width;
+		uint16_t levelHeight = header.Height;
+		for (uint16_t level = 1; level <= levelCount; ++level)
+		{
+			levelWidth = LodLevelSize(levelWidth);
+			levelHeight = LodLevelSize(levelHeight);
+			const uint8_t* entry = index + size_t(level - 1) * HLOD_INDEX_ENTRY_SIZE;
+			uint64_t size = ReadUInt32_LittleEndian(entry + 8);
+			if (ReadUInt16_LittleEndian(entry) != levelWidth || ReadUInt16_LittleEndian(entry + 2) != levelHeight
+				|| size != uint64_t(levelWidth) * levelHeight * (header.BitDepth / 8) || ReadUInt32_LittleEndian(entry + 4) + size > payloadSize - indexSize)
+				throw std::runtime_error(FileReadError(filePath, std::format("HLOD level index entry [{}] corrupted.", level)));
+		}
+
+		// full resolution follows in the height chunk, skip the levels and the chunk CRC
+		if (lod.Level == 0)
+		{
+			file.seekg(static_cast<std::streamoff>(payloadSize - indexSize + 4), std::ios::cur);
+			if (!file)
+				throw std::runtime_error(FileReadError(filePath, "Unexpected EOF while skipping payload."));
+			return;
+		}
+
+		if (lod.Level > levelCount)
+			throw std::out_of_range(std::format("[JTF Read Error] '{}' LOD level [{}] not stored, file holds [{}] levels.\n", filePath, lod.Level, levelCount));
+
+		uint16_t width = header.Width;
+		uint16_t height = header.Height;
+		for (uint8_t level = 0; level < lod.Level; ++level)
+		{
+			width = LodLevelSize(width);
+			height = LodLevelSize(height);
+		}
+
+		const uint8_t* entry = index + size_t(lod.Level - 1) * HLOD_INDEX_ENTRY_SIZE;
+		uint32_t offset = ReadUInt32_LittleEndian(entry + 4);
+		uint32_t size = ReadUInt32_LittleEndian(entry + 8);
+		size_t sampleCount = size_t(width) * height;
+
+		// levels are stored finest first, seek past the finer ones
+		file.seekg(static_cast<std::streamoff>(offset), std::ios::cur);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Unexpected EOF while seeking level."));
+		std::vector<uint8_t> levelData;
+		ResizeTracked(levelData, size);
+		ReadToBuffer(filePath, file, levelData.data(), size);
+		if (Crc32::Hash(levelData.data(), size) != ReadUInt32_LittleEndian(entry + 12))
+			throw std::runtime_error(FileReadError(filePath, std::format("HLOD level [{}] CRC mismatch.", lod.Level)));
+
+		lod.Width = width;
+		lod.Height = height;
+		lod.Heights.HeightSamples.resize(sampleCount);
+		DecodeSamples_LittleEndian(levelData.data(), sampleCount, header.BitDepth, lod.Heights.HeightSamples.data());
+	}
+
+	JTF_Lod JTFFile::ReadLod(const std::string& filePath, uint8_t level)
+	{
+		return ReadLod(filePath, level, JTF_ReadOptions{});
+	}
+
+	JTF_Lod JTFFile::ReadLod(const std::string& filePath, uint8_t level, const JTF_ReadOptions& options)
+	{
+		StatsScope scope(options.Stats);
+		JTF_Lod lod;
+		lod.Level = level;
+
+		// file existance check
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		ReadValidateSignature(filePath, file);
+
+		// read chunks up to the requested level, 'HLOD' precedes the height chunk
+		Crc32 fileCrc;
+		bool headRead = false;
+		while (true)
+		{
+			// read chunk length
+			uint8_t payloadSizeBytes[4];
+			ReadToBuffer(filePath, file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+			uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+			// read chunk type
+			uint32_t chunkType = ReadChunkType(filePath, file);
+
+			if (chunkType != CHUNK_ID_HEAD && !headRead)
+				throw std::runtime_error(FileReadError(filePath, std::format("{} chunk precedes HEAD chunk.", DecodeChunkID(chunkType))));
+
+			switch (chunkType)
+			{
+				case CHUNK_ID_HEAD:
+					ReadHeadChunk(filePath, file, payloadSize, fileCrc, lod.Header);
+					headRead = true;
+					lod.Width = lod.Header.Width;
+					lod.Height = lod.Header.Height;
+					break;
+
+				case CHUNK_ID_HLOD:
+					ReadHlodLevel(filePath, file, payloadSize, lod);
+					if (level > 0)
+						return lod;
+					break;
+
+				case CHUNK_ID_HQDT:
+				case CHUNK_ID_HDIR:
+					SkipChunk(filePath, file, payloadSize, fileCrc);
+					break;
+
+				case CHUNK_ID_HMAP:
+				case CHUNK_ID_HTIL:
+				case CHUNK_ID_HCMP:
+				{
+					// written without levels
+					if (level > 0)
+						throw std::out_of_range(std::format("[JTF Read Error] '{}' LOD level [{}] not stored, file holds [0] levels.\n", filePath, level));
+
+					// full resolution
+					if (chunkType == CHUNK_ID_HMAP)
+						ReadHmapChunk(filePath, file, payloadSize, fileCrc, lod.Header, lod.Heights, options.ThreadCount);
+					else if (chunkType == CHUNK_ID_HTIL)
+						ReadHtilChunk(filePath, file, payloadSize, fileCrc, lod.Header, lod.Heights, options.ThreadCount);
+					else
+						ReadHcmpChunk(filePath, file, payloadSize, fileCrc, lod.Header, lod.Heights, options.ThreadCount);
+					return lod;
+				}
+
+				case CHUNK_ID_FEND:
+					throw std::runtime_error(FileReadError(filePath, "Missing HMAP, HTIL or HCMP chunk."));
+
+				default:
+					throw std::runtime_error(FileReadError(filePath, std::format("Unknown chunk type '{}'.", DecodeChunkID(chunkType))));
+			}
+		}
+	}
+
+	JTF_HeightTree JTFFile::ReadHeightTree(const std::string& filePath)
+	{
+		return ReadHeightTree(filePath, JTF_ReadOptions{});
+	}
+
+	JTF_HeightTree JTFFile::ReadHeightTree(const std::string& filePath, const JTF_ReadOptions& options)
+	{
+		StatsScope scope(options.Stats);
+
+		// file existance check
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		ReadValidateSignature(filePath, file);
+
+		// read chunks up to the tree, 'HQDT' precedes the height chunk
+		JTF_Head header;
+		Crc32 fileCrc;
+		bool headRead = false;
+		while (true)
+		{
+			// read chunk length
+			uint8_t payloadSizeBytes[4];
+			ReadToBuffer(filePath, file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+			uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+			// read chunk type
+			uint32_t chunkType = ReadChunkType(filePath, file);
+
+			if (chunkType != CHUNK_ID_HEAD && !headRead)
+				throw std::runtime_error(FileReadError(filePath, std::format("{} chunk precedes HEAD chunk.", DecodeChunkID(chunkType))));
+
+			switch (chunkType)
+			{
+				case CHUNK_ID_HEAD:
+					ReadHeadChunk(filePath, file, payloadSize, fileCrc, header);
+					headRead = true;
+					break;
+
+				case CHUNK_ID_HLOD:
+				case CHUNK_ID_HDIR:
+					SkipChunk(filePath, file, payloadSize, fileCrc);
+					break;
+
+				case CHUNK_ID_HQDT:
+				{
+					if (!IsSupportedBitDepth(header.BitDepth))
+						throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HQDT chunk, expected [8], [16], [32] or [64] got [{}].", header.BitDepth)));
+					if (payloadSize < HQDT_HEADER_SIZE)
+						throw std::runtime_error(FileReadError(filePath, "HQDT payload size does not match tree header requirement."));
+
+					std::vector<uint8_t> payload;
+					ReadVerifiedPayload(filePath, file, CHUNK_ID_HQDT, payloadSize, fileCrc, payload, options.ThreadCount);
+
+					JTF_HeightTree tree;
+					tree.Width = header.Width;
+					tree.Height = header.Height;
+					tree.LeafSize = ReadUInt16_LittleEndian(payload.data());
+					uint16_t levelCount = ReadUInt16_LittleEndian(payload.data() + 2);
+					if (tree.LeafSize < HEIGHT_TREE_LEAF_MIN || tree.LeafSize > HEIGHT_TREE_LEAF_MAX)
+						throw std::runtime_error(FileReadError(filePath, std::format("HQDT leaf size [{}] outside of [{}..{}].", tree.LeafSize, HEIGHT_TREE_LEAF_MIN, HEIGHT_TREE_LEAF_MAX)));
+
+					// level extents follow from the map size and leaf size
+					std::vector<std::pair<uint16_t, uint16_t>> sizes = HeightTreeLevelSizes(header.Width, header.Height, tree.LeafSize);
+					size_t sampleSize = header.BitDepth / 8;
+					size_t expectedSize = HQDT_HEADER_SIZE;
+					for (const auto& [cellsX, cellsY] : sizes)
+						expectedSize += size_t(cellsX) * cellsY * 2 * sampleSize;
+					if (levelCount != sizes.size() || payloadSize != expectedSize)
+						throw std::runtime_error(FileReadError(filePath, std::format("HQDT payload does not match [{}x{}] map with leaf size [{}].", header.Width, header.Height, tree.LeafSize)));
+
+					StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+					const uint8_t* source = payload.data() + HQDT_HEADER_SIZE;
+					tree.Levels.resize(sizes.size());
+					for (size_t level = 0; level < sizes.size(); ++level)
+					{
+						JTF_HeightTreeLevel& cells = tree.Levels[level];
+						cells.CellsX = sizes[level].first;
+						cells.CellsY = sizes[level].second;
+						cells.Bounds.resize(size_t(cells.CellsX) * cells.CellsY * 2);
+						DecodeSamples_LittleEndian(source, cells.Bounds.size(), header.BitDepth, cells.Bounds.data());
+						source += cells.Bounds.size() * sampleSize;
+					}
+					return tree;
+				}
+
+				case CHUNK_ID_HMAP:
+				case CHUNK_ID_HTIL:
+				case CHUNK_ID_HCMP:
+				case CHUNK_ID_FEND:
+					throw std::runtime_error(FileReadError(filePath, "File holds no HQDT height tree, write it with JTF_WriteOptions::HeightTreeLeafSize."));
+
+				default:
+					throw std::runtime_error(FileReadError(filePath, std::format("Unknown chunk type '{}'.", DecodeChunkID(chunkType))));
+			}
+		}
+	}
+
+	// staging used to convert between bit depths while reading into a caller buffer, bounds the memory to the stack
+	constexpr size_t HMAP_STAGING_SIZE = size_t(32) << 10;
+
+	template<typename T> inline static void ReadHmapInto(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc, const JTF_Head& header, T* samples, uint32_t threadCount)
+	{
+		if (header.Layout != JTF_Layout::Linear || header.Compression != JTF_Compression::None)
+			throw std::runtime_error(FileReadError(filePath, "HMAP chunk in tiled or compressed file."));
+		if (!IsSupportedBitDepth(header.BitDepth))
+			throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HMAP chunk, expected [8], [16], [32] or [64] got [{}].", header.BitDepth)));
+
+		size_t sampleCount = size_t(header.Width) * size_t(header.Height);
+		size_t sampleSize = header.BitDepth / 8;
+		if (payloadSize != sampleCount * sampleSize)
+			throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match (width * height * bitDepth / 8) requirement."));
+
+		Crc32 chunkCrc;
+
+		constexpr char expectedChunkTypeName[4] = { 'H','M','A','P' };
+		AppendToCrc(reinterpret_cast<const uint8_t*>(expectedChunkTypeName), 4, { &chunkCrc });
+
+		if (header.BitDepth == sizeof(T) * 8)
+			ReadSamples_LittleEndian(filePath, file, samples, sampleCount, chunkCrc, threadCount);
+		else
+		{
+			// widen or narrow pass by pass through a fixed staging buffer
+			alignas(8) uint8_t staging[HMAP_STAGING_SIZE];
+			size_t passSize = HMAP_STAGING_SIZE / sampleSize;
+			for (size_t begin = 0; begin < sampleCount; begin += passSize)
+			{
+				size_t count = std::min(passSize, sampleCount - begin);
+				ReadToBuffer(filePath, file, staging, count * sampleSize);
+				AppendToCrc(staging, count * sampleSize, { &chunkCrc });
+				StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+				DecodeSamples_LittleEndian(staging, count, header.BitDepth, samples + begin);
+			}
+		}
+
+		// read expected chunk crc
+		uint8_t expectedCrcBytes[4];
+		ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
+		AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &fileCrc });
+		uint32_t expectedCrc = ReadUInt32_LittleEndian(expectedCrcBytes);
+
+		// crc compare
+		uint32_t computedCrc = chunkCrc.GetCurrentHashAsUInt32();
+		if (expectedCrc != computedCrc)
+			throw std::runtime_error(FileReadError(filePath, "HMAP CRC mismatch."));
+	}
+
+	JTF_Head JTFFile::ReadHeader(const std::string& filePath)
+	{
+		JTF_Head header;
+
+		// file existance check
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		ReadValidateSignature(filePath, file);
+
+		// read chunk length
+		uint8_t payloadSizeBytes[4];
+		ReadToBuffer(filePath, file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+		uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+		// read chunk type
+		uint32_t chunkType = ReadChunkType(filePath, file);
+		if (chunkType != CHUNK_ID_HEAD)
+			throw std::runtime_error(FileReadError(filePath, std::format("{} chunk precedes HEAD chunk.", DecodeChunkID(chunkType))));
+
+		Crc32 fileCrc;
+		ReadHeadChunk(filePath, file, payloadSize, fileCrc, header);
+		return header;
+	}
+
+	// read the fixed-size file prefix with one positioned read, returns the bytes read
+	inline static size_t ReadFilePrefix(const std::string& filePath, uint8_t* destination, size_t size)
+	{
+#if defined(_WIN32)
+		HANDLE file = CreateFileW(std::filesystem::path(filePath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		DWORD read = 0;
+		BOOL success = ReadFile(file, destination, static_cast<DWORD>(size), &read, nullptr);
+		CloseHandle(file);
+		if (!success)
+			throw std::runtime_error(FileReadError(filePath, "Cannot read file."));
+		return read;
+#else
+		int file = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		ssize_t read;
+		do read = ::pread(file, destination, size, 0);
+		while (read < 0 && errno == EINTR);
+		::close(file);
+		if (read < 0)
+			throw std::runtime_error(FileReadError(filePath, "Cannot read file."));
+		return static_cast<size_t>(read);
+#endif
+	}
+
+	// verify signature and 'HEAD' chunk of a file prefix and decode the header
+	inline static void DecodeHeadPrefix(const std::string& filePath, const uint8_t* prefix, size_t size, JTF_Head& header)
+	{
+		if (size < sizeof(JTF_SIGNATURE))
+			throw std::runtime_error(FileReadError(filePath, "Unexpected EOF."));
+		if (!VerifySignature(prefix))
+			throw std::runtime_error(FileReadError(filePath, "Invalid file signature."));
+		if (size < HEAD_PREFIX_SIZE)
+			throw std::runtime_error(FileReadError(filePath, "Unexpected EOF."));
+
+		const uint8_t* frame = prefix + sizeof(JTF_SIGNATURE);
+		uint32_t payloadSize = ReadUInt32_LittleEndian(frame);
+		uint32_t chunkType = ReadUInt32_LittleEndian(frame + 4);
+		if (chunkType != CHUNK_ID_HEAD)
+			throw std::runtime_error(FileReadError(filePath, std::format("{} chunk precedes HEAD chunk.", DecodeChunkID(chunkType))));
+		if (payloadSize != HEAD_PAYLOAD_SIZE)
+			throw std::runtime_error(FileReadError(filePath, std::format("Invalid HEAD payload size, expected [32] got [{}].", payloadSize)));
+
+		// chunk CRC covers type and payload
+		const uint8_t* payload = frame + 8;
+		if (ReadUInt32_LittleEndian(payload + HEAD_PAYLOAD_SIZE) != Crc32::Hash(frame + 4, 4 + HEAD_PAYLOAD_SIZE))
+			throw std::runtime_error(FileReadError(filePath, "HEAD CRC mismatch."));
+
+		DecodeHeadPayload(payload, header);
+		ValidateHead(filePath, header);
+	}
+
+	JTF_HeaderScan JTFFile::ScanHeaders(const std::vector<std::string>& filePaths, const JTF_ReadOptions& options)
+	{
+		JTF_HeaderScan scan;
+		scan.FilePaths = filePaths;
+		scan.Headers.resize(filePaths.size());
+		scan.Errors.resize(filePaths.size());
+
+		// I/O latency dominates, so even small bands are worth a thread
+		std::atomic<size_t> failedCount = 0;
+		ParallelForBands(filePaths.size(), 16, options.ThreadCount, [&](size_t begin, size_t end)
+			{
+				uint8_t prefix[HEAD_PREFIX_SIZE];
+				for (size_t i = begin; i < end; ++i)
+				{
+					try
+					{
+						size_t size = ReadFilePrefix(filePaths[i], prefix, sizeof(prefix));
+						DecodeHeadPrefix(filePaths[i], prefix, size, scan.Headers[i]);
+					}
+					catch (const std::exception& e)
+					{
+						scan.Headers[i] = JTF_Head{};
+						scan.Errors[i] = e.what();
+						++failedCount;
+					}
+				}
+			});
+
+		scan.FailedCount = failedCount;
+		return scan;
+	}
+
+	JTF_HeaderScan JTFFile::ScanHeaders(const std::string& directory, bool recursive, const JTF_ReadOptions& options)
+	{
+		// collect .jtf files, any case of the extension
+		auto isJtf = [](const std::filesystem::directory_entry& entry)
+			{
+				std::error_code error;
+				if (!entry.is_regular_file(error))
+					return false;
+				std::string extension = entry.path().extension().string();
+				return extension.size() == 4 && std::equal(extension.begin(), extension.end(), ".JTF",
+					[](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == b; });
+			};
+
+		std::vector<std::string> filePaths;
+		std::error_code error;
+		if (recursive)
+		{
+			for (std::filesystem::recursive_directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied, error), end; !error && it != end; it.increment(error))
+				if (isJtf(*it))
+					filePaths.push_back(it->path().string());
+		}
+		else
+		{
+			for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+				if (isJtf(*it))
+					filePaths.push_back(it->path().string());
+		}
+		if (error)
+			throw std::runtime_error(std::format("[JTF Read Error] '{}' Cannot list directory ({}).\n", directory, error.message()));
+
+		std::sort(filePaths.begin(), filePaths.end());
+		return ScanHeaders(filePaths, options);
+	}
+
+	template<typename Resolve> JTF_Head JTFFile::ReadHeightsInto(const std::string& filePath, std::istream& file, uint32_t threadCount, std::vector<uint8_t>& payload, std::vector<uint8_t>& scratch, Resolve&& resolve)
+	{
+		JTF_Head header;
+		std::invoke_result_t<Resolve, const JTF_Head&> destination = nullptr;
+
+		ReadValidateSignature(filePath, file);
+
+		// read chunks
+		Crc32 fileCrc;
+		bool headRead = false;
+		bool heightsRead = false;
+		bool fendReached = false;
+		while (!fendReached)
+		{
+			// read chunk length
+			uint8_t payloadSizeBytes[4];
+			ReadToBuffer(filePath, file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+			uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+			// read chunk type
+			uint32_t chunkType = ReadChunkType(filePath, file);
+
+			if (chunkType != CHUNK_ID_HEAD && !headRead)
+				throw std::runtime_error(FileReadError(filePath, std::format("{} chunk precedes HEAD chunk.", DecodeChunkID(chunkType))));
+
+			switch (chunkType)
+			{
+				case CHUNK_ID_HEAD:
+					ReadHeadChunk(filePath, file, payloadSize, fileCrc, header);
+					headRead = true;
+					destination = resolve(header);
+					break;
+
+				case CHUNK_ID_HMAP:
+					ReadHmapInto(filePath, file, payloadSize, fileCrc, header, destination, threadCount);
+					heightsRead = true;
+					break;
+
+				case CHUNK_ID_HTIL:
+					ReadVerifiedPayload(filePath, file, CHUNK_ID_HTIL, payloadSize, fileCrc, payload, threadCount);
+					DecodeTiles(filePath, payload.data(), payloadSize, header, destination, threadCount);
+					heightsRead = true;
+					break;
+
+				case CHUNK_ID_HCMP:
+					ReadVerifiedPayload(filePath, file, CHUNK_ID_HCMP, payloadSize, fileCrc, payload, threadCount);
+					DecodeCompressed(filePath, payload, header, destination, threadCount, scratch);
+					heightsRead = true;
+					break;
+
+				case CHUNK_ID_HLOD:
+				case CHUNK_ID_HQDT:
+				case CHUNK_ID_HDIR:
+					SkipChunk(filePath, file, payloadSize, fileCrc);
+					break;
+
+				case CHUNK_ID_FEND:
+					ReadFendChunk(filePath, file, payloadSize, fileCrc);
+					fendReached = true;
+					break;
+
+				default:
+					throw std::runtime_error(FileReadError(filePath, std::format("Unknown chunk type '{}'.", DecodeChunkID(chunkType))));
+			}
+		}
+
+		ReadFileCrc(filePath, file, fileCrc);
+
+		if (!heightsRead)
+			throw std::runtime_error(FileReadError(filePath, "Missing HMAP, HTIL or HCMP chunk."));
+
+		return header;
+	}
+
+	template<typename T> JTF_Head JTFFile::ReadInto(const std::string& filePath, std::span<T> destination, const JTF_ReadOptions& options)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTFFile::ReadInto supports only float or double for T.");
+
+		// file existance check
+		StatsScope scope(options.Stats);
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		std::vector<uint8_t> payload; // tiled and compressed payloads only
+		std::vector<uint8_t> scratch;
+		return ReadHeightsInto(filePath, file, options.ThreadCount, payload, scratch, [&](const JTF_Head& header)
+			{
+				if (destination.size() < size_t(header.Width) * size_t(header.Height))
+					throw std::invalid_argument(std::format("[JTF Read Error] '{}' Buffer of [{}] samples cannot hold [{}x{}] map.\n", filePath, destination.size(), header.Width, header.Height));
+				return destination.data();
+			});
+	}
+
+	template<typename T> JTF_Head JTFFile::ReadInto(const std::string& filePath, std::span<T> destination)
+	{
+		return ReadInto(filePath, destination, JTF_ReadOptions{});
+	}
+
+	template<typename T> JTF_Head JTFFile::ReadElevationsInto(const std::string& filePath, std::span<T> destination, double scale, double offset, const JTF_ReadOptions& options)
+	{
+		StatsScope scope(options.Stats);
+		JTF_Head header = ReadInto(filePath, destination, JTF_ReadOptions{ options.ThreadCount });
+
+		std::span<T> samples = destination.first(size_t(header.Width) * size_t(header.Height));
+		Denormalize<T>(samples, header.BoundsLower, header.BoundsUpper, samples, scale, offset, options.ThreadCount);
+		return header;
+	}
+
+	template<typename T> void JTFFile::Denormalize(std::span<const T> normalized, int32_t boundsLower, int32_t boundsUpper, std::span<T> elevations, double scale, double offset, uint32_t threadCount)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTFFile::Denormalize supports only float or double for T.");
+		if (elevations.size() != normalized.size())
+			throw std::invalid_argument(std::format("[JTF Convert Error] Destination of [{}] samples does not match [{}] source samples.\n", elevations.size(), normalized.size()));
+
+		// one multiply and add per sample
+		double range = double(boundsUpper) - double(boundsLower);
+		MapAffineParallel(normalized.data(), normalized.size(), range * scale, double(boundsLower) * scale + offset, elevations.data(), threadCount);
+	}
+
+	void JTFFile::ReadFendChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc)
+	{
+		if (payloadSize != 0)
+			throw std::runtime_error(FileReadError(filePath, std::format("Invalid FEND payload size, expected [0] got [{}].", payloadSize)));
+
+		Crc32 chunkCrc;
+
+		constexpr char expectedChunkTypeName[4] = { 'F','E','N','D' };
+		AppendToCrc(reinterpret_cast<const uint8_t*>(expectedChunkTypeName), 4, { &chunkCrc });
+
+		// read expected chunk crc
+		uint8_t expectedCrcBytes[4];
+		ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
+		AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &fileCrc });
+		uint32_t expectedCrc = ReadUInt32_LittleEndian(expectedCrcBytes);
+
+		uint32_t computedCrc = chunkCrc.GetCurrentHashAsUInt32();
+		if (expectedCrc != computedCrc)
+			throw std::runtime_error(FileReadError(filePath, "FEND CRC mismatch."));
+	}
+
+	void JTFFile::SkipChunk(const std::string& filePath, std::istream& file, uint32_t payloadSize, Crc32& fileCrc)
+	{
+		CountStat(&JTF_Stats::ChunksSkipped, 1);
+
+		// skip payload
+		if (payloadSize > 0)
+		{
+			StatsTimer timer(&JTF_Stats::IoNanoseconds);
+			file.seekg(static_cast<std::streamoff>(payloadSize), std::ios::cur);
+			if (!file)
+				throw std::runtime_error(FileReadError(filePath, "Unexpected EOF while skipping payload."));
+		}
+
+		// read expected chunk crc
+		uint8_t expectedCrcBytes[4];
+		ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
+		AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &fileCrc });
+	}
+
+	bool JTFFile::ReadHdirChunk(const std::string& filePath, std::istream& file, std::vector<JTF_ChunkEntry>& directory)
+	{
+		// 'HEAD' announces the directory, the tail of files without one is never probed
+		uint8_t headFrame[8];
+		file.seekg(static_cast<std::streamoff>(sizeof(JTF_SIGNATURE)));
+		ReadToBuffer(filePath, file, headFrame, sizeof(headFrame));
+		if (ReadUInt32_LittleEndian(headFrame + 4) != CHUNK_ID_HEAD)
+			throw std::runtime_error(FileReadError(filePath, "HEAD chunk missing after signature."));
+		JTF_Head header;
+		Crc32 headCrc;
+		ReadHeadChunk(filePath, file, ReadUInt32_LittleEndian(headFrame), headCrc, header);
+		if (!header.ChunkDirectory)
+			return false;
+
+		// from here on the file holds a directory, mismatches are corruption
+		// file tail: ['HDIR' length, type][entries][entry count][CRC]['FEND' length, type, CRC][file CRC]
+		file.seekg(0, std::ios::end);
+		uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+		if (!file || fileSize < sizeof(JTF_SIGNATURE) + CHUNK_FRAME_SIZE + HDIR_TRAILER_SIZE + FILE_TAIL_SIZE)
+			throw std::runtime_error(FileReadError(filePath, "Unexpected EOF, HDIR chunk missing."));
+
+		// one positioned read of the tail holds the directory of all but the largest chunk counts
+		uint8_t tail[HDIR_TAIL_READ_SIZE];
+		size_t tailSize = static_cast<size_t>(std::min<uint64_t>(fileSize - sizeof(JTF_SIGNATURE), HDIR_TAIL_READ_SIZE));
+		file.seekg(static_cast<std::streamoff>(fileSize - tailSize));
+		ReadToBuffer(filePath, file, tail, tailSize);
+
+		const uint8_t* fend = tail + tailSize - FILE_TAIL_SIZE;
+		if (ReadUInt32_LittleEndian(fend) != 0 || ReadUInt32_LittleEndian(fend + 4) != CHUNK_ID_FEND)
+			throw std::runtime_error(FileReadError(filePath, "FEND chunk missing at file end."));
+
+		uint64_t entryCount = ReadUInt32_LittleEndian(fend - 4 - HDIR_TRAILER_SIZE);
+		uint64_t payloadSize = entryCount * HDIR_ENTRY_SIZE + HDIR_TRAILER_SIZE;
+		uint64_t chunkSize = CHUNK_FRAME_SIZE + payloadSize;
+		if (sizeof(JTF_SIGNATURE) + chunkSize + FILE_TAIL_SIZE > fileSize)
+			throw std::runtime_error(FileReadError(filePath, std::format("HDIR entry count [{}] exceeds file size.", entryCount)));
+		uint64_t chunkOffset = fileSize - FILE_TAIL_SIZE - chunkSize;
+
+		// the chunk frame is verified before the entries are allocated, directories beyond the tail take a second read
+		uint8_t frame[8];
+		bool inTail = chunkSize + FILE_TAIL_SIZE <= tailSize;
+		if (inTail)
+			std::memcpy(frame, fend - chunkSize, sizeof(frame));
+		else
+		{
+			file.seekg(static_cast<std::streamoff>(chunkOffset));
+			ReadToBuffer(filePath, file, frame, sizeof(frame));
+		}
+		if (ReadUInt32_LittleEndian(frame) != payloadSize || ReadUInt32_LittleEndian(frame + 4) != CHUNK_ID_HDIR)
+			throw std::runtime_error(FileReadError(filePath, "HDIR chunk missing before FEND."));
+		CountStat(&JTF_Stats::ChunksVisited, 1);
+
+		std::vector<uint8_t> chunk;
+		ResizeTracked(chunk, static_cast<size_t>(chunkSize));
+		std::memcpy(chunk.data(), frame, sizeof(frame));
+		if (inTail)
+			std::memcpy(chunk.data() + sizeof(frame), fend - chunkSize + sizeof(frame), chunk.size() - sizeof(frame));
+		else
+			ReadToBuffer(filePath, file, chunk.data() + sizeof(frame), chunk.size() - sizeof(frame));
+
+		const uint8_t* directoryCrc = chunk.data() + 8 + payloadSize;
+		{
+			StatsTimer timer(&JTF_Stats::CrcNanoseconds);
+			if (Crc32::Hash(chunk.data() + 4, 4 + static_cast<size_t>(payloadSize)) != ReadUInt32_LittleEndian(directoryCrc))
+				throw std::runtime_error(FileReadError(filePath, "HDIR CRC mismatch."));
+			if (Crc32::Hash(fend + 4, 4) != ReadUInt32_LittleEndian(fend + 8))
+				throw std::runtime_error(FileReadError(filePath, "FEND CRC mismatch."));
+		}
+
+		// entries must tile the file from the signature up to the directory, 'HEAD' first
+		Crc32 fileCrc;
+		uint64_t expectedOffset = sizeof(JTF_SIGNATURE);
+		const uint8_t* source = chunk.data() + 8;
+		directory.resize(static_cast<size_t>(entryCount));
+		for (JTF_ChunkEntry& entry : directory)
+		{
+			entry.Type = ReadUInt32_LittleEndian(source);
+			entry.Length = ReadUInt32_LittleEndian(source + 4);
+			entry.Offset = ReadUInt64_LittleEndian(source + 8);
+			entry.Crc = ReadUInt32_LittleEndian(source + 16);
+			if (entry.Offset != expectedOffset)
+				throw std::runtime_error(FileReadError(filePath, "HDIR entries do not match chunk layout."));
+			expectedOffset += CHUNK_FRAME_SIZE + entry.Length;
+			AppendToCrc(source + 16, 4, { &fileCrc });
+			source += HDIR_ENTRY_SIZE;
+		}
+		if (directory.empty() || directory.front().Type != CHUNK_ID_HEAD || expectedOffset != chunkOffset)
+			throw std::runtime_error(FileReadError(filePath, "HDIR entries do not match chunk layout."));
+
+		// the file CRC covers the chunk CRCs in file order, the tail holds all of them now
+		AppendToCrc(directoryCrc, 4, { &fileCrc });
+		AppendToCrc(fend + 8, 4, { &fileCrc });
+		if (fileCrc.GetCurrentHashAsUInt32() != ReadUInt32_LittleEndian(fend + 12))
+			throw std::runtime_error(FileReadError(filePath, "File CRC mismatch."));
+		return true;
+	}
+
+	std::vector<JTF_ChunkEntry> JTFFile::ReadChunkDirectory(const std::string& filePath)
+	{
+		// file existance check
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		ReadValidateSignature(filePath, file);
+
+		std::vector<JTF_ChunkEntry> directory;
+		ReadHdirChunk(filePath, file, directory);
+		return directory;
+	}
+
+	void JTFFile::ReadFileCrc(const std::string& filePath, std::istream& file, Crc32& fileCrc)
+	{
+		// read expected chunk crc
+		uint8_t expectedCrcBytes[4];
+		ReadToBuffer(filePath, file, &expectedCrcBytes, sizeof(expectedCrcBytes));
+		uint32_t expectedCrc = ReadUInt32_LittleEndian(expectedCrcBytes);
+
+		uint32_t computedCrc = fileCrc.GetCurrentHashAsUInt32();
+		if (expectedCrc != computedCrc)
+			throw std::runtime_error(FileReadError(filePath, "File CRC mismatch."));
+	}
+
+
+	JTFStreamReader::JTFStreamReader(const std::string& filePath, bool verifyFileCrc) : m_filePath(filePath), m_verifyFileCrc(verifyFileCrc)
+	{
+		// file existance check
+		m_file.open(filePath, std::ios::binary);
+		if (!m_file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		JTFFile::ReadValidateSignature(filePath, m_file);
+
+		// read chunks up to the HMAP payload
+		bool headRead = false;
+		while (true)
+		{
+			// read chunk length
+			uint8_t payloadSizeBytes[4];
+			ReadToBuffer(filePath, m_file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+			uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+			// read chunk type
+			uint32_t chunkType = JTFFile::ReadChunkType(filePath, m_file);
+
+			if (chunkType == CHUNK_ID_HEAD)
+			{
+				JTFFile::ReadHeadChunk(filePath, m_file, payloadSize, m_fileCrc, m_header);
+				if (m_header.Layout != JTF_Layout::Linear || m_header.Compression != JTF_Compression::None)
+					throw std::runtime_error(std::format("[JTF Read Error] '{}' Row streaming requires uncompressed linear HMAP layout, use JTFFile::Read() or JTFFile::ReadRegion().\n", filePath));
+				headRead = true;
+				continue;
+			}
+
+			if ((chunkType == CHUNK_ID_HLOD || chunkType == CHUNK_ID_HQDT || chunkType == CHUNK_ID_HDIR) && headRead)
+			{
+				JTFFile::SkipChunk(filePath, m_file, payloadSize, m_fileCrc);
+				continue;
+			}
+
+			if (chunkType != CHUNK_ID_HMAP)
+				throw std::runtime_error(FileReadError(filePath, std::format("Unexpected chunk type '{}' before HMAP.", DecodeChunkID(chunkType))));
+			if (!headRead)
+				throw std::runtime_error(FileReadError(filePath, "HMAP chunk precedes HEAD chunk."));
+
+			if (!IsSupportedBitDepth(m_header.BitDepth))
+				throw std::runtime_error(FileReadError(filePath, std::format("Unsupported bit depth in HMAP chunk, expected [8], [16], [32] or [64] got [{}].", m_header.BitDepth)));
+			if (payloadSize != uint64_t(m_header.Width) * m_header.Height * (m_header.BitDepth / 8))
+				throw std::runtime_error(FileReadError(filePath, "HMAP payload size does not match (width * height * bitDepth / 8) requirement."));
+
+			constexpr char expectedChunkTypeName[4] = { 'H','M','A','P' };
+			AppendToCrc(reinterpret_cast<const uint8_t*>(expectedChunkTypeName), 4, { &m_chunkCrc });
+			break;
+		}
+	}
+
+	template<typename T> uint32_t JTFStreamReader::ReadRows(std::span<T> band)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint8_t>, "JTFStreamReader supports only float, double, uint16_t or uint8_t for T.");
+
+		// raw unsigned normalized samples are only handed out at their own bit depth
+		if constexpr (std::is_integral_v<T>)
+			if (m_header.BitDepth != sizeof(T) * 8)
+				throw std::invalid_argument(std::format("[JTF Read Error] '{}' Requested raw [{}] bit samples from [{}] bit map.\n", m_filePath, sizeof(T) * 8, m_header.BitDepth));
+
+		uint32_t rowCount = std::min<uint32_t>(static_cast<uint32_t>(std::min<size_t>(band.size() / m_header.Width, UINT32_MAX)), GetRowsRemaining());
+		if (rowCount == 0)
+		{
+			if (GetRowsRemaining() > 0)
+				throw std::invalid_argument(FileReadError(m_filePath, std::format("Band of [{}] samples cannot hold a row of width [{}].", band.size(), m_header.Width)));
+			return 0;
+		}
+
+		size_t sampleCount = size_t(rowCount) * m_header.Width;
+		size_t sampleSize = m_header.BitDepth / 8;
+		size_t byteCount = sampleCount * sampleSize;
+
+		if (sizeof(T) == sampleSize && std::endian::native == std::endian::little)
+		{
+			// native sample type, read straight into the band
+			uint8_t* bytes = reinterpret_cast<uint8_t*>(band.data());
+			ReadToBuffer(m_filePath, m_file, bytes, byteCount);
+			AppendToCrc(bytes, byteCount, { &m_chunkCrc });
+		}
+		else
+		{
+			m_staging.resize(std::max(m_staging.size(), byteCount));
+			ReadToBuffer(m_filePath, m_file, m_staging.data(), byteCount);
+			AppendToCrc(m_staging.data(), byteCount, { &m_chunkCrc });
+
+			DecodeSamples_LittleEndian(m_staging.data(), sampleCount, m_header.BitDepth, band.data());
+		}
+
+		m_rowsRead += rowCount;
+		if (GetRowsRemaining() == 0)
+			FinishChunk();
+
+		return rowCount;
+	}
+
+	void JTFStreamReader::FinishChunk()
+	{
+		// read expected chunk crc
+		uint8_t expectedCrcBytes[4];
+		ReadToBuffer(m_filePath, m_file, &expectedCrcBytes, sizeof(expectedCrcBytes));
+		AppendToCrc(expectedCrcBytes, sizeof(expectedCrcBytes), { &m_fileCrc });
+		uint32_t expectedCrc = ReadUInt32_LittleEndian(expectedCrcBytes);
+
+		// crc compare
+		uint32_t computedCrc = m_chunkCrc.GetCurrentHashAsUInt32();
+		if (expectedCrc != computedCrc)
+			throw std::runtime_error(FileReadError(m_filePath, "HMAP CRC mismatch."));
+
+		if (!m_verifyFileCrc) return;
+
+		// read chunk length
+		uint8_t payloadSizeBytes[4];
+		ReadToBuffer(m_filePath, m_file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+		uint32_t payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+
+		// read chunk type, the chunk directory sits between HMAP and FEND
+		uint32_t chunkType = JTFFile::ReadChunkType(m_filePath, m_file);
+		if (chunkType == CHUNK_ID_HDIR)
+		{
+			JTFFile::SkipChunk(m_filePath, m_file, payloadSize, m_fileCrc);
+			ReadToBuffer(m_filePath, m_file, &payloadSizeBytes, sizeof(payloadSizeBytes));
+			payloadSize = ReadUInt32_LittleEndian(payloadSizeBytes);
+			chunkType = JTFFile::ReadChunkType(m_filePath, m_file);
+		}
+		if (chunkType != CHUNK_ID_FEND)
+			throw std::runtime_error(FileReadError(m_filePath, std::format("Unexpected chunk type '{}' after HMAP.", DecodeChunkID(chunkType))));
+
+		JTFFile::ReadFendChunk(m_filePath, m_file, payloadSize, m_fileCrc);
+		JTFFile::ReadFileCrc(m_filePath, m_file, m_fileCrc);
+	}
+
+
+	// stream buffer of JTFReader, large enough for chunk headers and small payloads to be read in one call
+	constexpr size_t READER_IO_BUFFER_SIZE = size_t(64) << 10;
+
+	JTFReader::JTFReader(const JTF_ReadOptions& options) : m_options(options), m_ioBuffer(new char[READER_IO_BUFFER_SIZE])
+	{
+	}
+
+	template<typename Resolve> JTF_Head JTFReader::ReadFile(const std::string& filePath, Resolve&& resolve)
+	{
+		StatsScope scope(m_options.Stats);
+
+		// reopen the persistent stream, the I/O buffer has to be installed while it is closed
+		if (m_file.is_open())
+			m_file.close();
+		m_file.clear();
+		m_file.rdbuf()->pubsetbuf(m_ioBuffer.get(), READER_IO_BUFFER_SIZE);
+		m_file.open(filePath, std::ios::binary);
+		if (!m_file)
+			throw std::runtime_error(FileReadError(filePath, "Cannot open file for reading."));
+
+		JTF_Head header = JTFFile::ReadHeightsInto(filePath, m_file, m_options.ThreadCount, m_payload, m_scratch, std::forward<Resolve>(resolve));
+		m_file.close();
+		return header;
+	}
+
+	const JTF& JTFReader::Read(const std::string& filePath)
+	{
+		Read(filePath, m_data);
+		return m_data;
+	}
+
+	void JTFReader::Read(const std::string& filePath, JTF& data)
+	{
+		data.Header = ReadFile(filePath, [&](const JTF_Head& header)
+			{
+				ResizeTracked(data.Heights.HeightSamples, size_t(header.Width) * size_t(header.Height));
+				return data.Heights.HeightSamples.data();
+			});
+	}
+
+	template<typename T> JTF_Head JTFReader::ReadInto(const std::string& filePath, std::span<T> destination)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTFReader::ReadInto supports only float or double for T.");
+
+		return ReadFile(filePath, [&](const JTF_Head& header)
+			{
+				if (destination.size() < size_t(header.Width) * size_t(header.Height))
+					throw std::invalid_argument(std::format("[JTF Read Error] '{}' Buffer of [{}] samples cannot hold [{}x{}] map.\n", filePath, destination.size(), header.Width, header.Height));
+				return destination.data();
+			});
+	}
+
+
+	// Explicit template instantiations
+	template JTF_Head JTFReader::ReadInto<float>(const std::string&, std::span<float>);
+	template JTF_Head JTFReader::ReadInto<double>(const std::string&, std::span<double>);
+	template JTF_Head JTFFile::ReadInto<float>(const std::string&, std::span<float>);
+	template JTF_Head JTFFile::ReadInto<double>(const std::string&, std::span<double>);
+	template JTF_Head JTFFile::ReadInto<float>(const std::string&, std::span<float>, const JTF_ReadOptions&);
+	template JTF_Head JTFFile::ReadInto<double>(const std::string&, std::span<double>, const JTF_ReadOptions&);
+	template JTF_Head JTFFile::ReadElevationsInto<float>(const std::string&, std::span<float>, double, double, const JTF_ReadOptions&);
+	template JTF_Head JTFFile::ReadElevationsInto<double>(const std::string&, std::span<double>, double, double, const JTF_ReadOptions&);
+	template void JTFFile::Denormalize<float>(std::span<const float>, int32_t, int32_t, std::span<float>, double, double, uint32_t);
+	template void JTFFile::Denormalize<double>(std::span<const double>, int32_t, int32_t, std::span<double>, double, double, uint32_t);
+	template uint32_t JTFStreamReader::ReadRows<float>(std::span<float>);
+	template uint32_t JTFStreamReader::ReadRows<double>(std::span<double>);
+	template uint32_t JTFStreamReader::ReadRows<uint16_t>(std::span<uint16_t>);
+	template uint32_t JTFStreamReader::ReadRows<uint8_t>(std::span<uint8_t>);
 }
\ No newline at end of file
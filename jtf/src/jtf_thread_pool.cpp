@@ -0,0 +1,127 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#include "jtf_thread_pool.h"
+#include <algorithm>
+
+namespace cybex_interactive::jtf
+{
+	// index of the pool worker running on this thread, to keep nested submissions local
+	static thread_local const ThreadPool* t_pool = nullptr;
+	static thread_local size_t t_worker = 0;
+
+
+	ThreadPool::ThreadPool(uint32_t threadCount)
+	{
+		size_t count = threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+		m_queues.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+			m_queues.push_back(std::make_unique<TaskQueue>());
+
+		m_workers.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+			m_workers.emplace_back([this, i]() { Run(i); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		Wait();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_taskAvailable.notify_all();
+		for (std::thread& worker : m_workers)
+			worker.join();
+	}
+
+	void ThreadPool::Submit(std::function<void()> task)
+	{
+		size_t target;
+		if (t_pool == this)
+			target = t_worker;
+		else
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			target = m_nextQueue;
+			m_nextQueue = (m_nextQueue + 1) % m_queues.size();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_queues[target]->Mutex);
+			m_queues[target]->Tasks.push_back(std::move(task));
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_queued;
+			++m_pending;
+		}
+		m_taskAvailable.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_allDone.wait(lock, [this]() { return m_pending == 0; });
+	}
+
+	bool ThreadPool::TryTake(size_t self, std::function<void()>& task)
+	{
+		// own deque first, newest task
+		{
+			TaskQueue& own = *m_queues[self];
+			std::lock_guard<std::mutex> lock(own.Mutex);
+			if (!own.Tasks.empty())
+			{
+				task = std::move(own.Tasks.back());
+				own.Tasks.pop_back();
+				return true;
+			}
+		}
+
+		// steal the oldest task of another worker
+		for (size_t offset = 1; offset < m_queues.size(); ++offset)
+		{
+			TaskQueue& victim = *m_queues[(self + offset) % m_queues.size()];
+			std::lock_guard<std::mutex> lock(victim.Mutex);
+			if (!victim.Tasks.empty())
+			{
+				task = std::move(victim.Tasks.front());
+				victim.Tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::Run(size_t self)
+	{
+		t_pool = this;
+		t_worker = self;
+
+		std::function<void()> task;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_taskAvailable.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+				if (m_queued == 0)
+					return; // stopping and drained
+				--m_queued; // claim one task, it is taken below
+			}
+
+			// a claimed task is guaranteed to be in some deque, retry until this worker gets one
+			while (!TryTake(self, task))
+				std::this_thread::yield();
+
+			task();
+			task = nullptr;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_pending == 0)
+				m_allDone.notify_all();
+		}
+	}
+}
\ No newline at end of file
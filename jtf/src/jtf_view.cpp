@@ -0,0 +1,312 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+#include "jtf.h"
+#include "jtf_utility.h"
+#include <bit>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+	#include <filesystem>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace cybex_interactive::jtf
+{
+	inline static std::string FileViewError(const std::string& filePath, const std::string& message)
+	{
+		return std::format("[JTF View Error] '{}' {} File corrupted or not saved correctly.\n", filePath, message);
+	}
+
+
+	JTFView::JTFView(const std::string& filePath, bool verifyPayloadCrc) : m_filePath(filePath)
+	{
+		Map();
+		try
+		{
+			Validate(verifyPayloadCrc);
+		}
+		catch (...)
+		{
+			Unmap();
+			throw;
+		}
+	}
+
+	JTFView::~JTFView()
+	{
+		Unmap();
+	}
+
+	JTFView::JTFView(JTFView&& other) noexcept
+		: m_filePath(std::move(other.m_filePath))
+		, m_data(std::exchange(other.m_data, nullptr))
+		, m_size(std::exchange(other.m_size, 0))
+		, m_mappingHandle(std::exchange(other.m_mappingHandle, nullptr))
+		, m_header(other.m_header)
+		, m_samples(std::exchange(other.m_samples, nullptr))
+		, m_sampleBytes(std::exchange(other.m_sampleBytes, 0))
+		, m_sampleCount(std::exchange(other.m_sampleCount, 0))
+	{
+	}
+
+	JTFView& JTFView::operator=(JTFView&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Unmap();
+			m_filePath = std::move(other.m_filePath);
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+			m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+			m_header = other.m_header;
+			m_samples = std::exchange(other.m_samples, nullptr);
+			m_sampleBytes = std::exchange(other.m_sampleBytes, 0);
+			m_sampleCount = std::exchange(other.m_sampleCount, 0);
+		}
+		return *this;
+	}
+
+
+	void JTFView::Map()
+	{
+#if defined(_WIN32)
+		HANDLE file = CreateFileW(std::filesystem::path(m_filePath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error(FileViewError(m_filePath, "Cannot open file for reading."));
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			throw std::runtime_error(FileViewError(m_filePath, "Cannot map empty file."));
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file); // the mapping object keeps the file open
+		if (!mapping)
+			throw std::runtime_error(FileViewError(m_filePath, "Cannot create file mapping."));
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+		{
+			CloseHandle(mapping);
+			throw std::runtime_error(FileViewError(m_filePath, "Cannot map file."));
+		}
+
+		m_mappingHandle = mapping;
+		m_data = static_cast<const uint8_t*>(view);
+		m_size = static_cast<size_t>(size.QuadPart);
+#else
+		int file = ::open(m_filePath.c_str(), O_RDONLY);
+		if (file < 0)
+			throw std::runtime_error(FileViewError(m_filePath, "Cannot open file for reading."));
+
+		struct stat status{};
+		if (::fstat(file, &status) != 0 || status.st_size <= 0)
+		{
+			::close(file);
+			throw std::runtime_error(FileViewError(m_filePath, "Cannot map empty file."));
+		}
+
+		void* view = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+		::close(file); // the mapping keeps the file referenced
+		if (view == MAP_FAILED)
+			throw std::runtime_error(FileViewError(m_filePath, "Cannot map file."));
+
+		m_data = static_cast<const uint8_t*>(view);
+		m_size = static_cast<size_t>(status.st_size);
+#endif
+	}
+
+	void JTFView::Unmap() noexcept
+	{
+		if (!m_data) return;
+#if defined(_WIN32)
+		UnmapViewOfFile(m_data);
+		CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+		m_mappingHandle = nullptr;
+#else
+		::munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+		m_data = nullptr;
+		m_size = 0;
+		m_samples = nullptr;
+		m_sampleBytes = 0;
+		m_sampleCount = 0;
+	}
+
+	void JTFView::Validate(bool verifyPayloadCrc)
+	{
+		size_t offset = 0;
+
+		// bounds checked access into the mapping
+		auto take = [&](size_t size) -> const uint8_t*
+			{
+				if (size > m_size - offset)
+					throw std::runtime_error(FileViewError(m_filePath, "Unexpected EOF."));
+				const uint8_t* pointer = m_data + offset;
+				offset += size;
+				return pointer;
+			};
+
+		// signature
+		uint8_t signature[8];
+		UInt64_BigEndian(JTF_SIGNATURE, signature);
+		if (std::memcmp(take(8), signature, 8) != 0)
+			throw std::runtime_error(FileViewError(m_filePath, "Invalid file signature."));
+
+		// chunks
+		Crc32 fileCrc;
+		bool headRead = false;
+		bool fendReached = false;
+		while (!fendReached)
+		{
+			uint32_t payloadSize = ReadUInt32_LittleEndian(take(4));
+			const uint8_t* chunkType = take(4);
+			uint32_t chunkID = ReadUInt32_LittleEndian(chunkType);
+			const uint8_t* payload = take(payloadSize);
+			const uint8_t* expectedCrcBytes = take(4);
+			AppendToCrc(expectedCrcBytes, 4, { &fileCrc });
+			uint32_t expectedCrc = ReadUInt32_LittleEndian(expectedCrcBytes);
+
+			switch (chunkID)
+			{
+				case CHUNK_ID_HEAD:
+				{
+					if (payloadSize != 32)
+						throw std::runtime_error(FileViewError(m_filePath, std::format("Invalid HEAD payload size, expected [32] got [{}].", payloadSize)));
+					if (Crc32::Hash(chunkType, 4 + size_t(payloadSize)) != expectedCrc)
+						throw std::runtime_error(FileViewError(m_filePath, "HEAD CRC mismatch."));
+
+					DecodeHeadPayload(payload, m_header);
+					if (!IsSupportedBitDepth(m_header.BitDepth))
+						throw std::runtime_error(FileViewError(m_filePath, std::format("Unsupported bit depth, expected [8], [16], [32] or [64] got [{}].", m_header.BitDepth)));
+					if (m_header.Layout != JTF_Layout::Linear || m_header.Compression != JTF_Compression::None)
+						throw std::runtime_error(std::format("[JTF View Error] '{}' Tiled or compressed samples cannot be viewed in place, use JTFFile::Read() or JTFFile::ReadRegion().\n", m_filePath));
+					headRead = true;
+					break;
+				}
+
+				case CHUNK_ID_HMAP:
+				{
+					if (!headRead)
+						throw std::runtime_error(FileViewError(m_filePath, "HMAP chunk precedes HEAD chunk."));
+					// chunk type and payload are contiguous in the mapping
+					if (verifyPayloadCrc && Crc32::Hash(chunkType, 4 + size_t(payloadSize)) != expectedCrc)
+						throw std::runtime_error(FileViewError(m_filePath, "HMAP CRC mismatch."));
+
+					size_t sampleCount = size_t(m_header.Width) * size_t(m_header.Height);
+					if (payloadSize != sampleCount * (m_header.BitDepth / 8))
+						throw std::runtime_error(FileViewError(m_filePath, "HMAP payload size does not match (width * height * bitDepth / 8) requirement."));
+
+					m_samples = payload;
+					m_sampleBytes = payloadSize;
+					m_sampleCount = sampleCount;
+					break;
+				}
+
+				case CHUNK_ID_HLOD:
+				{
+					// levels are not exposed by the view, their CRC is only checked with the payload CRCs
+					if (!headRead)
+						throw std::runtime_error(FileViewError(m_filePath, "HLOD chunk precedes HEAD chunk."));
+					if (verifyPayloadCrc && Crc32::Hash(chunkType, 4 + size_t(payloadSize)) != expectedCrc)
+						throw std::runtime_error(FileViewError(m_filePath, "HLOD CRC mismatch."));
+					break;
+				}
+
+				case CHUNK_ID_HQDT:
+				case CHUNK_ID_HDIR:
+				{
+					// height tree and chunk directory are not exposed by the view, their CRC is only checked with the payload CRCs
+					if (!headRead)
+						throw std::runtime_error(FileViewError(m_filePath, std::format("{} chunk precedes HEAD chunk.", DecodeChunkID(chunkID))));
+					if (verifyPayloadCrc && Crc32::Hash(chunkType, 4 + size_t(payloadSize)) != expectedCrc)
+						throw std::runtime_error(FileViewError(m_filePath, std::format("{} CRC mismatch.", DecodeChunkID(chunkID))));
+					break;
+				}
+
+				case CHUNK_ID_FEND:
+				{
+					if (payloadSize != 0)
+						throw std::runtime_error(FileViewError(m_filePath, std::format("Invalid FEND payload size, expected [0] got [{}].", payloadSize)));
+					if (Crc32::Hash(chunkType, 4) != expectedCrc)
+						throw std::runtime_error(FileViewError(m_filePath, "FEND CRC mismatch."));
+					fendReached = true;
+					break;
+				}
+
+				default:
+					throw std::runtime_error(FileViewError(m_filePath, std::format("Unknown chunk type '{}'.", DecodeChunkID(chunkID))));
+			}
+		}
+
+		// file crc
+		if (ReadUInt32_LittleEndian(take(4)) != fileCrc.GetCurrentHashAsUInt32())
+			throw std::runtime_error(FileViewError(m_filePath, "File CRC mismatch."));
+
+		if (!headRead)
+			throw std::runtime_error(FileViewError(m_filePath, "Missing HEAD chunk."));
+	}
+
+
+	template<typename T> bool JTFView::HasSampleSpan() const noexcept
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint8_t>, "JTFView supports only float, double, uint16_t or uint8_t for T.");
+
+		if constexpr (std::endian::native != std::endian::little)
+			return false;
+		if (!m_samples || m_header.BitDepth != sizeof(T) * 8)
+			return false;
+		return reinterpret_cast<uintptr_t>(m_samples) % alignof(T) == 0;
+	}
+
+	template<typename T> std::span<const T> JTFView::GetSamples() const
+	{
+		if (!HasSampleSpan<T>())
+		{
+			if constexpr (std::endian::native != std::endian::little)
+				throw std::runtime_error(std::format("[JTF View Error] '{}' Typed sample span requires a little-endian host, use GetSample() or GetRawSamples().\n", m_filePath));
+			if (m_header.BitDepth != sizeof(T) * 8)
+				throw std::runtime_error(std::format("[JTF View Error] '{}' Requested [{}] bit samples from [{}] bit map.\n", m_filePath, sizeof(T) * 8, m_header.BitDepth));
+			throw std::runtime_error(std::format("[JTF View Error] '{}' HMAP payload is not {} byte aligned within the file, use GetSample() or GetRawSamples().\n", m_filePath, alignof(T)));
+		}
+		return { reinterpret_cast<const T*>(m_samples), m_sampleCount };
+	}
+
+	double JTFView::GetSample(size_t index) const
+	{
+		if (index >= m_sampleCount)
+			throw std::out_of_range(std::format("[JTF View Error] '{}' Sample index [{}] out of range [{}].\n", m_filePath, index, m_sampleCount));
+
+		switch (m_header.BitDepth)
+		{
+			case 8: return m_samples[index] * (1.0 / std::numeric_limits<uint8_t>::max());
+			case 16: return ReadUInt16_LittleEndian(m_samples + index * 2) * (1.0 / std::numeric_limits<uint16_t>::max());
+			case 32: return static_cast<double>(ReadFloat_LittleEndian(m_samples + index * 4));
+			default: return ReadDouble_LittleEndian(m_samples + index * 8);
+		}
+	}
+
+
+	// Explicit template instantiations
+	template bool JTFView::HasSampleSpan<float>() const noexcept;
+	template bool JTFView::HasSampleSpan<double>() const noexcept;
+	template std::span<const float> JTFView::GetSamples<float>() const;
+	template std::span<const double> JTFView::GetSamples<double>() const;
+	template bool JTFView::HasSampleSpan<uint16_t>() const noexcept;
+	template bool JTFView::HasSampleSpan<uint8_t>() const noexcept;
+	template std::span<const uint16_t> JTFView::GetSamples<uint16_t>() const;
+	template std::span<const uint8_t> JTFView::GetSamples<uint8_t>() const;
+}
\ No newline at end of file
@@ -4,9 +4,18 @@
 
 #include "jtf.h"
 #include "jtf_utility.h"
+#include "jtf_codec.h"
+#include "jtf_convert.h"
+#include "jtf_parallel.h"
+#include "jtf_height_tree.h"
+#include "jtf_file_output.h"
 #include <vector>
 #include <cstring>
 #include <format>
+#include <optional>
+#include <cmath>
+#include <limits>
+#include <utility>
 
 namespace cybex_interactive::jtf
 {
@@ -15,34 +24,40 @@ namespace cybex_interactive::jtf
 		return std::format("[JTF Write Error] '{}' {} File could not be generated.\n", filePath, message);
 	}
 
+	inline static void WritePayload(std::ostream& file, const uint8_t* data, size_t size)
+	{
+		StatsTimer timer(&JTF_Stats::IoNanoseconds);
+		file.write(reinterpret_cast<const char*>(data), size);
+	}
 
-	inline static int32_t WriteInt32_LittleEndian(std::ofstream& file, int32_t value) {
+
+	inline static int32_t WriteInt32_LittleEndian(std::ostream& file, int32_t value) {
 		if constexpr (std::endian::native == std::endian::big)
 			value = byteswap(value);
 		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
 		return value;
 	}
 
-	inline static uint8_t WriteUInt8_LittleEndian(std::ofstream& file, uint8_t value) {
+	inline static uint8_t WriteUInt8_LittleEndian(std::ostream& file, uint8_t value) {
 		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
 		return value;
 	}
 
-	inline static uint16_t WriteUInt16_LittleEndian(std::ofstream& file, uint16_t value) {
+	inline static uint16_t WriteUInt16_LittleEndian(std::ostream& file, uint16_t value) {
 		if constexpr (std::endian::native == std::endian::big)
 			value = byteswap(value);
 		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
 		return value;
 	}
 
-	inline static uint32_t WriteUInt32_LittleEndian(std::ofstream& file, uint32_t value){
+	inline static uint32_t WriteUInt32_LittleEndian(std::ostream& file, uint32_t value){
 		if constexpr (std::endian::native == std::endian::big)
 			value = byteswap(value);
 		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
 		return value;
 	}
 	
-	inline static uint64_t WriteUInt64_LittleEndian(std::ofstream& file, uint64_t value) {
+	inline static uint64_t WriteUInt64_LittleEndian(std::ostream& file, uint64_t value) {
 		if constexpr (std::endian::native == std::endian::big)
 			value = byteswap(value);
 		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
@@ -50,17 +65,181 @@ namespace cybex_interactive::jtf
 	}
 
 
-	inline static void UInt64_BigEndian(uint64_t value, uint8_t* out)
+	/// <summary>Factor and shift of ((elevation - offset) / scale - lower) / range as one multiply and add per sample, equal bounds map to 0.</summary>
+	inline static std::pair<double, double> NormalizingMap(int32_t boundsLower, int32_t boundsUpper, double scale, double offset)
+	{
+		double range = double(boundsUpper) - double(boundsLower);
+		if (range == 0.0)
+			return { 0.0, 0.0 };
+		return { 1.0 / (scale * range), -(offset / scale + double(boundsLower)) / range };
+	}
+
+	template<typename T> inline static void EncodeSamples_LittleEndian(const T* samples, size_t sampleCount, uint8_t* destination)
+	{
+		SampleConverter::ByteSwap(reinterpret_cast<const uint8_t*>(samples), sampleCount, sizeof(T), destination);
+	}
+
+	template<typename T> inline static const uint8_t* EncodeSamples_LittleEndian(const T* samples, size_t sampleCount, std::vector<uint8_t>& encoded)
 	{
-		for (int i = 7; i >= 0; --i)
+		if constexpr (std::endian::native == std::endian::big)
 		{
-			out[i] = static_cast<uint8_t>(value & 0xFF);
-			value >>= 8;
+			ResizeTracked(encoded, sampleCount * sizeof(T));
+			EncodeSamples_LittleEndian(samples, sampleCount, encoded.data());
+			return encoded.data();
 		}
+		else return reinterpret_cast<const uint8_t*>(samples);
+	}
+
+	// copy samples to little-endian bytes, byte swapped on big-endian hosts
+	template<typename S> inline static void StoreSamples_LittleEndian(const S* samples, size_t sampleCount, uint8_t* destination)
+	{
+		if constexpr (std::endian::native == std::endian::big && sizeof(S) > 1)
+			EncodeSamples_LittleEndian(samples, sampleCount, destination);
+		else
+			std::memcpy(destination, samples, sampleCount * sizeof(S));
+	}
+
+	// halve a level with a 1-2-1 tent filter centered on every second sample, clamped at the edges, rows in parallel bands
+	template<typename T> inline static void DownsampleLodLevel(const T* source, uint16_t width, uint16_t height, T* destination, uint32_t threadCount)
+	{
+		uint16_t levelWidth = LodLevelSize(width);
+		uint16_t levelHeight = LodLevelSize(height);
+
+		ParallelForBands(levelHeight, PARALLEL_MIN_SLICE_SIZE / (size_t(width) * 2 * sizeof(T)), threadCount, [&](size_t rowBegin, size_t rowEnd)
+			{
+				for (size_t y = rowBegin; y < rowEnd; ++y)
+				{
+					size_t centerY = y * 2;
+					const T* above = source + (centerY > 0 ? centerY - 1 : 0) * width;
+					const T* center = source + centerY * width;
+					const T* below = source + std::min<size_t>(centerY + 1, height - 1) * width;
+					T* row = destination + y * levelWidth;
+					for (size_t x = 0; x < levelWidth; ++x)
+					{
+						size_t centerX = x * 2;
+						size_t left = centerX > 0 ? centerX - 1 : 0;
+						size_t right = std::min<size_t>(centerX + 1, width - 1);
+						T sumAbove = above[left] + T(2) * above[centerX] + above[right];
+						T sumCenter = center[left] + T(2) * center[centerX] + center[right];
+						T sumBelow = below[left] + T(2) * below[centerX] + below[right];
+						row[x] = (sumAbove + T(2) * sumCenter + sumBelow) * T(0.0625);
+					}
+				}
+			});
+	}
+
+	// encode the 'HLOD' payload: level count, level index and the levels at the file bit depth, each level halving the previous
+	template<typename T> inline static std::vector<uint8_t> EncodeLodPyramid(const T* heights, uint16_t width, uint16_t height, uint8_t levelCount, uint8_t bitDepth, uint32_t threadCount)
+	{
+		size_t sampleSize = bitDepth / 8;
+		size_t indexSize = HLOD_HEADER_SIZE + size_t(levelCount) * HLOD_INDEX_ENTRY_SIZE;
+
+		// size every level up front, the payload is allocated once
+		size_t payloadSize = indexSize;
+		for (uint16_t sizeX = width, sizeY = height, level = 0; level < levelCount; ++level)
+		{
+			sizeX = LodLevelSize(sizeX);
+			sizeY = LodLevelSize(sizeY);
+			payloadSize += size_t(sizeX) * sizeY * sampleSize;
+		}
+
+		std::vector<uint8_t> payload;
+		ResizeTracked(payload, payloadSize);
+		StoreUInt16_LittleEndian(payload.data(), levelCount);
+		StoreUInt16_LittleEndian(payload.data() + 2, 0); // reserved
+
+		std::vector<T> finer;
+		std::vector<T> coarser;
+		std::vector<uint16_t> unorm16;
+		const T* source = heights;
+		size_t offset = 0;
+		for (uint8_t level = 0; level < levelCount; ++level)
+		{
+			uint16_t levelWidth = LodLevelSize(width);
+			uint16_t levelHeight = LodLevelSize(height);
+			size_t sampleCount = size_t(levelWidth) * levelHeight;
+			uint8_t* levelData = payload.data() + indexSize + offset;
+			{
+				StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+				ResizeTracked(coarser, sampleCount);
+				DownsampleLodLevel(source, width, height, coarser.data(), threadCount);
+
+				// store as the full resolution samples are stored
+				if (bitDepth == 8)
+					QuantizeUnorm(coarser.data(), sampleCount, levelData);
+				else if (bitDepth == 16)
+				{
+					ResizeTracked(unorm16, sampleCount);
+					QuantizeUnorm(coarser.data(), sampleCount, unorm16.data());
+					StoreSamples_LittleEndian(unorm16.data(), sampleCount, levelData);
+				}
+				else
+					StoreSamples_LittleEndian(coarser.data(), sampleCount, levelData);
+			}
+
+			size_t levelSize = sampleCount * sampleSize;
+			uint32_t levelCrc;
+			{
+				StatsTimer timer(&JTF_Stats::CrcNanoseconds);
+				levelCrc = Crc32::Hash(levelData, levelSize);
+			}
+
+			uint8_t* entry = payload.data() + HLOD_HEADER_SIZE + size_t(level) * HLOD_INDEX_ENTRY_SIZE;
+			StoreUInt16_LittleEndian(entry, levelWidth);
+			StoreUInt16_LittleEndian(entry + 2, levelHeight);
+			StoreUInt32_LittleEndian(entry + 4, static_cast<uint32_t>(offset));
+			StoreUInt32_LittleEndian(entry + 8, static_cast<uint32_t>(levelSize));
+			StoreUInt32_LittleEndian(entry + 12, levelCrc);
+			offset += levelSize;
+
+			// the next level halves this one
+			finer.swap(coarser);
+			source = finer.data();
+			width = levelWidth;
+			height = levelHeight;
+		}
+		return payload;
+	}
+
+	// encode the 'HQDT' payload: leaf size, level count and the min/max bounds of every level root first, at the file bit depth
+	template<typename S> inline static std::vector<uint8_t> EncodeHeightTree(const S* samples, uint16_t width, uint16_t height, uint16_t leafSize, uint32_t threadCount)
+	{
+		std::vector<std::vector<S>> levels;
+		{
+			StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+			levels = BuildHeightTreeBounds(samples, width, height, leafSize, threadCount);
+		}
+
+		size_t payloadSize = HQDT_HEADER_SIZE;
+		for (const std::vector<S>& bounds : levels)
+			payloadSize += bounds.size() * sizeof(S);
+
+		std::vector<uint8_t> payload;
+		ResizeTracked(payload, payloadSize);
+		StoreUInt16_LittleEndian(payload.data(), leafSize);
+		StoreUInt16_LittleEndian(payload.data() + 2, static_cast<uint16_t>(levels.size()));
+		StoreUInt32_LittleEndian(payload.data() + 4, 0); // reserved
+
+		size_t offset = HQDT_HEADER_SIZE;
+		for (const std::vector<S>& bounds : levels)
+		{
+			StoreSamples_LittleEndian(bounds.data(), bounds.size(), payload.data() + offset);
+			offset += bounds.size() * sizeof(S);
+		}
+		return payload;
 	}
-	
 
 	template<typename T> void JTFFile::Write(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& heights)
+	{
+		Write(filePath, width, height, boundsLower, boundsUpper, heights, JTF_WriteOptions{});
+	}
+
+	template<typename T> void JTFFile::Write(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& heights, const JTF_WriteOptions& options)
+	{
+		WriteMapped(filePath, width, height, boundsLower, boundsUpper, heights, 1.0, 0.0, options);
+	}
+
+	template<typename T> void JTFFile::WriteMapped(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& heights, double sampleScale, double sampleOffset, const JTF_WriteOptions& options)
 	{
 		// type compatibility check
 		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTF supports only float or double for T.");
@@ -75,34 +254,174 @@ namespace cybex_interactive::jtf
 		if (heights.size() != size_t(width) * size_t(height))
 			throw std::invalid_argument(FileWriteError(filePath, "heights size mismatch with map size (width * height)."));
 
+		// options check
+		if (options.Layout != JTF_Layout::Linear && options.Layout != JTF_Layout::Tiled)
+			throw std::invalid_argument(FileWriteError(filePath, std::format("unsupported layout [{}].", static_cast<uint8_t>(options.Layout))));
+		if (options.Layout == JTF_Layout::Tiled && (options.TileSize < TILE_SIZE_MIN || options.TileSize > TILE_SIZE_MAX))
+			throw std::invalid_argument(FileWriteError(filePath, std::format("tile size [{}] outside of [{}..{}].", options.TileSize, TILE_SIZE_MIN, TILE_SIZE_MAX)));
+		if (options.Compression != JTF_Compression::None && options.Compression != JTF_Compression::PredictiveLZ)
+			throw std::invalid_argument(FileWriteError(filePath, std::format("unsupported compression [{}].", static_cast<uint8_t>(options.Compression))));
+		if (options.Compression != JTF_Compression::None && options.Layout != JTF_Layout::Linear)
+			throw std::invalid_argument(FileWriteError(filePath, "compression requires linear layout."));
+		if (options.BitDepth != 0 && options.BitDepth != 8 && options.BitDepth != 16 && options.BitDepth != sizeof(T) * 8)
+			throw std::invalid_argument(FileWriteError(filePath, std::format("bit depth [{}] not supported for [{}] bit input, expected [0], [8], [16] or [{}].", options.BitDepth, sizeof(T) * 8, sizeof(T) * 8)));
+		if (options.LodLevels > LOD_LEVEL_LIMIT)
+			throw std::invalid_argument(FileWriteError(filePath, std::format("LOD level count [{}] exceeds limit of [{}].", options.LodLevels, LOD_LEVEL_LIMIT)));
+		if (options.HeightTreeLeafSize != 0 && (options.HeightTreeLeafSize < HEIGHT_TREE_LEAF_MIN || options.HeightTreeLeafSize > HEIGHT_TREE_LEAF_MAX))
+			throw std::invalid_argument(FileWriteError(filePath, std::format("height tree leaf size [{}] outside of [{}..{}].", options.HeightTreeLeafSize, HEIGHT_TREE_LEAF_MIN, HEIGHT_TREE_LEAF_MAX)));
+
+		StatsScope scope(options.Stats);
+
 		// file existance check
-		std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
-		if (!file)
+		FileOutputBuffer output(filePath, options.AtomicReplace);
+		if (!output.IsOpen())
 			throw std::runtime_error(FileWriteError(filePath, "Cannot open file for writing."));
+		std::ostream file(&output);
 
-		uint8_t bitDepth = std::is_same_v<T, float> ? 32 : 64;
+		uint8_t bitDepth = options.BitDepth != 0 ? options.BitDepth : uint8_t(sizeof(T) * 8);
+		TileGrid grid = TileGrid::Create(width, height, options.TileSize);
 
 		// heights payload size limit check
-		if (heights.size() * (bitDepth / 8) > std::numeric_limits<uint32_t>::max())
+		size_t indexSize = options.Layout == JTF_Layout::Tiled ? grid.IndexSize() : 0;
+		if (indexSize + heights.size() * (bitDepth / 8) > std::numeric_limits<uint32_t>::max())
 			throw std::overflow_error(FileWriteError(filePath, "Payload size exceeds 4 GB limit."));
 
+		// convert on write in parallel bands, an 'HMAP' payload (the little-endian stored samples) is hashed in the same sweep
+		std::vector<uint16_t> unorm16;
+		std::vector<uint8_t> unorm8;
+		std::vector<T> normalized;
+		std::optional<uint32_t> hmapPayloadHash;
+		auto convertInto = [&](auto& stored, auto&& convert)
+			{
+				using Q = typename std::decay_t<decltype(stored)>::value_type;
+				ResizeTracked(stored, heights.size());
+				StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+				if (std::endian::native == std::endian::little && options.Layout == JTF_Layout::Linear && options.Compression == JTF_Compression::None && sizeof(Q) * 8 == bitDepth)
+				{
+					Crc32 payloadCrc;
+					ConvertAndAppendToCrcParallel(reinterpret_cast<const uint8_t*>(stored.data()), heights.size(), sizeof(Q), payloadCrc, options.ThreadCount, convert);
+					hmapPayloadHash = payloadCrc.GetCurrentHashAsUInt32();
+				}
+				else
+					ParallelForBands(heights.size(), PARALLEL_MIN_SLICE_SIZE / sizeof(T), options.ThreadCount, convert);
+			};
+
+		// mapped input is normalized up front only where normalized samples are kept (full precision or LOD source), otherwise while quantizing
+		T scale = static_cast<T>(sampleScale);
+		T offset = static_cast<T>(sampleOffset);
+		bool mapped = sampleScale != 1.0 || sampleOffset != 0.0;
+		uint8_t lodLevels = LodLevelCount(width, height, options.LodLevels);
+		if (mapped && (bitDepth == sizeof(T) * 8 || lodLevels > 0))
+			convertInto(normalized, [&](size_t begin, size_t end) { SampleConverter::Affine(heights.data() + begin, end - begin, scale, offset, normalized.data() + begin); });
+		bool mapOnQuantize = mapped && normalized.empty();
+		const std::vector<T>& samples = normalized.empty() ? heights : normalized;
+
+		auto quantize = [&](auto& quantized)
+			{
+				convertInto(quantized, [&](size_t begin, size_t end)
+					{
+						if (mapOnQuantize)
+							QuantizeUnorm(heights.data() + begin, end - begin, scale, offset, quantized.data() + begin);
+						else
+							QuantizeUnorm(samples.data() + begin, end - begin, quantized.data() + begin);
+					});
+			};
+		if (bitDepth == 16)
+			quantize(unorm16);
+		else if (bitDepth == 8)
+			quantize(unorm8);
+
+		// invokes action with the samples as stored
+		auto withSamples = [&](auto&& action)
+			{
+				if (bitDepth == 16) action(unorm16);
+				else if (bitDepth == 8) action(unorm8);
+				else action(samples);
+			};
+
+		std::vector<uint8_t> compressed;
+		if (options.Compression == JTF_Compression::PredictiveLZ)
+		{
+			{
+				StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+				withSamples([&](const auto& samples) { compressed = HeightCodec::Encode(samples.data(), width, height, options.ThreadCount); });
+			}
+			// the encoder hands back a freshly allocated payload
+			CountStat(&JTF_Stats::Allocations, 1);
+			CountStat(&JTF_Stats::AllocatedBytes, compressed.capacity());
+			if (compressed.size() > std::numeric_limits<uint32_t>::max())
+				throw std::overflow_error(FileWriteError(filePath, "Payload size exceeds 4 GB limit."));
+		}
+
+		// downsampled levels for coarse reads, from the input samples and stored at the file bit depth
+		std::vector<uint8_t> lod;
+		if (lodLevels > 0)
+			lod = EncodeLodPyramid(samples.data(), width, height, lodLevels, bitDepth, options.ThreadCount);
+
+		// min/max quadtree over the samples as stored, so its bounds hold exactly for the decoded samples
+		std::vector<uint8_t> heightTree;
+		if (options.HeightTreeLeafSize != 0)
+			withSamples([&](const auto& samples) { heightTree = EncodeHeightTree(samples.data(), width, height, options.HeightTreeLeafSize, options.ThreadCount); });
+
+		JTF_Head header;
+		header.Width = width;
+		header.Height = height;
+		header.BitDepth = bitDepth;
+		header.Layout = options.Layout;
+		header.Compression = options.Compression;
+		header.ChunkDirectory = options.ChunkDirectory;
+		header.BoundsLower = boundsLower;
+		header.BoundsUpper = boundsUpper;
+
 		Crc32 fileCrc;
 
+		// invokes write, listing the written chunk in the directory if requested
+		std::vector<JTF_ChunkEntry> directory;
+		auto writeChunk = [&](uint32_t chunkType, auto&& write)
+			{
+				uint64_t offset = options.ChunkDirectory ? static_cast<uint64_t>(file.tellp()) : 0;
+				uint32_t chunkCrc = write();
+				if (options.ChunkDirectory)
+					directory.push_back({ chunkType, static_cast<uint32_t>(static_cast<uint64_t>(file.tellp()) - offset - CHUNK_FRAME_SIZE), offset, chunkCrc });
+			};
+
 		WriteSignature(file);
-		WriteHeadChunk(file, width, height, bitDepth, boundsLower, boundsUpper, fileCrc);
-		WriteHmapChunk(file, bitDepth, heights, fileCrc);
+		writeChunk(CHUNK_ID_HEAD, [&]() { return WriteHeadChunk(file, header, fileCrc); });
+		if (!lod.empty())
+			writeChunk(CHUNK_ID_HLOD, [&]() { return WriteHlodChunk(file, lod, fileCrc, options.ThreadCount); });
+		if (!heightTree.empty())
+			writeChunk(CHUNK_ID_HQDT, [&]() { return WriteHqdtChunk(file, heightTree, fileCrc, options.ThreadCount); });
+		if (options.Compression == JTF_Compression::PredictiveLZ)
+			writeChunk(CHUNK_ID_HCMP, [&]() { return WriteHcmpChunk(file, compressed, fileCrc, options.ThreadCount); });
+		else if (options.Layout == JTF_Layout::Tiled)
+			withSamples([&](const auto& samples) { writeChunk(CHUNK_ID_HTIL, [&]() { return WriteHtilChunk(file, grid, samples, fileCrc); }); });
+		else
+			withSamples([&](const auto& samples) { writeChunk(CHUNK_ID_HMAP, [&]() { return WriteHmapChunk(file, bitDepth, samples, hmapPayloadHash, fileCrc, options.ThreadCount); }); });
+		if (options.ChunkDirectory)
+			WriteHdirChunk(file, directory, fileCrc);
 		WriteFendChunk(file, fileCrc);
 		WriteFileCrc(file, fileCrc);
+		if (!file)
+			throw std::runtime_error(FileWriteError(filePath, "Failed writing file."));
+
+		// staged bytes out, then synced and renamed over the target
+		uint64_t fileSize = static_cast<uint64_t>(file.tellp());
+		{
+			StatsTimer timer(&JTF_Stats::IoNanoseconds);
+			if (!output.Commit())
+				throw std::runtime_error(FileWriteError(filePath, "Failed replacing file."));
+		}
+		CountStat(&JTF_Stats::BytesWritten, fileSize);
 	}
 
-	void JTFFile::WriteSignature(std::ofstream& file)
+	void JTFFile::WriteSignature(std::ostream& file)
 	{
 		uint8_t signatureBE[8];
 		UInt64_BigEndian(JTF_SIGNATURE, signatureBE);
 		file.write(reinterpret_cast<const char*>(signatureBE), sizeof(signatureBE));
 	}
 
-	void JTFFile::WriteHeadChunk(std::ofstream& file, uint16_t width, uint16_t height, uint8_t bitDepth, int32_t boundsLower, int32_t boundsUpper, Crc32& fileCrc)
+	uint32_t JTFFile::WriteHeadChunk(std::ostream& file, const JTF_Head& header, Crc32& fileCrc)
 	{
 		constexpr uint64_t zero64 = 0;
 
@@ -131,36 +450,50 @@ namespace cybex_interactive::jtf
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint8), sizeof(written_uint8), { &chunkCrc });
 
 		// dimensions
-		uint16_t written_uint16 = WriteUInt16_LittleEndian(file, width);
+		uint16_t written_uint16 = WriteUInt16_LittleEndian(file, header.Width);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint16), sizeof(written_uint16), { &chunkCrc });
-		written_uint16 = WriteUInt16_LittleEndian(file, height);
+		written_uint16 = WriteUInt16_LittleEndian(file, header.Height);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint16), sizeof(written_uint16), { &chunkCrc });
 
 		// bit depth
-		written_uint8 = WriteUInt8_LittleEndian(file, bitDepth);
+		written_uint8 = WriteUInt8_LittleEndian(file, header.BitDepth);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint8), sizeof(written_uint8), { &chunkCrc });
 
-		// RESERVED 8 BYTES ([8..16] = 0 by default)
-		uint64_t written_uint64 = WriteUInt64_LittleEndian(file, zero64);
-		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint64), sizeof(written_uint64), { &chunkCrc });
+		// layout
+		written_uint8 = WriteUInt8_LittleEndian(file, static_cast<uint8_t>(header.Layout));
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint8), sizeof(written_uint8), { &chunkCrc });
+
+		// compression
+		written_uint8 = WriteUInt8_LittleEndian(file, static_cast<uint8_t>(header.Compression));
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint8), sizeof(written_uint8), { &chunkCrc });
+
+		// chunk directory
+		written_uint8 = WriteUInt8_LittleEndian(file, header.ChunkDirectory ? 1 : 0);
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint8), sizeof(written_uint8), { &chunkCrc });
+
+		// RESERVED 5 BYTES ([11..16] = 0 by default)
+		constexpr uint8_t zero40[5] = {};
+		file.write(reinterpret_cast<const char*>(zero40), sizeof(zero40));
+		AppendToCrc(zero40, sizeof(zero40), { &chunkCrc });
 
 		// bounds
-		int32_t written_int32 = WriteInt32_LittleEndian(file, boundsLower);
+		int32_t written_int32 = WriteInt32_LittleEndian(file, header.BoundsLower);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_int32), sizeof(written_int32), { &chunkCrc });
-		written_int32 = WriteInt32_LittleEndian(file, boundsUpper);
+		written_int32 = WriteInt32_LittleEndian(file, header.BoundsUpper);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_int32), sizeof(written_int32), { &chunkCrc });
 
 		// RESERVED 8 BYTES ([24..32] = 0 by default)
-		written_uint64 = WriteUInt64_LittleEndian(file, zero64);
+		uint64_t written_uint64 = WriteUInt64_LittleEndian(file, zero64);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint64), sizeof(written_uint64), { &chunkCrc });
 
 		// chunk crc
 		uint32_t crcValue = chunkCrc.GetCurrentHashAsUInt32();
 		written_uint32 = WriteUInt32_LittleEndian(file, crcValue);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &fileCrc });
+		return crcValue;
 	}
 
-	template<typename T> void JTFFile::WriteHmapChunk(std::ofstream& file, uint8_t bitDepth, const std::vector<T>& heights, Crc32& fileCrc)
+	template<typename T> uint32_t JTFFile::WriteHmapChunk(std::ostream& file, uint8_t bitDepth, const std::vector<T>& heights, std::optional<uint32_t> payloadHash, Crc32& fileCrc, uint32_t threadCount)
 	{
 		// chunk length
 		uint32_t sampleSize = bitDepth / 8;
@@ -174,49 +507,165 @@ namespace cybex_interactive::jtf
 		uint32_t written_uint32 = WriteUInt32_LittleEndian(file, chunkTypeName);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &chunkCrc });
 
-		// height data
+		// height data, byte swapped and hashed in one sweep of parallel bands on big-endian hosts
 		if constexpr (std::endian::native == std::endian::big)
 		{
-			std::vector<uint8_t> encoded(payloadSize);
-
-			if (bitDepth == 32)
+			std::vector<uint8_t> encoded;
+			ResizeTracked(encoded, payloadSize);
 			{
-				for (size_t i = 0; i < heights.size(); ++i)
-				{
-					uint32_t value;
-					std::memcpy(&value, &heights[i], 4);
-					value = byteswap(value);
-					std::memcpy(encoded.data() + i * 4, &value, 4);
-				}
+				StatsTimer timer(&JTF_Stats::ConvertNanoseconds);
+				ConvertAndAppendToCrcParallel(encoded.data(), heights.size(), sizeof(T), chunkCrc, threadCount, [&](size_t begin, size_t end)
+					{
+						EncodeSamples_LittleEndian(heights.data() + begin, end - begin, encoded.data() + begin * sizeof(T));
+					});
 			}
+			WritePayload(file, encoded.data(), payloadSize);
+		}
+		else
+		{
+			const uint8_t* heightsData = reinterpret_cast<const uint8_t*>(heights.data());
+			WritePayload(file, heightsData, payloadSize);
+			if (payloadHash)
+				chunkCrc.AppendHash(*payloadHash, payloadSize);
 			else
+				AppendToCrcParallel(heightsData, payloadSize, chunkCrc, threadCount);
+		}
+
+		// chunk crc
+		uint32_t crcValue = chunkCrc.GetCurrentHashAsUInt32();
+		written_uint32 = WriteUInt32_LittleEndian(file, crcValue);
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &fileCrc });
+		return crcValue;
+	}
+
+	template<typename T> uint32_t JTFFile::WriteHtilChunk(std::ostream& file, const TileGrid& grid, const std::vector<T>& heights, Crc32& fileCrc)
+	{
+		// chunk length
+		uint32_t payloadSize = static_cast<uint32_t>(grid.IndexSize() + heights.size() * sizeof(T)); // size limit checked in JTFFile::Write
+		WriteUInt32_LittleEndian(file, payloadSize);
+
+		Crc32 chunkCrc;
+
+		// chunk type
+		constexpr uint32_t chunkTypeName = CHUNK_ID_HTIL;
+		uint32_t written_uint32 = WriteUInt32_LittleEndian(file, chunkTypeName);
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &chunkCrc });
+
+		// tile header
+		for (uint16_t value : { grid.TileSize, grid.TilesX, grid.TilesY, uint16_t(0) /* RESERVED */ })
+		{
+			uint16_t written_uint16 = WriteUInt16_LittleEndian(file, value);
+			AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint16), sizeof(written_uint16), { &chunkCrc });
+		}
+
+		std::vector<uint8_t> encoded;
+
+		// tile index, tiles in row-major order with rows stored contiguously per tile
+		uint32_t tileOffset = 0;
+		for (uint32_t tileY = 0; tileY < grid.TilesY; ++tileY)
+		{
+			for (uint32_t tileX = 0; tileX < grid.TilesX; ++tileX)
 			{
-				for (size_t i = 0; i < heights.size(); ++i)
+				uint32_t tileWidth = grid.TileWidth(tileX);
+				uint32_t tileHeight = grid.TileHeight(tileY);
+				uint32_t tileSize = tileWidth * tileHeight * sizeof(T);
+
+				Crc32 tileCrc;
+				const T* tileOrigin = heights.data() + size_t(tileY) * grid.TileSize * grid.Width + size_t(tileX) * grid.TileSize;
+				for (uint32_t row = 0; row < tileHeight; ++row)
+					AppendToCrc(EncodeSamples_LittleEndian(tileOrigin + size_t(row) * grid.Width, tileWidth, encoded), tileWidth * sizeof(T), { &tileCrc });
+
+				for (uint32_t value : { tileOffset, tileSize, tileCrc.GetCurrentHashAsUInt32() })
 				{
-					uint64_t value;
-					std::memcpy(&value, &heights[i], 8);
-					value = byteswap(value);
-					std::memcpy(encoded.data() + i * 8, &value, 8);
+					written_uint32 = WriteUInt32_LittleEndian(file, value);
+					AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &chunkCrc });
 				}
+				tileOffset += tileSize;
 			}
-
-			file.write(reinterpret_cast<const char*>(encoded.data()), payloadSize);
-			AppendToCrc(encoded.data(), payloadSize, { &chunkCrc });
 		}
-		else
+
+		// tile data
+		for (uint32_t tileY = 0; tileY < grid.TilesY; ++tileY)
 		{
-			const uint8_t* heightsData = reinterpret_cast<const uint8_t*>(heights.data());
-			file.write(reinterpret_cast<const char*>(heightsData), payloadSize);
-			AppendToCrc(heightsData, payloadSize, { &chunkCrc });
+			for (uint32_t tileX = 0; tileX < grid.TilesX; ++tileX)
+			{
+				uint32_t tileWidth = grid.TileWidth(tileX);
+				const T* tileOrigin = heights.data() + size_t(tileY) * grid.TileSize * grid.Width + size_t(tileX) * grid.TileSize;
+				for (uint32_t row = 0; row < grid.TileHeight(tileY); ++row)
+				{
+					const uint8_t* rowData = EncodeSamples_LittleEndian(tileOrigin + size_t(row) * grid.Width, tileWidth, encoded);
+					WritePayload(file, rowData, tileWidth * sizeof(T));
+					AppendToCrc(rowData, tileWidth * sizeof(T), { &chunkCrc });
+				}
+			}
 		}
 
 		// chunk crc
 		uint32_t crcValue = chunkCrc.GetCurrentHashAsUInt32();
 		written_uint32 = WriteUInt32_LittleEndian(file, crcValue);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &fileCrc });
+		return crcValue;
+	}
+
+	// write a chunk whose payload was encoded up front
+	inline static uint32_t WriteEncodedChunk(std::ostream& file, uint32_t chunkType, const std::vector<uint8_t>& payload, Crc32& fileCrc, uint32_t threadCount)
+	{
+		// chunk length
+		uint32_t payloadSize = static_cast<uint32_t>(payload.size()); // size limit checked in JTFFile::Write
+		WriteUInt32_LittleEndian(file, payloadSize);
+
+		Crc32 chunkCrc;
+
+		// chunk type
+		uint32_t written_uint32 = WriteUInt32_LittleEndian(file, chunkType);
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &chunkCrc });
+
+		// encoded data
+		WritePayload(file, payload.data(), payloadSize);
+		AppendToCrcParallel(payload.data(), payloadSize, chunkCrc, threadCount);
+
+		// chunk crc
+		uint32_t crcValue = chunkCrc.GetCurrentHashAsUInt32();
+		written_uint32 = WriteUInt32_LittleEndian(file, crcValue);
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &fileCrc });
+		return crcValue;
+	}
+
+	uint32_t JTFFile::WriteHcmpChunk(std::ostream& file, const std::vector<uint8_t>& payload, Crc32& fileCrc, uint32_t threadCount)
+	{
+		return WriteEncodedChunk(file, CHUNK_ID_HCMP, payload, fileCrc, threadCount);
+	}
+
+	uint32_t JTFFile::WriteHlodChunk(std::ostream& file, const std::vector<uint8_t>& payload, Crc32& fileCrc, uint32_t threadCount)
+	{
+		return WriteEncodedChunk(file, CHUNK_ID_HLOD, payload, fileCrc, threadCount);
+	}
+
+	uint32_t JTFFile::WriteHqdtChunk(std::ostream& file, const std::vector<uint8_t>& payload, Crc32& fileCrc, uint32_t threadCount)
+	{
+		return WriteEncodedChunk(file, CHUNK_ID_HQDT, payload, fileCrc, threadCount);
+	}
+
+	void JTFFile::WriteHdirChunk(std::ostream& file, const std::vector<JTF_ChunkEntry>& directory, Crc32& fileCrc)
+	{
+		// entries in file order, the entry count last so readers locate the chunk from the file end
+		std::vector<uint8_t> payload(directory.size() * HDIR_ENTRY_SIZE + HDIR_TRAILER_SIZE);
+		uint8_t* entry = payload.data();
+		for (const JTF_ChunkEntry& chunk : directory)
+		{
+			StoreUInt32_LittleEndian(entry, chunk.Type);
+			StoreUInt32_LittleEndian(entry + 4, chunk.Length);
+			StoreUInt64_LittleEndian(entry + 8, chunk.Offset);
+			StoreUInt32_LittleEndian(entry + 16, chunk.Crc);
+			StoreUInt32_LittleEndian(entry + 20, 0); // reserved
+			entry += HDIR_ENTRY_SIZE;
+		}
+		StoreUInt32_LittleEndian(entry, static_cast<uint32_t>(directory.size()));
+
+		WriteEncodedChunk(file, CHUNK_ID_HDIR, payload, fileCrc, 1);
 	}
 
-	void JTFFile::WriteFendChunk(std::ofstream& file, Crc32& fileCrc)
+	uint32_t JTFFile::WriteFendChunk(std::ostream& file, Crc32& fileCrc)
 	{
 		// chunk length
 		const uint32_t payloadSize = 0;
@@ -233,17 +682,184 @@ namespace cybex_interactive::jtf
 		uint32_t crcValue = chunkCrc.GetCurrentHashAsUInt32();
 		written_uint32 = WriteUInt32_LittleEndian(file, crcValue);
 		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &fileCrc });
+		return crcValue;
 	}
 
-	void JTFFile::WriteFileCrc(std::ofstream& file, Crc32& fileCrc)
+	void JTFFile::WriteFileCrc(std::ostream& file, Crc32& fileCrc)
 	{
 		uint32_t crcValue = fileCrc.GetCurrentHashAsUInt32();
 		WriteUInt32_LittleEndian(file, crcValue);
 	}
 
 
+	template<typename T> JTFStreamWriter<T>::JTFStreamWriter(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper)
+		: m_filePath(filePath), m_output(filePath, true), m_file(&m_output), m_width(width), m_height(height)
+	{
+		// size constraint check
+		if (width > MAP_AXIS_SIZE_LIMIT || height > MAP_AXIS_SIZE_LIMIT)
+			throw std::invalid_argument(FileWriteError(filePath, std::format("width [{}] and/or height [{}] exceeds limit of [{}].", width, height, MAP_AXIS_SIZE_LIMIT)));
+		if (width == 0 || height == 0)
+			throw std::invalid_argument(FileWriteError(filePath, std::format("width [{}] and/or height [{}] subceeds limit of 1.", width, height)));
+
+		constexpr uint8_t bitDepth = sizeof(T) * 8;
+
+		// heights payload size limit check
+		uint64_t payloadSize64 = uint64_t(width) * uint64_t(height) * sizeof(T);
+		if (payloadSize64 > std::numeric_limits<uint32_t>::max())
+			throw std::overflow_error(FileWriteError(filePath, "Payload size exceeds 4 GB limit."));
+
+		// file existance check
+		if (!m_output.IsOpen())
+			throw std::runtime_error(FileWriteError(filePath, "Cannot open file for writing."));
+
+		JTF_Head header;
+		header.Width = width;
+		header.Height = height;
+		header.BitDepth = bitDepth;
+		header.BoundsLower = boundsLower;
+		header.BoundsUpper = boundsUpper;
+
+		JTFFile::WriteSignature(m_file);
+		JTFFile::WriteHeadChunk(m_file, header, m_fileCrc);
+
+		// HMAP chunk length and type, the payload follows band by band
+		WriteUInt32_LittleEndian(m_file, static_cast<uint32_t>(payloadSize64));
+		constexpr uint32_t chunkTypeName = CHUNK_ID_HMAP;
+		uint32_t written_uint32 = WriteUInt32_LittleEndian(m_file, chunkTypeName);
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &m_chunkCrc });
+
+		if (!m_file)
+			throw std::runtime_error(FileWriteError(filePath, "Failed writing file header."));
+	}
+
+	template<typename T> JTFStreamWriter<T>::~JTFStreamWriter() = default;
+
+	template<typename T> void JTFStreamWriter<T>::AppendRows(std::span<const T> rows)
+	{
+		if (m_finished)
+			throw std::logic_error(FileWriteError(m_filePath, "AppendRows() called after Finish()."));
+		if (rows.size() % m_width != 0)
+			throw std::invalid_argument(FileWriteError(m_filePath, std::format("band size [{}] is not a multiple of width [{}].", rows.size(), m_width)));
+
+		size_t rowCount = rows.size() / m_width;
+		if (m_rowsWritten + rowCount > m_height)
+			throw std::invalid_argument(FileWriteError(m_filePath, std::format("band exceeds map height [{}], [{}] rows already written.", m_height, m_rowsWritten)));
+
+		size_t byteCount = rows.size_bytes();
+
+		// height data
+		if constexpr (std::endian::native == std::endian::big)
+		{
+			using Raw = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+			m_encoded.resize(byteCount);
+			for (size_t i = 0; i < rows.size(); ++i)
+			{
+				Raw value;
+				std::memcpy(&value, &rows[i], sizeof(T));
+				value = byteswap(value);
+				std::memcpy(m_encoded.data() + i * sizeof(T), &value, sizeof(T));
+			}
+
+			m_file.write(reinterpret_cast<const char*>(m_encoded.data()), byteCount);
+			AppendToCrc(m_encoded.data(), byteCount, { &m_chunkCrc });
+		}
+		else
+		{
+			const uint8_t* heightsData = reinterpret_cast<const uint8_t*>(rows.data());
+			m_file.write(reinterpret_cast<const char*>(heightsData), byteCount);
+			AppendToCrc(heightsData, byteCount, { &m_chunkCrc });
+		}
+
+		if (!m_file)
+			throw std::runtime_error(FileWriteError(m_filePath, "Failed writing height samples."));
+
+		m_rowsWritten += static_cast<uint32_t>(rowCount);
+	}
+
+	template<typename T> void JTFStreamWriter<T>::Finish()
+	{
+		if (m_finished) return;
+		if (m_rowsWritten != m_height)
+			throw std::logic_error(FileWriteError(m_filePath, std::format("Finish() called after [{}] of [{}] rows.", m_rowsWritten, m_height)));
+
+		// HMAP chunk crc
+		uint32_t crcValue = m_chunkCrc.GetCurrentHashAsUInt32();
+		uint32_t written_uint32 = WriteUInt32_LittleEndian(m_file, crcValue);
+		AppendToCrc(reinterpret_cast<const uint8_t*>(&written_uint32), sizeof(written_uint32), { &m_fileCrc });
+
+		JTFFile::WriteFendChunk(m_file, m_fileCrc);
+		JTFFile::WriteFileCrc(m_file, m_fileCrc);
+
+		if (!m_file)
+			throw std::runtime_error(FileWriteError(m_filePath, "Failed writing file end."));
+		if (!m_output.Commit())
+			throw std::runtime_error(FileWriteError(m_filePath, "Failed replacing file."));
+
+		m_finished = true;
+	}
+
+	template<typename T> void JTFFile::WriteElevations(const std::string& filePath, uint16_t width, uint16_t height, int32_t boundsLower, int32_t boundsUpper, const std::vector<T>& elevations, const JTF_WriteOptions& options)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTF supports only float or double for T.");
+
+		auto [factor, shift] = NormalizingMap(boundsLower, boundsUpper, 1.0, 0.0);
+		WriteMapped(filePath, width, height, boundsLower, boundsUpper, elevations, factor, shift, options);
+	}
+
+	template<typename T> void JTFFile::WriteElevations(const std::string& filePath, uint16_t width, uint16_t height, const std::vector<T>& elevations, const JTF_WriteOptions& options)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTF supports only float or double for T.");
+
+		// heights to map size check, ahead of the bounds scan
+		if (elevations.size() != size_t(width) * size_t(height))
+			throw std::invalid_argument(FileWriteError(filePath, "heights size mismatch with map size (width * height)."));
+
+		StatsScope scope(options.Stats);
+
+		T minimum = std::numeric_limits<T>::infinity();
+		T maximum = -std::numeric_limits<T>::infinity();
+		MinMaxParallel(elevations.data(), elevations.size(), minimum, maximum, options.ThreadCount);
+
+		// bounds fit check, also rejects infinite elevations
+		if (!(minimum <= maximum))
+			throw std::invalid_argument(FileWriteError(filePath, "elevations hold only NaN samples."));
+		double lower = std::floor(double(minimum));
+		double upper = std::ceil(double(maximum));
+		if (!(lower >= double(std::numeric_limits<int32_t>::min()) && upper <= double(std::numeric_limits<int32_t>::max())))
+			throw std::invalid_argument(FileWriteError(filePath, std::format("elevation range [{}..{}] exceeds int32 bounds.", minimum, maximum)));
+
+		int32_t boundsLower = static_cast<int32_t>(lower);
+		int32_t boundsUpper = static_cast<int32_t>(upper);
+		auto [factor, shift] = NormalizingMap(boundsLower, boundsUpper, 1.0, 0.0);
+		WriteMapped(filePath, width, height, boundsLower, boundsUpper, elevations, factor, shift, options);
+	}
+
+	template<typename T> void JTFFile::Normalize(std::span<const T> elevations, int32_t boundsLower, int32_t boundsUpper, std::span<T> normalized, double scale, double offset, uint32_t threadCount)
+	{
+		static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "JTFFile::Normalize supports only float or double for T.");
+		if (normalized.size() != elevations.size())
+			throw std::invalid_argument(std::format("[JTF Convert Error] Destination of [{}] samples does not match [{}] source samples.\n", normalized.size(), elevations.size()));
+		if (scale == 0.0)
+			throw std::invalid_argument("[JTF Convert Error] Scale must not be 0.\n");
+
+		auto [factor, shift] = NormalizingMap(boundsLower, boundsUpper, scale, offset);
+		MapAffineParallel(elevations.data(), elevations.size(), factor, shift, normalized.data(), threadCount);
+	}
+
+
 	// Explicit template instantiations
 	template void JTFFile::Write<float>(const std::string&, uint16_t, uint16_t, int32_t, int32_t, const std::vector<float>&);
 	template void JTFFile::Write<double>(const std::string&, uint16_t, uint16_t, int32_t, int32_t, const std::vector<double>&);
+	template void JTFFile::Write<float>(const std::string&, uint16_t, uint16_t, int32_t, int32_t, const std::vector<float>&, const JTF_WriteOptions&);
+	template void JTFFile::Write<double>(const std::string&, uint16_t, uint16_t, int32_t, int32_t, const std::vector<double>&, const JTF_WriteOptions&);
+	template void JTFFile::WriteElevations<float>(const std::string&, uint16_t, uint16_t, int32_t, int32_t, const std::vector<float>&, const JTF_WriteOptions&);
+	template void JTFFile::WriteElevations<double>(const std::string&, uint16_t, uint16_t, int32_t, int32_t, const std::vector<double>&, const JTF_WriteOptions&);
+	template void JTFFile::WriteElevations<float>(const std::string&, uint16_t, uint16_t, const std::vector<float>&, const JTF_WriteOptions&);
+	template void JTFFile::WriteElevations<double>(const std::string&, uint16_t, uint16_t, const std::vector<double>&, const JTF_WriteOptions&);
+	template void JTFFile::Normalize<float>(std::span<const float>, int32_t, int32_t, std::span<float>, double, double, uint32_t);
+	template void JTFFile::Normalize<double>(std::span<const double>, int32_t, int32_t, std::span<double>, double, double, uint32_t);
+	template class JTFStreamWriter<float>;
+	template class JTFStreamWriter<double>;
 
 }
\ No newline at end of file
@@ -0,0 +1,394 @@
+// MIT License
+//  2025 Cybex Interactive & Matthias Simon Gut (aka Cybex)
+// See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
+
+// jtf_bench: throughput of write, read, selective read and CRC over square 32 and 64 bit maps, with warm and cold page cache.
+// Results are printed as a table and written as JSON, to be compared between releases.
+//
+// usage: jtf_bench [--sizes 257,513,...] [--bits 32,64] [--layouts linear,tiled,compressed] [--iterations N] [--threads N,...|sweep] [--dir path] [--output file.json]
+
+#include "jtf.h"
+#include "jtf_convert.h"
+#include "jtf_version.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace cybex_interactive::jtf;
+
+struct BenchOptions
+{
+	vector<uint16_t> Sizes = { 257, 513, 1025, 2049, 4097 };
+	vector<uint8_t> BitDepths = { 32, 64 };
+	vector<string> Layouts = { "linear", "tiled", "compressed" };
+	uint32_t Iterations = 5;
+	vector<uint32_t> ThreadCounts = { 0 };	// write and read run once per count, 0 = hardware concurrency
+	filesystem::path Directory = filesystem::temp_directory_path() / "jtf_bench";
+	string Output = "jtf_bench.json";
+};
+
+struct BenchResult
+{
+	string Benchmark;
+	string Layout;
+	string Cache;	// "warm" or "cold"
+	uint16_t Size = 0;
+	uint8_t BitDepth = 0;
+	uint32_t ThreadCount = 0;
+	uint64_t Bytes = 0;
+	uint64_t Samples = 0;
+	double MinSeconds = 0.0;
+	double MedianSeconds = 0.0;
+};
+
+static vector<string> Split(const string& list)
+{
+	vector<string> items;
+	stringstream stream(list);
+	for (string item; getline(stream, item, ',');)
+		if (!item.empty()) items.push_back(item);
+	return items;
+}
+
+static void PrintUsage()
+{
+	cerr << "usage: jtf_bench [--sizes 257,513,...] [--bits 32,64] [--layouts linear,tiled,compressed] [--iterations N] [--threads N,...|sweep] [--dir path] [--output file.json]\n"
+		"  --threads sweep runs write and read at 1, 2, 4 ... hardware concurrency threads, 0 = hardware concurrency." << endl;
+}
+
+// whole argument as unsigned decimal in [0..limit], no exceptions on malformed input
+static bool ParseNumber(const string& text, uint32_t limit, uint32_t& value)
+{
+	const char* end = text.data() + text.size();
+	auto [last, error] = from_chars(text.data(), end, value);
+	if (text.empty() || error != errc() || last != end || value > limit)
+	{
+		cerr << format("Invalid number '{}', expected [0..{}].", text, limit) << endl;
+		return false;
+	}
+	return true;
+}
+
+static bool ParseList(const string& list, uint32_t limit, vector<uint32_t>& values)
+{
+	values.clear();
+	for (const string& item : Split(list))
+		if (!ParseNumber(item, limit, values.emplace_back()))
+			return false;
+	if (values.empty())
+	{
+		cerr << format("Empty list '{}'.", list) << endl;
+		return false;
+	}
+	return true;
+}
+
+// 1, 2, 4 ... up to and including the hardware concurrency
+static vector<uint32_t> ThreadSweep()
+{
+	uint32_t hardwareThreads = max(1u, thread::hardware_concurrency());
+	vector<uint32_t> threadCounts;
+	for (uint32_t threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+		threadCounts.push_back(threadCount);
+	threadCounts.push_back(hardwareThreads);
+	return threadCounts;
+}
+
+static bool ParseArguments(int argc, char** argv, BenchOptions& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		string argument = argv[i];
+		if (argument == "--help" || argument == "-h")
+			return false;
+		if (i + 1 >= argc)
+		{
+			cerr << format("Missing value for '{}'.", argument) << endl;
+			return false;
+		}
+		string value = argv[++i];
+
+		vector<uint32_t> values;
+		if (argument == "--sizes")
+		{
+			if (!ParseList(value, MAP_AXIS_SIZE_LIMIT, values)) return false;
+			options.Sizes.assign(values.begin(), values.end());
+		}
+		else if (argument == "--bits")
+		{
+			if (!ParseList(value, 64, values)) return false;
+			options.BitDepths.assign(values.begin(), values.end());
+		}
+		else if (argument == "--layouts") options.Layouts = Split(value);
+		else if (argument == "--iterations")
+		{
+			if (!ParseNumber(value, 1000000, options.Iterations)) return false;
+			options.Iterations = max(1u, options.Iterations);
+		}
+		else if (argument == "--threads")
+		{
+			if (value == "sweep") options.ThreadCounts = ThreadSweep();
+			else if (!ParseList(value, 4096, options.ThreadCounts)) return false;
+		}
+		else if (argument == "--dir") options.Directory = value;
+		else if (argument == "--output") options.Output = value;
+		else
+		{
+			cerr << format("Unknown argument '{}'.", argument) << endl;
+			return false;
+		}
+	}
+
+	for (uint16_t size : options.Sizes)
+		if (size == 0 || size > MAP_AXIS_SIZE_LIMIT)
+		{
+			cerr << format("Map size [{}] outside of [1..{}].", size, MAP_AXIS_SIZE_LIMIT) << endl;
+			return false;
+		}
+	for (uint8_t bitDepth : options.BitDepths)
+		if (bitDepth != 32 && bitDepth != 64)
+		{
+			cerr << format("Bit depth [{}] not benchmarked, expected [32] or [64].", bitDepth) << endl;
+			return false;
+		}
+	for (const string& layout : options.Layouts)
+		if (layout != "linear" && layout != "tiled" && layout != "compressed")
+		{
+			cerr << format("Unknown layout '{}', expected linear, tiled or compressed.", layout) << endl;
+			return false;
+		}
+	return true;
+}
+
+// deterministic terrain: a few octaves of sines plus low amplitude noise, compressible like real height maps
+template<typename T> static vector<T> GenerateHeights(uint16_t size)
+{
+	vector<T> heights(size_t(size) * size);
+	uint32_t noise = 0x9E3779B9u;
+	for (uint32_t y = 0; y < size; ++y)
+		for (uint32_t x = 0; x < size; ++x)
+		{
+			noise = noise * 1664525u + 1013904223u;
+			double u = double(x) / size;
+			double v = double(y) / size;
+			double height = 0.5
+				+ 0.25 * sin(u * 6.2831853) * cos(v * 6.2831853)
+				+ 0.125 * sin(u * 31.0 + v * 17.0)
+				+ 0.0625 * sin(u * 97.0) * sin(v * 89.0)
+				+ (noise >> 8) * (0.001 / 16777216.0);
+			heights[size_t(y) * size + x] = static_cast<T>(height);
+		}
+	return heights;
+}
+
+static JTF_WriteOptions WriteOptionsFor(const string& layout, uint32_t threadCount)
+{
+	JTF_WriteOptions options;
+	options.ThreadCount = threadCount;
+	if (layout == "tiled") options.Layout = JTF_Layout::Tiled;
+	if (layout == "compressed") options.Compression = JTF_Compression::PredictiveLZ;
+	return options;
+}
+
+// drop the file from the page cache so the next read hits the storage device, false if the platform offers no way to
+static bool EvictFromCache(const filesystem::path& filePath)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+	(void)filePath;
+	return false;
+#else
+	int file = ::open(filePath.c_str(), O_RDONLY);
+	if (file < 0) return false;
+	// dirty pages cannot be dropped, flush them first
+	bool evicted = ::fdatasync(file) == 0 && ::posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	::close(file);
+	return evicted;
+#endif
+}
+
+// run task iterations times and record min and median seconds, prepare runs untimed before every iteration
+static void Measure(BenchResult& result, uint32_t iterations, const function<void()>& prepare, const function<void()>& task)
+{
+	vector<double> seconds;
+	seconds.reserve(iterations);
+	for (uint32_t i = 0; i < iterations; ++i)
+	{
+		if (prepare) prepare();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		task();
+		seconds.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+	}
+	sort(seconds.begin(), seconds.end());
+	result.MinSeconds = seconds.front();
+	result.MedianSeconds = seconds[seconds.size() / 2];
+}
+
+static double MegabytesPerSecond(const BenchResult& result)
+{
+	return result.MedianSeconds > 0.0 ? result.Bytes / 1.0e6 / result.MedianSeconds : 0.0;
+}
+
+static double SamplesPerSecond(const BenchResult& result)
+{
+	return result.MedianSeconds > 0.0 ? result.Samples / result.MedianSeconds : 0.0;
+}
+
+static void PrintResult(const BenchResult& result)
+{
+	cout << format("{:<16} {:<10} {:<4} {:>5}^2 {:>2} bit {:>3} thr {:>10.3f} ms {:>10.1f} MB/s {:>8.1f} MSamples/s",
+		result.Benchmark, result.Layout, result.Cache, result.Size, result.BitDepth, result.ThreadCount,
+		result.MedianSeconds * 1.0e3, MegabytesPerSecond(result), SamplesPerSecond(result) / 1.0e6) << endl;
+}
+
+template<typename T> static void RunMap(const BenchOptions& options, uint16_t size, uint8_t bitDepth, bool& coldSupported, vector<BenchResult>& results)
+{
+	vector<T> heights = GenerateHeights<T>(size);
+	uint64_t sampleCount = uint64_t(size) * size;
+
+	for (const string& layout : options.Layouts)
+	{
+		filesystem::path filePath = options.Directory / format("bench_{}_{}_{}.jtf", size, bitDepth, layout);
+		string path = filePath.string();
+		uint32_t threadCount = 0;
+
+		auto add = [&](const string& benchmark, const string& cache, uint64_t bytes, uint64_t samples, const function<void()>& prepare, const function<void()>& task)
+			{
+				BenchResult result{ benchmark, layout, cache, size, bitDepth, threadCount, bytes, samples };
+				Measure(result, options.Iterations, prepare, task);
+				results.push_back(result);
+				PrintResult(result);
+			};
+
+		// write and full reads once per thread count, output does not depend on it
+		uint64_t fileSize = 0;
+		vector<T> destination(sampleCount);
+		for (uint32_t sweepCount : options.ThreadCounts)
+		{
+			threadCount = sweepCount;
+			JTF_WriteOptions writeOptions = WriteOptionsFor(layout, threadCount);
+			JTF_ReadOptions readOptions;
+			readOptions.ThreadCount = threadCount;
+
+			// write, the file size is only known afterwards
+			JTFFile::Write(path, size, size, -1, 1, heights, writeOptions);
+			fileSize = filesystem::file_size(filePath);
+			add("write", "warm", fileSize, sampleCount, nullptr, [&]() { JTFFile::Write(path, size, size, -1, 1, heights, writeOptions); });
+
+			add("read", "warm", fileSize, sampleCount, [&]() { JTFFile::Read(path, readOptions); }, [&]() { JTFFile::Read(path, readOptions); });
+			if (coldSupported && EvictFromCache(filePath))
+				add("read", "cold", fileSize, sampleCount, [&]() { EvictFromCache(filePath); }, [&]() { JTFFile::Read(path, readOptions); });
+			else
+				coldSupported = false;
+
+			// reusable reader decoding into a caller buffer
+			JTFReader reader(readOptions);
+			add("reader_into", "warm", fileSize, sampleCount, [&]() { reader.ReadInto<T>(path, destination); }, [&]() { reader.ReadInto<T>(path, destination); });
+		}
+
+		// selective reads, header only (signature and HEAD chunk) and heights without file CRC verification, default threads
+		threadCount = 0;
+		add("read_head", "warm", 8 + 44, 0, nullptr, [&]() { JTFFile::Read(path, { "HEAD" }, false); });
+		add("read_heights", "warm", fileSize, sampleCount, nullptr, [&]() { JTFFile::Read(path, { "HMAP" }, false); });
+
+		filesystem::remove(filePath);
+	}
+
+	// crc over the raw sample bytes, independent of layout
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(heights.data());
+	size_t byteCount = heights.size() * sizeof(T);
+	volatile uint32_t sink = 0;
+	BenchResult crc{ "crc32", "-", "warm", size, bitDepth, 1, byteCount, sampleCount };
+	Measure(crc, options.Iterations, nullptr, [&]() { sink = Crc32::Hash(bytes, byteCount); });
+	results.push_back(crc);
+	PrintResult(crc);
+	(void)sink;
+}
+
+static bool WriteJson(const BenchOptions& options, bool coldSupported, const vector<BenchResult>& results)
+{
+	ofstream file(options.Output, ios::binary | ios::trunc);
+	if (!file)
+	{
+		cerr << format("Cannot open '{}' for writing.", options.Output) << endl;
+		return false;
+	}
+
+	file << "{\n";
+	file << format("  \"library\": \"jtf\",\n  \"version\": \"{}\",\n", JTF_VERSION_STR);
+	file << format("  \"crcEngine\": \"{}\",\n", Crc32::GetEngineName());
+	file << format("  \"sampleKernel\": \"{}\",\n", SampleConverter::GetKernelName());
+	string threadCounts;
+	for (uint32_t threadCount : options.ThreadCounts)
+		threadCounts += format("{}{}", threadCounts.empty() ? "" : ", ", threadCount);
+	file << format("  \"hardwareThreads\": {},\n  \"threadCounts\": [{}],\n", thread::hardware_concurrency(), threadCounts);
+	file << format("  \"iterations\": {},\n  \"coldCacheSupported\": {},\n", options.Iterations, coldSupported ? "true" : "false");
+	file << "  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchResult& result = results[i];
+		file << format("    {{ \"benchmark\": \"{}\", \"layout\": \"{}\", \"cache\": \"{}\", \"width\": {}, \"height\": {}, \"bitDepth\": {}, \"threadCount\": {}, "
+			"\"bytes\": {}, \"samples\": {}, \"minSeconds\": {:.9f}, \"medianSeconds\": {:.9f}, \"megabytesPerSecond\": {:.3f}, \"samplesPerSecond\": {:.1f} }}{}\n",
+			result.Benchmark, result.Layout, result.Cache, result.Size, result.Size, result.BitDepth, result.ThreadCount,
+			result.Bytes, result.Samples, result.MinSeconds, result.MedianSeconds, MegabytesPerSecond(result), SamplesPerSecond(result),
+			i + 1 < results.size() ? "," : "");
+	}
+	file << "  ]\n}\n";
+	return static_cast<bool>(file);
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	if (!ParseArguments(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	filesystem::create_directories(options.Directory);
+
+	cout << format("JTF {} benchmark, CRC engine {}, sample kernel {}, {} iterations (median)", JTF_VERSION_STR, Crc32::GetEngineName(), SampleConverter::GetKernelName(), options.Iterations) << endl;
+	cout << "----------------------------------------------------------------------------------------------------" << endl;
+
+	bool coldSupported = true;
+	vector<BenchResult> results;
+	try
+	{
+		for (uint16_t size : options.Sizes)
+			for (uint8_t bitDepth : options.BitDepths)
+			{
+				if (bitDepth == 32) RunMap<float>(options, size, bitDepth, coldSupported, results);
+				else RunMap<double>(options, size, bitDepth, coldSupported, results);
+			}
+	}
+	catch (const exception& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+
+	if (!coldSupported)
+		cout << "Cold cache reads skipped, page cache eviction is not available on this platform." << endl;
+
+	if (!WriteJson(options, coldSupported, results))
+		return 1;
+	cout << format("Results written to '{}'.", options.Output) << endl;
+	return 0;
+}
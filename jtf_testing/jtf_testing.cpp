@@ -3,16 +3,45 @@
 // See LICENSE.md for full license text (https://raw.githubusercontent.com/CybexInteractive/JanumachineTerrainFormat/main/LICENSE.md).
 
 #include "jtf_c_api.h"
+#include "jtf.h"
+#include "jtf_codec.h"
+#include "jtf_convert.h"
+#include "jtf_query.h"
+#include "jtf_reader.h"
+#include "jtf_stats.h"
+#include "jtf_view.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <fstream>
 #include <format>
+#include <random>
 #include <filesystem>
+#include <span>
+#include <tuple>
+#include <variant>
 #include <vector>
 
 using namespace std;
+namespace jtf = cybex_interactive::jtf;
+
+static int failureCount = 0;
+
+static string Verdict(bool passed)
+{
+	if (!passed) ++failureCount;
+	return passed ? "[OK]" : "[Fail]";
+}
 
 static string ResultCompare(JTF_Result expected, JTF_Result result)
 {
-	return expected == result ? "[OK]" : "[Fail]";
+	return Verdict(expected == result);
 }
 
 static string PrintResult(JTF_Result result)
@@ -103,27 +132,1631 @@ void RunWriteReadTest(const char* filePath, uint16_t width, uint16_t height, int
 	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
 }
 
-int main()
+// normalized test pattern in [0, 1], distinct per sample
+static double PatternSample(size_t x, size_t y)
+{
+	return double((x * 37 + y * 101) % 1009) / 1008.0;
+}
+
+template<typename T> static vector<T> PatternSamples(uint16_t width, uint16_t height)
+{
+	vector<T> samples(size_t(width) * height);
+	for (size_t y = 0; y < height; ++y)
+		for (size_t x = 0; x < width; ++x)
+			samples[y * width + x] = T(PatternSample(x, y));
+	return samples;
+}
+
+// written samples compared to read samples within half a quantization step of the bit depth, widened by the rounding of the
+// sample scaled in T precision (exact for float and double)
+template<typename T> static bool RoundTripMatches(const vector<T>& written, const vector<double>& read, uint8_t bitDepth)
+{
+	if (read.size() != written.size()) return false;
+	double steps = bitDepth == 8 ? 255.0 : bitDepth == 16 ? 65535.0 : 0.0;
+	double tolerance = steps == 0.0 ? 0.0 : (0.5 + numeric_limits<T>::epsilon() * steps) / steps;
+	for (size_t i = 0; i < written.size(); ++i)
+		if (std::abs(double(written[i]) - read[i]) > tolerance) return false;
+	return true;
+}
+
+// native samples hold the file's bit depth: float, double or raw UNORM integers
+static bool NativeMatches(const jtf::JTF_NativeHeights& native, uint8_t bitDepth, size_t count)
+{
+	switch (bitDepth)
+	{
+	case 8: return holds_alternative<vector<uint8_t>>(native.HeightSamples) && get<vector<uint8_t>>(native.HeightSamples).size() == count;
+	case 16: return holds_alternative<vector<uint16_t>>(native.HeightSamples) && get<vector<uint16_t>>(native.HeightSamples).size() == count;
+	case 32: return holds_alternative<vector<float>>(native.HeightSamples) && get<vector<float>>(native.HeightSamples).size() == count;
+	case 64: return holds_alternative<vector<double>>(native.HeightSamples) && get<vector<double>>(native.HeightSamples).size() == count;
+	default: return false;
+	}
+}
+
+template<typename T> void RunRoundTripCase(const char* filePath, jtf::JTF_Layout layout, jtf::JTF_Compression compression, uint8_t bitDepth)
+{
+	// single row and column maps, a map smaller than one tile and maps with partial edge tiles
+	struct Size { uint16_t Width, Height, TileSize; };
+	const Size sizes[] = { { 1, 1, 16 }, { 1, 23, 16 }, { 23, 1, 16 }, { 37, 19, 16 }, { 257, 3, 256 }, { 300, 270, 256 } };
+
+	uint8_t fileBitDepth = bitDepth != 0 ? bitDepth : uint8_t(sizeof(T) * 8);
+	string failures;
+	for (const Size& size : sizes)
+	{
+		vector<T> heights = PatternSamples<T>(size.Width, size.Height);
+
+		jtf::JTF_WriteOptions writeOptions;
+		writeOptions.Layout = layout;
+		writeOptions.TileSize = size.TileSize;
+		writeOptions.Compression = compression;
+		writeOptions.BitDepth = bitDepth;
+
+		bool passed = false;
+		try
+		{
+			jtf::JTFFile::Write(filePath, size.Width, size.Height, -50, 150, heights, writeOptions);
+			jtf::JTF data = jtf::JTFFile::Read(filePath);
+			jtf::JTF_Native native = jtf::JTFFile::ReadNative(filePath);
+			passed = data.Header.Width == size.Width && data.Header.Height == size.Height && data.Header.BitDepth == fileBitDepth
+				&& data.Header.Layout == layout && data.Header.Compression == compression
+				&& RoundTripMatches(heights, data.Heights.HeightSamples, fileBitDepth)
+				&& NativeMatches(native.Heights, fileBitDepth, heights.size());
+		}
+		catch (const std::exception& e)
+		{
+			cout << e.what();
+		}
+		if (!passed) failures += format(" {}x{}", size.Width, size.Height);
+	}
+
+	const char* layoutName = compression == jtf::JTF_Compression::PredictiveLZ ? "HCMP" : layout == jtf::JTF_Layout::Tiled ? "HTIL" : "HMAP";
+	cout << format("Round trip ({}, {} bit from {}):\t {}{}", layoutName, fileBitDepth, sizeof(T) == 4 ? "float" : "double",
+		Verdict(failures.empty()), failures.empty() ? "" : " failed at" + failures) << endl;
+}
+
+void RunRoundTripTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Every layout and bit depth reads back what was written, including 1 sample wide or high maps and partial edge tiles." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const pair<jtf::JTF_Layout, jtf::JTF_Compression> layouts[] = {
+		{ jtf::JTF_Layout::Linear, jtf::JTF_Compression::None },
+		{ jtf::JTF_Layout::Tiled, jtf::JTF_Compression::None },
+		{ jtf::JTF_Layout::Linear, jtf::JTF_Compression::PredictiveLZ } };
+
+	for (auto [layout, compression] : layouts)
+	{
+		for (uint8_t bitDepth : { uint8_t(0), uint8_t(16), uint8_t(8) })
+		{
+			RunRoundTripCase<float>(filePath, layout, compression, bitDepth);
+			RunRoundTripCase<double>(filePath, layout, compression, bitDepth);
+		}
+	}
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+static vector<uint8_t> LoadBytes(const char* filePath)
+{
+	ifstream file(filePath, ios::binary);
+	return vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+static void StoreBytes(const char* filePath, const vector<uint8_t>& bytes)
+{
+	ofstream file(filePath, ios::binary | ios::trunc);
+	file.write(reinterpret_cast<const char*>(bytes.data()), streamsize(bytes.size()));
+}
+
+static bool ReadFails(const char* filePath)
+{
+	try
+	{
+		jtf::JTFFile::Read(filePath);
+		return false;
+	}
+	catch (const std::exception&)
+	{
+		return true;
+	}
+}
+
+void RunEarlyExitTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Requested height read without file CRC verification stops after the height chunk." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	vector<double> heights = PatternSamples<double>(64, 64);
+	jtf::JTF_WriteOptions writeOptions;
+	for (jtf::JTF_Compression compression : { jtf::JTF_Compression::None, jtf::JTF_Compression::PredictiveLZ })
+	{
+		// the file is cut behind the height chunk, 'FEND' (12 bytes) and the file CRC (4 bytes) are missing
+		writeOptions.Compression = compression;
+		jtf::JTFFile::Write(filePath, 64, 64, 0, 100, heights, writeOptions);
+		vector<uint8_t> bytes = LoadBytes(filePath);
+		bytes.resize(bytes.size() - 16);
+		StoreBytes(filePath, bytes);
+
+		bool stoppedEarly = false;
+		try
+		{
+			stoppedEarly = jtf::JTFFile::Read(filePath, { "HMAP" }, false).Heights.HeightSamples == heights;
+		}
+		catch (const std::exception& e)
+		{
+			cout << e.what();
+		}
+		bool fullReadFails = ReadFails(filePath);
+		cout << format("Early exit ({}):\t {} requested read stops before the missing FEND, full read {}",
+			compression == jtf::JTF_Compression::None ? "HMAP" : "HCMP", Verdict(stoppedEarly && fullReadFails), fullReadFails ? "fails" : "succeeds") << endl;
+	}
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+template<typename T> static void RunDamagedCodecCase(const vector<T>& heights, uint16_t width, uint16_t height, uint8_t bitDepth)
+{
+	vector<uint8_t> payload = jtf::HeightCodec::Encode(heights.data(), width, height);
+
+	vector<double> samples(heights.size());
+	size_t truncationsAccepted = 0;
+	for (size_t length = 0; length < payload.size(); ++length)
+	{
+		// exact size copy, so any over-read leaves the allocation
+		vector<uint8_t> truncated(payload.begin(), payload.begin() + length);
+		if (jtf::HeightCodec::Decode(truncated.data(), truncated.size(), width, height, bitDepth, samples.data()))
+			++truncationsAccepted;
+	}
+
+	vector<uint8_t> damaged = payload;
+	for (size_t i = 0; i < damaged.size(); ++i)
+	{
+		for (uint8_t bit : { uint8_t(0x01), uint8_t(0x80) })
+		{
+			damaged[i] ^= bit;
+			jtf::HeightCodec::Decode(damaged.data(), damaged.size(), width, height, bitDepth, samples.data());
+			damaged[i] ^= bit;
+		}
+	}
+
+	cout << format("Damaged codec ({} bit):\t {} {} truncations accepted, {} bit flips survived", bitDepth,
+		Verdict(truncationsAccepted == 0), truncationsAccepted, damaged.size() * 2) << endl;
+}
+
+void RunDamagedHcmpTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Damaged HCMP payloads are rejected without reading or writing out of bounds." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const uint16_t width = 67, height = 41;
+	vector<float> heights = PatternSamples<float>(width, height);
+
+	// codec: every truncation is rejected, single bit flips may decode garbage but must stay in bounds
+	vector<uint16_t> unorm16(heights.size());
+	vector<uint8_t> unorm8(heights.size());
+	for (size_t i = 0; i < heights.size(); ++i)
+	{
+		unorm16[i] = uint16_t(std::lround(heights[i] * 65535.0));
+		unorm8[i] = uint8_t(std::lround(heights[i] * 255.0));
+	}
+	RunDamagedCodecCase(unorm8, width, height, 8);
+	RunDamagedCodecCase(unorm16, width, height, 16);
+	RunDamagedCodecCase(heights, width, height, 32);
+	RunDamagedCodecCase(vector<double>(heights.begin(), heights.end()), width, height, 64);
+
+	// file: locate the HCMP chunk behind the signature, its length field precedes the type
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.Compression = jtf::JTF_Compression::PredictiveLZ;
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights, writeOptions);
+	vector<uint8_t> original = LoadBytes(filePath);
+	const uint8_t hcmpTag[] = { 'H', 'C', 'M', 'P' };
+	size_t typeOffset = size_t(search(original.begin() + 8, original.end(), begin(hcmpTag), end(hcmpTag)) - original.begin());
+	size_t payloadOffset = typeOffset + 4;
+	uint32_t payloadSize = uint32_t(original[typeOffset - 4]) | uint32_t(original[typeOffset - 3]) << 8 | uint32_t(original[typeOffset - 2]) << 16 | uint32_t(original[typeOffset - 1]) << 24;
+
+	// a flipped payload byte fails the chunk CRC
+	vector<uint8_t> bytes = original;
+	bytes[payloadOffset + payloadSize / 2] ^= 0xFF;
+	StoreBytes(filePath, bytes);
+	bool flippedRejected = ReadFails(filePath);
+	cout << format("Damaged file (flip):\t {} payload byte flip rejected", Verdict(flippedRejected)) << endl;
+
+	// an oversized band with a matching chunk CRC reaches the decoder, which must reject it
+	bytes = original;
+	for (size_t i = 0; i < 4; ++i) bytes[payloadOffset + 8 + i] = 0xFF; // first entry of the band table
+	uint32_t chunkCrc = jtf::Crc32::Hash(bytes.data() + typeOffset, 4 + size_t(payloadSize));
+	for (size_t i = 0; i < 4; ++i) bytes[payloadOffset + payloadSize + i] = uint8_t(chunkCrc >> (8 * i));
+	StoreBytes(filePath, bytes);
+	bool bandRejected = ReadFails(filePath);
+	cout << format("Damaged file (band):\t {} oversized band rejected behind a valid chunk CRC", Verdict(bandRejected)) << endl;
+
+	// a file cut inside the HCMP payload
+	bytes.assign(original.begin(), original.begin() + payloadOffset + payloadSize / 2);
+	StoreBytes(filePath, bytes);
+	bool truncatedRejected = ReadFails(filePath);
+	cout << format("Damaged file (cut):\t {} truncated payload rejected", Verdict(truncatedRejected)) << endl;
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+void RunChunkDirectoryTest(const char* filePath)
+{
+	cout << "Descritption:\t\t HEAD announces the chunk directory, seeked chunks match their entry CRC, a damaged directory frame fails before its entries are allocated." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const uint16_t width = 33, height = 17;
+	vector<double> heights = PatternSamples<double>(width, height);
+	jtf::JTF_WriteOptions writeOptions;
+
+	// without a directory the tail is not probed and the sequential read is used
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights, writeOptions);
+	bool absent = !jtf::JTFFile::ReadHeader(filePath).ChunkDirectory && jtf::JTFFile::ReadChunkDirectory(filePath).empty()
+		&& jtf::JTFFile::Read(filePath, { "HMAP" }, true).Heights.HeightSamples == heights;
+	cout << format("Without HDIR:\t\t {} not announced, requested read sequential", Verdict(absent)) << endl;
+
+	writeOptions.ChunkDirectory = true;
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights, writeOptions);
+	vector<jtf::JTF_ChunkEntry> directory = jtf::JTFFile::ReadChunkDirectory(filePath);
+	bool present = jtf::JTFFile::ReadHeader(filePath).ChunkDirectory && directory.size() == 2
+		&& jtf::JTFFile::Read(filePath, { "HMAP" }, true).Heights.HeightSamples == heights;
+	cout << format("With HDIR:\t\t {} announced, {} entries, requested read seeks", Verdict(present), directory.size()) << endl;
+
+	// a changed HMAP byte behind a re-stamped chunk CRC no longer matches the CRC listed by the directory
+	vector<uint8_t> original = LoadBytes(filePath);
+	vector<uint8_t> bytes = original;
+	auto hmap = find_if(directory.begin(), directory.end(), [](const jtf::JTF_ChunkEntry& entry) { return entry.Type == jtf::CHUNK_ID_HMAP; });
+	size_t typeOffset = size_t(hmap->Offset) + 4;
+	bytes[typeOffset + 4 + hmap->Length / 2] ^= 0xFF;
+	uint32_t chunkCrc = jtf::Crc32::Hash(bytes.data() + typeOffset, 4 + size_t(hmap->Length));
+	for (size_t i = 0; i < 4; ++i) bytes[typeOffset + 4 + hmap->Length + i] = uint8_t(chunkCrc >> (8 * i));
+	StoreBytes(filePath, bytes);
+	string message;
+	try
+	{
+		jtf::JTFFile::Read(filePath, { "HMAP" }, true);
+	}
+	catch (const std::exception& e)
+	{
+		message = e.what();
+	}
+	bool restampedRejected = message.find("CRC does not match HDIR entry") != string::npos;
+	cout << format("Re-stamped HMAP CRC:\t {} rejected:\n{}", Verdict(restampedRejected), message) << endl;
+
+	// entry count one short of the stored entries, the frame length no longer matches, the tail is [..][count][CRC][FEND 12][file CRC 4]
+	bytes = original;
+	size_t countOffset = bytes.size() - 16 - 4 - 4;
+	bytes[countOffset] -= 1;
+	StoreBytes(filePath, bytes);
+
+	jtf::JTF_Stats stats;
+	jtf::JTF_ReadOptions readOptions;
+	readOptions.Stats = &stats;
+	message.clear();
+	try
+	{
+		jtf::JTFFile::Read(filePath, { "HMAP" }, true, readOptions);
+	}
+	catch (const std::exception& e)
+	{
+		message = e.what();
+	}
+	bool rejected = message.find("HDIR chunk missing") != string::npos && stats.AllocatedBytes == 0;
+	cout << format("Damaged HDIR frame:\t {} rejected, {} bytes allocated:\n{}", Verdict(rejected), stats.AllocatedBytes, message) << endl;
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+// interop layout of the JTF handle as seen by C and managed callers, see jtf_c_api.cpp
+struct JTF_Interop
+{
+	uint8_t VersionMajor;
+	uint8_t VersionMinor;
+	uint8_t VersionPatch;
+	uint16_t Width;
+	uint16_t Height;
+	uint8_t BitDepth;
+	int32_t BoundsLower;
+	int32_t BoundsUpper;
+	double* HeightSamples;
+	uint32_t HeightSampleCount;
+	void* NativeHeightSamples;
+};
+
+static string PrintLog(const char* call, JTF_Result expected, const JTF_Log& log)
+{
+	return format("{} result:\t {} {}:\n{}", call, ResultCompare(expected, log.result), PrintResult(log.result), log.message);
+}
+
+void RunCApiTest(const char* filePath)
+{
+	cout << "Descritption:\t\t C API header, caller buffer, native and batch reads." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const uint16_t width = 5, height = 3;
+	vector<double> heights = PatternSamples<double>(width, height);
+	Write(filePath, width, height, -50, 150, heights.data(), heights.size());
+
+	// header only
+	JTF_Info info{};
+	JTF_Log log = ReadInfo(filePath, &info);
+	cout << PrintLog("ReadInfo", JTF_SUCCESS, log) << endl;
+	bool infoMatches = info.Width == width && info.Height == height && info.BitDepth == 64 && info.SampleCount == heights.size()
+		&& info.BoundsLower == -50 && info.BoundsUpper == 150 && info.Layout == 0 && info.Compression == 0;
+	cout << format("ReadInfo header:\t {} {}x{}, {} bit, {} samples, bounds [{}..{}]", Verdict(infoMatches),
+		info.Width, info.Height, info.BitDepth, info.SampleCount, info.BoundsLower, info.BoundsUpper) << endl << endl;
+
+	// caller buffers, exactly sized and one sample short
+	vector<double> doubles(heights.size());
+	log = ReadIntoDouble(filePath, doubles.data(), doubles.size(), nullptr);
+	cout << PrintLog("ReadIntoDouble", JTF_SUCCESS, log) << endl;
+	cout << format("ReadIntoDouble samples:\t {}", Verdict(doubles == heights)) << endl;
+	log = ReadIntoDouble(filePath, doubles.data(), doubles.size() - 1, nullptr);
+	cout << PrintLog("ReadIntoDouble", JTF_INVALID_ARGUMENT, log) << endl;
+
+	vector<float> floats(heights.size());
+	info = JTF_Info{};
+	log = ReadIntoFloat(filePath, floats.data(), floats.size(), &info);
+	cout << PrintLog("ReadIntoFloat", JTF_SUCCESS, log) << endl;
+	bool floatsMatch = info.SampleCount == heights.size();
+	for (size_t i = 0; i < heights.size(); ++i)
+		floatsMatch = floatsMatch && floats[i] == float(heights[i]);
+	cout << format("ReadIntoFloat samples:\t {}", Verdict(floatsMatch)) << endl;
+	log = ReadIntoFloat(filePath, floats.data(), floats.size() - 1, nullptr);
+	cout << PrintLog("ReadIntoFloat", JTF_INVALID_ARGUMENT, log) << endl << endl;
+
+	// native samples of a 16 bit file are raw UNORM, HeightSamples stays null
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.BitDepth = 16;
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights, writeOptions);
+	JTF* file = nullptr;
+	log = ReadNative(filePath, &file);
+	cout << PrintLog("ReadNative", JTF_SUCCESS, log) << endl;
+	bool nativeMatches = false;
+	if (file)
+	{
+		const JTF_Interop* view = reinterpret_cast<const JTF_Interop*>(file);
+		nativeMatches = view->BitDepth == 16 && view->HeightSamples == nullptr && view->NativeHeightSamples != nullptr && view->HeightSampleCount == heights.size();
+		for (size_t i = 0; nativeMatches && i < heights.size(); ++i)
+			nativeMatches = static_cast<const uint16_t*>(view->NativeHeightSamples)[i] == uint16_t(std::lround(heights[i] * 65535.0));
+	}
+	cout << format("NativeHeightSamples:\t {} 16 bit raw UNORM samples", Verdict(nativeMatches)) << endl << endl;
+	Destroy(file);
+
+	// a missing file fails its own entry only
+	string missingPath = string(filePath) + ".missing";
+	const char* paths[] = { filePath, missingPath.c_str() };
+	JTF* files[2] = {};
+	JTF_Log logs[2] = {};
+	log = ReadBatch(paths, 2, 0, files, logs);
+	cout << PrintLog("ReadBatch", JTF_EXCEPTION, log) << endl;
+	cout << PrintLog("ReadBatch [0]", JTF_SUCCESS, logs[0]) << endl;
+	cout << PrintLog("ReadBatch [1]", JTF_EXCEPTION, logs[1]) << endl;
+	cout << format("ReadBatch handles:\t {} handle for the read file, null for the missing file", Verdict(files[0] != nullptr && files[1] == nullptr)) << endl;
+	Destroy(files[0]);
+	Destroy(files[1]);
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+void RunStatsTotalTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Stats of a write computing its bounds count the whole call once." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	// elevations spanning [-120..880], the write nests the bounds scan and the mapped write
+	const uint16_t width = 1024, height = 1024;
+	vector<double> elevations = PatternSamples<double>(width, height);
+	for (double& elevation : elevations) elevation = elevation * 1000.0 - 120.0;
+
+	jtf::JTF_Stats stats;
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.Stats = &stats;
+	auto start = chrono::steady_clock::now();
+	jtf::JTFFile::WriteElevations(filePath, width, height, elevations, writeOptions);
+	uint64_t wallNanoseconds = uint64_t(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+
+	bool countedOnce = stats.TotalNanoseconds > 0 && stats.TotalNanoseconds <= wallNanoseconds;
+	cout << format("WriteElevations total:\t {} {} ns of {} ns wall time", Verdict(countedOnce), stats.TotalNanoseconds, wallNanoseconds) << endl;
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+static atomic<int> asyncReadsCompleted = 0;
+
+void RunAsyncTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Async reads after querying the backend first, reads still in flight at exit must not outlive the decode pool." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	// the backend name creates the reader before any read
+	string backendName = jtf::JTFFile::GetAsyncBackendName();
+
+	const uint16_t width = 256, height = 256;
+	vector<double> heights = PatternSamples<double>(width, height);
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights);
+
+	bool matches = false;
+	try
+	{
+		matches = jtf::JTFFile::ReadAsync(filePath).get().Heights.HeightSamples == heights;
+	}
+	catch (const std::exception& e)
+	{
+		cout << e.what();
+	}
+	cout << format("ReadAsync ({}):\t {} samples match", backendName, Verdict(matches)) << endl;
+
+	// left in flight at exit, reads opened before the file is removed still complete, later ones fail
+	for (int i = 0; i < 16; ++i)
+		jtf::JTFFile::ReadAsync(filePath, [](jtf::JTF&&, exception_ptr) { ++asyncReadsCompleted; });
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+// streams the samples in bands of bandRows rows, the last band partial, and compares the file with JTFFile::Write()
+template<typename T> static bool StreamWriteMatches(const char* filePath, uint16_t width, uint16_t height, uint16_t bandRows)
+{
+	vector<T> heights = PatternSamples<T>(width, height);
+	string referencePath = string(filePath) + ".reference";
+	jtf::JTFFile::Write(referencePath, width, height, -50, 150, heights);
+
+	jtf::JTFStreamWriter<T> writer(filePath, width, height, -50, 150);
+	for (size_t row = 0; row < height; row += bandRows)
+	{
+		size_t rows = std::min<size_t>(bandRows, height - row);
+		writer.AppendRows(span<const T>(heights.data() + row * width, rows * width));
+	}
+	writer.Finish();
+
+	bool matches = writer.GetRowsWritten() == height && LoadBytes(filePath) == LoadBytes(referencePath.c_str());
+	filesystem::remove(referencePath);
+	return matches;
+}
+
+void RunStreamWriterTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Row band streaming writes the same bytes as JTFFile::Write(), an unfinished writer leaves the target untouched." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const uint16_t width = 37, height = 19;
+	for (uint16_t bandRows : { uint16_t(1), uint16_t(4), uint16_t(19) })
+	{
+		bool floatMatches = false, doubleMatches = false;
+		try
+		{
+			floatMatches = StreamWriteMatches<float>(filePath, width, height, bandRows);
+			doubleMatches = StreamWriteMatches<double>(filePath, width, height, bandRows);
+		}
+		catch (const std::exception& e)
+		{
+			cout << e.what();
+		}
+		cout << format("Stream write ({} rows):\t {} float, {} double byte identical", bandRows, Verdict(floatMatches), Verdict(doubleMatches)) << endl;
+	}
+
+	// dropped after 4 of 19 rows, neither the target nor a temporary file next to it is left changed
+	vector<double> heights = PatternSamples<double>(width, height);
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights);
+	vector<uint8_t> original = LoadBytes(filePath);
+	{
+		jtf::JTFStreamWriter<double> writer(filePath, width, height, -50, 150);
+		writer.AppendRows(span<const double>(heights.data(), size_t(width) * 4));
+	}
+	string tempPrefix = filesystem::path(filePath).filename().string() + ".";
+	size_t tempFiles = 0;
+	for (const filesystem::directory_entry& entry : filesystem::directory_iterator(filesystem::path(filePath).parent_path()))
+	{
+		string name = entry.path().filename().string();
+		if (name.starts_with(tempPrefix) && name.ends_with(".tmp")) ++tempFiles;
+	}
+	bool untouched = LoadBytes(filePath) == original && tempFiles == 0;
+	cout << format("Unfinished writer:\t {} target unchanged, {} temporary files left", Verdict(untouched), tempFiles) << endl;
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+// reads every row in bands of bandRows rows, compared with JTFFile::Read() converted to T
+template<typename T> static bool StreamReadMatches(const char* filePath, uint16_t bandRows, uint32_t& bandCount)
+{
+	vector<double> expected = jtf::JTFFile::Read(filePath).Heights.HeightSamples;
+	jtf::JTFStreamReader reader(filePath);
+	size_t width = reader.GetHeader().Width;
+	vector<T> band(width * bandRows);
+	vector<T> samples;
+	bandCount = 0;
+	while (uint32_t rows = reader.ReadRows(span<T>(band)))
+	{
+		samples.insert(samples.end(), band.begin(), band.begin() + rows * width);
+		++bandCount;
+	}
+
+	if (samples.size() != expected.size() || reader.GetRowsRemaining() != 0) return false;
+	for (size_t i = 0; i < samples.size(); ++i)
+		if (samples[i] != T(expected[i])) return false;
+	return true;
+}
+
+void RunStreamReaderTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Row band reads into float and double match JTFFile::Read(), a damaged HMAP payload is reported with the last row." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	// 19 rows in bands of 4 leave a final band of 3 rows
+	const uint16_t width = 37, height = 19, bandRows = 4;
+	for (uint8_t bitDepth : { uint8_t(32), uint8_t(64) })
+	{
+		if (bitDepth == 32) jtf::JTFFile::Write(filePath, width, height, -50, 150, PatternSamples<float>(width, height));
+		else jtf::JTFFile::Write(filePath, width, height, -50, 150, PatternSamples<double>(width, height));
+
+		bool floatMatches = false, doubleMatches = false;
+		uint32_t floatBands = 0, doubleBands = 0;
+		try
+		{
+			floatMatches = StreamReadMatches<float>(filePath, bandRows, floatBands);
+			doubleMatches = StreamReadMatches<double>(filePath, bandRows, doubleBands);
+		}
+		catch (const std::exception& e)
+		{
+			cout << e.what();
+		}
+		bool passed = floatMatches && doubleMatches && floatBands == 5 && doubleBands == 5;
+		cout << format("Stream read ({} bit):\t {} float, double in {}, {} bands of {} rows", bitDepth, Verdict(passed), floatBands, doubleBands, bandRows) << endl;
+	}
+
+	// a flipped byte in the first row is only detected by the chunk CRC once the last row is read
+	vector<uint8_t> bytes = LoadBytes(filePath);
+	const uint8_t hmapTag[] = { 'H', 'M', 'A', 'P' };
+	size_t payloadOffset = size_t(search(bytes.begin() + 8, bytes.end(), begin(hmapTag), end(hmapTag)) - bytes.begin()) + 4;
+	bytes[payloadOffset + 3] ^= 0x10;
+	StoreBytes(filePath, bytes);
+
+	uint32_t rowsBeforeError = 0;
+	string message;
+	try
+	{
+		jtf::JTFStreamReader reader(filePath);
+		vector<double> band(size_t(width) * bandRows);
+		while (reader.ReadRows(span<double>(band)))
+			rowsBeforeError = reader.GetRowsRead();
+	}
+	catch (const std::exception& e)
+	{
+		message = e.what();
+	}
+	bool reportedLast = !message.empty() && rowsBeforeError == 16;
+	cout << format("Damaged HMAP:\t\t {} reported reading the final band after {} rows:\n{}", Verdict(reportedLast), rowsBeforeError, message) << endl;
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+void RunRegionTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Regions of linear, tiled and compressed files match the cropped full read, at the map edges as well." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	// 64 sample tiles leave partial tiles at the right and bottom edge
+	const uint16_t width = 300, height = 170;
+	vector<double> heights = PatternSamples<double>(width, height);
+	struct Region { uint16_t X, Y, Width, Height; };
+	const Region regions[] = { { 0, 0, 1, 1 }, { 299, 169, 1, 1 }, { 63, 63, 2, 2 }, { 10, 20, 100, 30 }, { 250, 100, 50, 70 }, { 0, 169, 300, 1 }, { 0, 0, 300, 170 } };
+
+	const pair<jtf::JTF_Layout, jtf::JTF_Compression> layouts[] = {
+		{ jtf::JTF_Layout::Linear, jtf::JTF_Compression::None },
+		{ jtf::JTF_Layout::Tiled, jtf::JTF_Compression::None },
+		{ jtf::JTF_Layout::Linear, jtf::JTF_Compression::PredictiveLZ } };
+
+	for (auto [layout, compression] : layouts)
+	{
+		// levels before and a directory after the height chunk are skipped
+		jtf::JTF_WriteOptions writeOptions;
+		writeOptions.Layout = layout;
+		writeOptions.TileSize = 64;
+		writeOptions.Compression = compression;
+		writeOptions.LodLevels = 2;
+		writeOptions.ChunkDirectory = true;
+		jtf::JTFFile::Write(filePath, width, height, -50, 150, heights, writeOptions);
+
+		jtf::JTF_Stats stats;
+		jtf::JTF_ReadOptions readOptions;
+		readOptions.ThreadCount = 1;
+		readOptions.Stats = &stats;
+		string failures;
+		for (const Region& r : regions)
+		{
+			bool matches = false;
+			try
+			{
+				jtf::JTF_Region region = jtf::JTFFile::ReadRegion(filePath, r.X, r.Y, r.Width, r.Height, readOptions);
+				matches = region.Heights.HeightSamples.size() == size_t(r.Width) * r.Height;
+				for (size_t row = 0; matches && row < r.Height; ++row)
+					matches = equal(heights.begin() + (r.Y + row) * width + r.X, heights.begin() + (r.Y + row) * width + r.X + r.Width, region.Heights.HeightSamples.begin() + row * r.Width);
+			}
+			catch (const std::exception& e)
+			{
+				cout << e.what();
+			}
+			if (!matches) failures += format(" [{}, {}, {}x{}]", r.X, r.Y, r.Width, r.Height);
+		}
+
+		// regions past the map edge are rejected
+		bool outsideRejected = true;
+		for (const Region& r : { Region{ 299, 0, 2, 1 }, Region{ 0, 170, 1, 1 }, Region{ 0, 0, 0, 1 } })
+		{
+			try
+			{
+				jtf::JTFFile::ReadRegion(filePath, r.X, r.Y, r.Width, r.Height);
+				outsideRejected = false;
+			}
+			catch (const std::out_of_range&) {}
+		}
+
+		// the file CRC is checked although the rest of the file is skipped
+		vector<uint8_t> bytes = LoadBytes(filePath);
+		bytes.back() ^= 0x01;
+		StoreBytes(filePath, bytes);
+		bool fileCrcChecked = false;
+		try
+		{
+			jtf::JTFFile::ReadRegion(filePath, 0, 0, 1, 1);
+		}
+		catch (const std::exception& e)
+		{
+			fileCrcChecked = string(e.what()).find("File CRC mismatch") != string::npos;
+		}
+
+		const char* layoutName = compression == jtf::JTF_Compression::PredictiveLZ ? "HCMP" : layout == jtf::JTF_Layout::Tiled ? "HTIL" : "HMAP";
+		bool passed = failures.empty() && outsideRejected && fileCrcChecked && stats.TotalNanoseconds > 0;
+		cout << format("ReadRegion ({}):\t {} {} regions{}, outside {}, file CRC {}", layoutName, Verdict(passed), size(regions),
+			failures.empty() ? " match" : " failed at" + failures, outsideRejected ? "rejected" : "accepted", fileCrcChecked ? "checked" : "unchecked") << endl;
+	}
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+void RunLodTest(const char* filePath)
 {
-	cout << "Testing JTF " << GetVersion() << endl << endl;
+	cout << "Descritption:\t\t Level sizes halve rounding up, levels beyond the stored ones and files without HLOD are rejected, the index is checked for level 0." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const uint16_t width = 300, height = 170;
+	vector<double> heights = PatternSamples<double>(width, height);
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.LodLevels = 3;
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights, writeOptions);
+
+	// 300x170 -> 150x85 -> 75x43 -> 38x22
+	const pair<uint16_t, uint16_t> sizes[] = { { 300, 170 }, { 150, 85 }, { 75, 43 }, { 38, 22 } };
+	jtf::JTF_Stats stats;
+	jtf::JTF_ReadOptions readOptions;
+	readOptions.ThreadCount = 1;
+	readOptions.Stats = &stats;
+	for (uint8_t level = 0; level < size(sizes); ++level)
+	{
+		bool matches = false;
+		uint16_t levelWidth = 0, levelHeight = 0;
+		try
+		{
+			jtf::JTF_Lod lod = jtf::JTFFile::ReadLod(filePath, level, readOptions);
+			levelWidth = lod.Width;
+			levelHeight = lod.Height;
+			matches = lod.LevelCount == 3 && lod.Width == sizes[level].first && lod.Height == sizes[level].second
+				&& lod.Heights.HeightSamples.size() == size_t(lod.Width) * lod.Height
+				&& (level != 0 || lod.Heights.HeightSamples == heights);
+		}
+		catch (const std::exception& e)
+		{
+			cout << e.what();
+		}
+		cout << format("ReadLod (level {}):\t {} {}x{}", level, Verdict(matches), levelWidth, levelHeight) << endl;
+	}
+
+	bool beyondRejected = false;
+	try
+	{
+		jtf::JTFFile::ReadLod(filePath, 4);
+	}
+	catch (const std::out_of_range&)
+	{
+		beyondRejected = true;
+	}
+	cout << format("ReadLod (level 4):\t {} rejected, 3 levels stored", Verdict(beyondRejected)) << endl;
 
-	cout << "Choose procedure:\n1. Default\n2. Read file at path" << endl;
+	// a level 1 entry claiming another width fails level 0 reads, which skip the level data
+	vector<uint8_t> bytes = LoadBytes(filePath);
+	const uint8_t hlodTag[] = { 'H', 'L', 'O', 'D' };
+	size_t payloadOffset = size_t(search(bytes.begin() + 8, bytes.end(), begin(hlodTag), end(hlodTag)) - bytes.begin()) + 4;
+	bytes[payloadOffset + 4] ^= 0x01;
+	StoreBytes(filePath, bytes);
+	string message;
+	try
+	{
+		jtf::JTFFile::ReadLod(filePath, 0);
+	}
+	catch (const std::exception& e)
+	{
+		message = e.what();
+	}
+	bool indexChecked = message.find("HLOD level index entry [1] corrupted") != string::npos;
+	cout << format("Damaged HLOD index:\t {} level 0 read rejected:\n{}", Verdict(indexChecked), message) << endl;
 
-	cout << "Awaiting input: ";
+	// without levels level 0 is the full map, level 1 is not stored
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights);
+	bool withoutLevels = false;
+	try
+	{
+		jtf::JTF_Lod lod = jtf::JTFFile::ReadLod(filePath, 0);
+		withoutLevels = lod.LevelCount == 0 && lod.Width == width && lod.Height == height && lod.Heights.HeightSamples == heights;
+		jtf::JTFFile::ReadLod(filePath, 1);
+		withoutLevels = false;
+	}
+	catch (const std::out_of_range&) {}
+	catch (const std::exception& e)
+	{
+		cout << e.what();
+		withoutLevels = false;
+	}
+	cout << format("Without HLOD:\t\t {} level 0 full map, level 1 rejected", Verdict(withoutLevels && stats.TotalNanoseconds > 0)) << endl;
 
-	int choice;
-	cin >> choice;
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
 
-	// Move cursor up 1 line and clear it
-	cout << "\033[1A\033[2K";
-	cout << "\033[1A\033[2K";
-	cout << "\033[1A\033[2K";
-	cout << "\033[1A\033[2K";
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
 
-	cout << "\033[1A\033[2K";
-	cout << "\033[1A\033[2K";
-	cout << "\033[1A\033[2K";
-	cout << "\033[1A\033[2K";
+// Moller-Trumbore as in JTFHeightQuery, nearest hit over every triangle of the map
+static bool BruteForceRaycast(const jtf::JTF_Ray& ray, const vector<double>& heights, uint16_t width, uint16_t height, double& nearest)
+{
+	auto intersect = [&](const double (&a)[3], const double (&b)[3], const double (&c)[3])
+	{
+		const double* d = ray.Direction;
+		double e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		double e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		double p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+		double determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+		if (determinant == 0.0)
+			return false;
+		double inverse = 1.0 / determinant;
+		double s[3] = { ray.Origin[0] - a[0], ray.Origin[1] - a[1], ray.Origin[2] - a[2] };
+		double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+		if (u < -1e-12 || u > 1.0 + 1e-12)
+			return false;
+		double q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+		double v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse;
+		if (v < -1e-12 || u + v > 1.0 + 1e-12)
+			return false;
+		double distance = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+		if (distance < 0.0 || distance >= nearest)
+			return false;
+		nearest = distance;
+		return true;
+	};
+
+	bool hit = false;
+	for (uint32_t y = 0; y + 1 < height; ++y)
+		for (uint32_t x = 0; x + 1 < width; ++x)
+		{
+			const double c00[3] = { double(x), double(y), heights[size_t(y) * width + x] };
+			const double c10[3] = { double(x + 1), double(y), heights[size_t(y) * width + x + 1] };
+			const double c11[3] = { double(x + 1), double(y + 1), heights[size_t(y + 1) * width + x + 1] };
+			const double c01[3] = { double(x), double(y + 1), heights[size_t(y + 1) * width + x] };
+			hit |= intersect(c00, c10, c11);
+			hit |= intersect(c00, c11, c01);
+		}
+	return hit;
+}
+
+void RunHeightQueryTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Height tree queries (read with options) match brute force scans over the samples, region edges and tree leaves included." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	// odd sizes leave partial cells on the right and bottom edge
+	const uint16_t width = 67, height = 41;
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.HeightTreeLeafSize = 4;
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, PatternSamples<double>(width, height), writeOptions);
+
+	jtf::JTF_Stats stats;
+	jtf::JTF_ReadOptions readOptions;
+	readOptions.ThreadCount = 1;
+	readOptions.Stats = &stats;
+	jtf::JTF_HeightTree tree = jtf::JTFFile::ReadHeightTree(filePath, readOptions);
+	vector<double> heights = jtf::JTFFile::Read(filePath).Heights.HeightSamples;
+	jtf::JTFHeightQuery query(tree, heights);
+	cout << format("ReadHeightTree:\t\t {} {} levels, leaf size {}", Verdict(tree.LeafSize == 4 && !tree.Levels.empty() && stats.TotalNanoseconds > 0), tree.Levels.size(), tree.LeafSize) << endl;
+
+	// regions: single samples, full map, edge strips and random rectangles
+	mt19937 random(1009);
+	vector<array<uint16_t, 4>> regions = { { 0, 0, 1, 1 }, { 66, 40, 1, 1 }, { 0, 0, width, height }, { 0, 40, width, 1 }, { 66, 0, 1, height }, { 3, 3, 5, 5 }, { 4, 4, 4, 4 } };
+	for (int i = 0; i < 400; ++i)
+	{
+		uint16_t x = uint16_t(random() % width), y = uint16_t(random() % height);
+		regions.push_back({ x, y, uint16_t(1 + random() % (width - x)), uint16_t(1 + random() % (height - y)) });
+	}
+
+	size_t rangeMismatches = 0, overlapMismatches = 0, flatMismatches = 0;
+	uniform_real_distribution<double> unit(-0.1, 1.1);
+	for (const auto& [x, y, w, h] : regions)
+	{
+		double low = numeric_limits<double>::infinity(), high = -numeric_limits<double>::infinity();
+		for (size_t row = y; row < size_t(y) + h; ++row)
+			for (size_t column = x; column < size_t(x) + w; ++column)
+			{
+				low = min(low, heights[row * width + column]);
+				high = max(high, heights[row * width + column]);
+			}
+
+		jtf::JTF_HeightRange range = query.GetRange(x, y, w, h);
+		rangeMismatches += range.Min != low || range.Max != high;
+
+		for (int band = 0; band < 4; ++band)
+		{
+			double a = unit(random), b = a + (unit(random) + 0.1) * 0.05;
+			bool expected = false;
+			for (size_t row = y; row < size_t(y) + h && !expected; ++row)
+				for (size_t column = x; column < size_t(x) + w && !expected; ++column)
+					expected = heights[row * width + column] >= a && heights[row * width + column] <= b;
+			overlapMismatches += query.Overlaps(x, y, w, h, a, b) != expected;
+		}
+		overlapMismatches += !query.Overlaps(x, y, w, h, low, low) || !query.Overlaps(x, y, w, h, high, high);
+
+		double spread = high - low;
+		flatMismatches += !query.IsFlat(x, y, w, h, spread);
+		flatMismatches += spread > 0.0 && query.IsFlat(x, y, w, h, spread * 0.999);
+	}
+	cout << format("GetRange:\t\t {} {} regions, {} mismatches", Verdict(rangeMismatches == 0), regions.size(), rangeMismatches) << endl;
+	cout << format("Overlaps:\t\t {} {} mismatches", Verdict(overlapMismatches == 0), overlapMismatches) << endl;
+	cout << format("IsFlat:\t\t\t {} {} mismatches", Verdict(flatMismatches == 0), flatMismatches) << endl;
+
+	// rays from above, grazing rays from the sides, rays pointing away and rays cut short by MaxDistance
+	uniform_real_distribution<double> across(-10.0, width + 10.0), down(0.0, height), slope(-1.0, 1.0);
+	size_t rayCount = 0, hitCount = 0, rayMismatches = 0;
+	for (int i = 0; i < 2000; ++i)
+	{
+		jtf::JTF_Ray ray;
+		switch (i % 4)
+		{
+			case 0:
+				ray.Origin[0] = across(random); ray.Origin[1] = down(random); ray.Origin[2] = 2.0;
+				ray.Direction[0] = slope(random); ray.Direction[1] = slope(random); ray.Direction[2] = -1.0;
+				break;
+			case 1:
+				ray.Origin[0] = -5.0; ray.Origin[1] = down(random); ray.Origin[2] = unit(random);
+				ray.Direction[0] = 1.0; ray.Direction[1] = slope(random) * 0.2; ray.Direction[2] = slope(random) * 0.02;
+				break;
+			case 2:
+				ray.Origin[0] = across(random); ray.Origin[1] = down(random); ray.Origin[2] = 2.0;
+				ray.Direction[0] = slope(random); ray.Direction[1] = slope(random); ray.Direction[2] = 0.5;
+				break;
+			default:
+				ray.Origin[0] = across(random); ray.Origin[1] = down(random); ray.Origin[2] = 1.5;
+				ray.Direction[0] = slope(random) * 4.0; ray.Direction[1] = slope(random) * 4.0; ray.Direction[2] = -0.3;
+				ray.MaxDistance = 2.0 + 3.0 * (unit(random) + 0.1);
+				break;
+		}
+
+		double expected = ray.MaxDistance;
+		bool expectedHit = BruteForceRaycast(ray, heights, width, height, expected);
+		jtf::JTF_RayHit hit;
+		bool queryHit = query.Raycast(ray, hit);
+		++rayCount;
+		hitCount += queryHit;
+		rayMismatches += queryHit != expectedHit || (queryHit && abs(hit.Distance - expected) > 1e-9);
+	}
+	cout << format("Raycast:\t\t {} {} rays, {} hits, {} mismatches", Verdict(rayMismatches == 0 && hitCount > 0 && hitCount < rayCount), rayCount, hitCount, rayMismatches) << endl;
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+// bit at a time CRC-32 over the reflected polynomial, independent of every table and engine
+static uint32_t BitwiseCrcAppend(uint32_t crc, uint8_t byte)
+{
+	crc ^= byte;
+	for (int bit = 0; bit < 8; ++bit)
+		crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+	return crc;
+}
+
+void RunCrcTest(const char* filePath)
+{
+	cout << "Descritption:\t\t CRC-32 engines, Combine() and AppendHash() match a bitwise reference for lengths 0..4096 at unaligned offsets." << endl << endl;
+	cout << format("File path:\t\t {} (unused)", filePath) << endl << endl;
+
+	constexpr size_t MAX_LENGTH = 4096, MAX_OFFSET = 16;
+	vector<uint8_t> data(MAX_LENGTH + MAX_OFFSET);
+	mt19937 random(4096);
+	for (uint8_t& byte : data)
+		byte = uint8_t(random());
+
+	// reference[offset][length], prefixes of one pass per offset
+	vector<vector<uint32_t>> reference(MAX_OFFSET, vector<uint32_t>(MAX_LENGTH + 1));
+	for (size_t offset = 0; offset < MAX_OFFSET; ++offset)
+	{
+		uint32_t crc = 0xFFFFFFFFu;
+		reference[offset][0] = 0;
+		for (size_t length = 1; length <= MAX_LENGTH; ++length)
+		{
+			crc = BitwiseCrcAppend(crc, data[offset + length - 1]);
+			reference[offset][length] = crc ^ 0xFFFFFFFFu;
+		}
+	}
+
+	const pair<jtf::Crc32Engine, const char*> engines[] = { { jtf::Crc32Engine::SliceBy16, "slice-by-16" }, { jtf::Crc32Engine::Pclmul, "pclmul" }, { jtf::Crc32Engine::ArmCrc, "armv8-crc" } };
+	for (const auto& [engine, name] : engines)
+	{
+		if (!jtf::Crc32::IsEngineSupported(engine))
+		{
+			cout << format("Engine {}:\t skipped, not supported", name) << endl;
+			continue;
+		}
+		size_t mismatches = 0;
+		for (size_t offset = 0; offset < MAX_OFFSET; ++offset)
+			for (size_t length = 0; length <= MAX_LENGTH; ++length)
+				mismatches += jtf::Crc32::Hash(engine, data.data() + offset, length) != reference[offset][length];
+		cout << format("Engine {}:\t {} {} mismatches{}", name, Verdict(mismatches == 0), mismatches, engine == jtf::Crc32::GetEngine() ? " (selected)" : "") << endl;
+	}
+
+	// dispatching Hash() and Append() in uneven pieces
+	size_t hashMismatches = 0, appendMismatches = 0;
+	for (size_t offset = 0; offset < MAX_OFFSET; ++offset)
+		for (size_t length = 0; length <= MAX_LENGTH; ++length)
+		{
+			const uint8_t* bytes = data.data() + offset;
+			hashMismatches += jtf::Crc32::Hash(bytes, length) != reference[offset][length];
+
+			jtf::Crc32 crc;
+			for (size_t done = 0, piece = 1; done < length; done += piece, piece = piece * 3 + 1)
+				crc.Append(bytes + done, min(piece, length - done));
+			appendMismatches += crc.GetCurrentHashAsUInt32() != reference[offset][length];
+		}
+	cout << format("Hash:\t\t\t {} {} mismatches", Verdict(hashMismatches == 0), hashMismatches) << endl;
+	cout << format("Append (pieces):\t {} {} mismatches", Verdict(appendMismatches == 0), appendMismatches) << endl;
+
+	// split every length at the ends and at a random point, the tail hashed separately
+	size_t combineMismatches = 0, appendHashMismatches = 0;
+	for (size_t offset = 0; offset < MAX_OFFSET; ++offset)
+		for (size_t length = 0; length <= MAX_LENGTH; ++length)
+		{
+			const size_t splits[] = { 0, length, length == 0 ? 0 : random() % (length + 1) };
+			for (size_t split : splits)
+			{
+				const uint8_t* bytes = data.data() + offset;
+				uint32_t head = jtf::Crc32::Hash(bytes, split);
+				uint32_t tail = jtf::Crc32::Hash(bytes + split, length - split);
+				combineMismatches += jtf::Crc32::Combine(head, tail, length - split) != reference[offset][length];
+
+				jtf::Crc32 crc;
+				crc.Append(bytes, split);
+				crc.AppendHash(tail, length - split);
+				appendHashMismatches += crc.GetCurrentHashAsUInt32() != reference[offset][length];
+			}
+		}
+	cout << format("Combine:\t\t {} {} mismatches", Verdict(combineMismatches == 0), combineMismatches) << endl;
+	cout << format("AppendHash:\t\t {} {} mismatches", Verdict(appendHashMismatches == 0), appendHashMismatches) << endl;
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+// every view sample through GetSample() equals the full read
+static bool ViewMatchesRead(const jtf::JTFView& view, const char* filePath)
+{
+	vector<double> read = jtf::JTFFile::Read(filePath).Heights.HeightSamples;
+	if (view.GetSampleCount() != read.size())
+		return false;
+	for (size_t i = 0; i < read.size(); ++i)
+		if (view.GetSample(i) != read[i])
+			return false;
+	return true;
+}
+
+static string ViewError(const char* filePath, bool verifyPayloadCrc)
+{
+	try
+	{
+		jtf::JTFView view(filePath, verifyPayloadCrc);
+	}
+	catch (const std::exception& e)
+	{
+		return e.what();
+	}
+	return "";
+}
+
+void RunViewTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Views map the file in place: typed spans where aligned, CRCs verified, tiled and compressed files rejected." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const uint16_t width = 37, height = 23;
+
+	// 32 bit, float span straight over the mapping
+	vector<float> floats = PatternSamples<float>(width, height);
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, floats);
+	bool floatSpan = false;
+	try
+	{
+		jtf::JTFView view(filePath);
+		span<const float> samples = view.GetSamples<float>();
+		floatSpan = view.GetHeader().Width == width && view.GetHeader().Height == height && view.GetHeader().BitDepth == 32
+			&& view.HasSampleSpan<float>() && !view.HasSampleSpan<double>() && view.GetRawSamples().size() == floats.size() * sizeof(float)
+			&& equal(samples.begin(), samples.end(), floats.begin(), floats.end()) && ViewMatchesRead(view, filePath);
+	}
+	catch (const std::exception& e)
+	{
+		cout << e.what();
+	}
+	cout << format("GetSamples<float>:\t {} {}x{} 32 bit", Verdict(floatSpan), width, height) << endl;
+
+	// 64 bit, payload at offset 60 is not aligned for double, GetSample() still reads every sample
+	vector<double> doubles = PatternSamples<double>(width, height);
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, doubles);
+	bool doubleSamples = false;
+	try
+	{
+		jtf::JTFView view(filePath);
+		bool spanRejected = false;
+		try
+		{
+			(void)view.GetSamples<double>();
+		}
+		catch (const std::runtime_error&)
+		{
+			spanRejected = true;
+		}
+		doubleSamples = !view.HasSampleSpan<double>() && spanRejected && ViewMatchesRead(view, filePath);
+	}
+	catch (const std::exception& e)
+	{
+		cout << e.what();
+	}
+	cout << format("GetSample (64 bit):\t {} no double span, samples match", Verdict(doubleSamples)) << endl;
+
+	// 16 bit, raw UNORM span
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.BitDepth = 16;
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, doubles, writeOptions);
+	bool unormSpan = false;
+	try
+	{
+		jtf::JTFView view(filePath);
+		span<const uint16_t> samples = view.GetSamples<uint16_t>();
+		bool outOfRange = false;
+		try
+		{
+			(void)view.GetSample(view.GetSampleCount());
+		}
+		catch (const std::out_of_range&)
+		{
+			outOfRange = true;
+		}
+		unormSpan = samples.size() == doubles.size() && samples[1] == uint16_t(lround(doubles[1] * 65535.0)) && outOfRange && ViewMatchesRead(view, filePath);
+	}
+	catch (const std::exception& e)
+	{
+		cout << e.what();
+	}
+	cout << format("GetSamples<uint16_t>:\t {} 16 bit UNORM, index past the end rejected", Verdict(unormSpan)) << endl;
+
+	// damaged payload fails its chunk CRC unless payload verification is skipped, the file CRC covers only the chunk CRCs
+	vector<uint8_t> bytes = LoadBytes(filePath);
+	vector<uint8_t> damaged = bytes;
+	damaged[60 + 5] ^= 0x10;
+	StoreBytes(filePath, damaged);
+	string payloadError = ViewError(filePath, true);
+	bool payloadChecked = payloadError.find("HMAP CRC mismatch") != string::npos && ViewError(filePath, false).empty();
+	cout << format("Damaged HMAP:\t\t {} rejected, opens without payload CRC:\n{}", Verdict(payloadChecked), payloadError) << endl;
+
+	damaged = bytes;
+	damaged.back() ^= 0x01;
+	StoreBytes(filePath, damaged);
+	string fileCrcError = ViewError(filePath, false);
+	cout << format("Damaged file CRC:\t {} rejected:\n{}", Verdict(fileCrcError.find("File CRC mismatch") != string::npos), fileCrcError) << endl;
+
+	// samples not contiguous on disk
+	for (auto [layout, compression, label] : { tuple{ jtf::JTF_Layout::Tiled, jtf::JTF_Compression::None, "View (tiled):\t\t" }, tuple{ jtf::JTF_Layout::Linear, jtf::JTF_Compression::PredictiveLZ, "View (compressed):\t" } })
+	{
+		jtf::JTF_WriteOptions options;
+		options.Layout = layout;
+		options.Compression = compression;
+		options.TileSize = 16;
+		jtf::JTFFile::Write(filePath, width, height, -50, 150, doubles, options);
+		string error = ViewError(filePath, true);
+		cout << format("{} {} rejected", label, Verdict(error.find("cannot be viewed in place") != string::npos)) << endl;
+	}
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+void RunReaderTest(const char* filePath)
+{
+	cout << "Descritption:\t\t A reused reader and reused caller storage match JTFFile::Read() over files growing and shrinking in size, layout and bit depth." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	struct ReaderCase { uint16_t Width, Height; jtf::JTF_Layout Layout; jtf::JTF_Compression Compression; uint8_t BitDepth; };
+	const ReaderCase cases[] = {
+		{ 300, 211, jtf::JTF_Layout::Linear, jtf::JTF_Compression::None, 0 },
+		{ 17, 9, jtf::JTF_Layout::Linear, jtf::JTF_Compression::None, 0 },
+		{ 257, 130, jtf::JTF_Layout::Tiled, jtf::JTF_Compression::None, 0 },
+		{ 64, 64, jtf::JTF_Layout::Linear, jtf::JTF_Compression::PredictiveLZ, 0 },
+		{ 300, 211, jtf::JTF_Layout::Linear, jtf::JTF_Compression::PredictiveLZ, 16 },
+		{ 33, 70, jtf::JTF_Layout::Tiled, jtf::JTF_Compression::None, 8 },
+		{ 300, 211, jtf::JTF_Layout::Linear, jtf::JTF_Compression::None, 16 } };
+
+	for (uint32_t threadCount : { 1u, 0u })
+	{
+		jtf::JTFReader reader(jtf::JTF_ReadOptions{ threadCount });
+		jtf::JTF reused;
+		vector<double> doubles(300 * 211);
+		vector<float> floats(300 * 211);
+		const double* reusedData = nullptr;
+		size_t matching = 0;
+		bool storageKept = true;
+		for (const ReaderCase& c : cases)
+		{
+			jtf::JTF_WriteOptions writeOptions;
+			writeOptions.Layout = c.Layout;
+			writeOptions.TileSize = 32;
+			writeOptions.Compression = c.Compression;
+			writeOptions.BitDepth = c.BitDepth;
+			jtf::JTFFile::Write(filePath, c.Width, c.Height, -50, 150, PatternSamples<double>(c.Width, c.Height), writeOptions);
+			jtf::JTF expected = jtf::JTFFile::Read(filePath);
+			const vector<double>& samples = expected.Heights.HeightSamples;
+
+			try
+			{
+				const jtf::JTF& owned = reader.Read(filePath);
+				reader.Read(filePath, reused);
+				jtf::JTF_Head header = reader.ReadInto<double>(filePath, doubles);
+				reader.ReadInto<float>(filePath, floats);
+
+				// the first file is the largest, later reads refill its storage
+				if (reusedData == nullptr)
+					reusedData = reused.Heights.HeightSamples.data();
+				storageKept &= reused.Heights.HeightSamples.data() == reusedData;
+
+				// 8 / 16-bit samples dequantize in float precision
+				bool floatsMatch = true;
+				for (size_t i = 0; i < samples.size() && floatsMatch; ++i)
+					floatsMatch = abs(double(floats[i]) - samples[i]) <= 1e-6;
+				matching += owned.Heights.HeightSamples == samples && reused.Heights.HeightSamples == samples
+					&& owned.Header.Width == c.Width && reused.Header.BitDepth == expected.Header.BitDepth
+					&& header.Height == c.Height && header.Layout == c.Layout && header.Compression == c.Compression
+					&& equal(samples.begin(), samples.end(), doubles.begin()) && floatsMatch;
+			}
+			catch (const std::exception& e)
+			{
+				cout << e.what();
+			}
+		}
+		cout << format("JTFReader ({} thread{}):\t {} {} of {} files match, storage {}", threadCount == 1 ? "1" : "all", threadCount == 1 ? "" : "s",
+			Verdict(matching == size(cases) && storageKept), matching, size(cases), storageKept ? "reused" : "reallocated") << endl;
+	}
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+void RunScanHeadersTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Header scans over paths and directories report every failing file without aborting, headers of valid files are read." << endl << endl;
+
+	filesystem::path directory = filesystem::path(filePath).parent_path() / "CppJTFScanTest";
+	filesystem::remove_all(directory);
+	filesystem::create_directories(directory / "nested");
+	cout << format("File path:\t\t {}", directory.string()) << endl << endl;
+
+	const uint16_t width = 24, height = 10;
+	vector<double> heights = PatternSamples<double>(width, height);
+	auto path = [&](const char* name) { return (directory / name).string(); };
+
+	jtf::JTFFile::Write(path("a_valid.jtf"), width, height, -50, 150, heights);
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.BitDepth = 16;
+	jtf::JTFFile::Write(path("b_valid16.JTF"), height, width, -5, 5, heights, writeOptions);
+	jtf::JTFFile::Write(path("nested/c_valid.jtf"), width, height, 0, 1, heights);
+
+	vector<uint8_t> bytes = LoadBytes(path("a_valid.jtf").c_str());
+	StoreBytes(path("d_truncated.jtf").c_str(), vector<uint8_t>(bytes.begin(), bytes.begin() + 30));
+	vector<uint8_t> damaged = bytes;
+	damaged[8 + 8 + 2] ^= 0x01; // width, inside the HEAD payload
+	StoreBytes(path("e_damaged_head.jtf").c_str(), damaged);
+	const string text = "not a terrain file, just some text long enough to hold a header prefix.";
+	StoreBytes(path("f_text.jtf").c_str(), vector<uint8_t>(text.begin(), text.end()));
+	StoreBytes(path("g_ignored.txt").c_str(), bytes);
+
+	// expected error per failing file name, empty for valid files
+	auto errorMatches = [](const jtf::JTF_HeaderScan& scan, size_t i, const char* expected)
+		{
+			return *expected == '\0' ? scan.Errors[i].empty() : scan.Errors[i].find(expected) != string::npos && scan.Headers[i].Width == 0;
+		};
+
+	// path list, a missing file included, scanned on one thread and on all
+	const vector<pair<string, const char*>> listed = {
+		{ path("a_valid.jtf"), "" }, { path("d_truncated.jtf"), "Unexpected EOF" }, { path("missing.jtf"), "Cannot open file" },
+		{ path("e_damaged_head.jtf"), "HEAD CRC mismatch" }, { path("f_text.jtf"), "Invalid file signature" }, { path("b_valid16.JTF"), "" } };
+	vector<string> filePaths;
+	for (const auto& [listedPath, error] : listed)
+		filePaths.push_back(listedPath);
+	for (uint32_t threadCount : { 1u, 0u })
+	{
+		jtf::JTF_HeaderScan scan = jtf::JTFFile::ScanHeaders(filePaths, jtf::JTF_ReadOptions{ threadCount });
+		bool matches = scan.FilePaths == filePaths && scan.Headers.size() == listed.size() && scan.Errors.size() == listed.size() && scan.FailedCount == 4;
+		for (size_t i = 0; matches && i < listed.size(); ++i)
+			matches = errorMatches(scan, i, listed[i].second);
+		matches = matches && scan.Headers[0].Width == width && scan.Headers[0].BitDepth == 64
+			&& scan.Headers[5].Width == height && scan.Headers[5].BitDepth == 16 && scan.Headers[5].BoundsLower == -5;
+		cout << format("ScanHeaders (paths, {}):\t {} {} files, {} failed", threadCount == 1 ? "1 thread" : "all", Verdict(matches), scan.FilePaths.size(), scan.FailedCount) << endl;
+	}
+
+	// directory, .jtf in any case, ordered by path, text files skipped
+	const pair<const char*, const char*> flat[] = { { "a_valid.jtf", "" }, { "b_valid16.JTF", "" }, { "d_truncated.jtf", "Unexpected EOF" },
+		{ "e_damaged_head.jtf", "HEAD CRC mismatch" }, { "f_text.jtf", "Invalid file signature" } };
+	jtf::JTF_HeaderScan scan = jtf::JTFFile::ScanHeaders(directory.string(), false);
+	bool directoryMatches = scan.FilePaths.size() == size(flat) && scan.FailedCount == 3;
+	for (size_t i = 0; directoryMatches && i < size(flat); ++i)
+		directoryMatches = filesystem::path(scan.FilePaths[i]).filename() == flat[i].first && errorMatches(scan, i, flat[i].second);
+	cout << format("ScanHeaders (directory):\t {} {} files, {} failed", Verdict(directoryMatches), scan.FilePaths.size(), scan.FailedCount) << endl;
+
+	scan = jtf::JTFFile::ScanHeaders(directory.string(), true);
+	auto nested = find_if(scan.FilePaths.begin(), scan.FilePaths.end(), [](const string& p) { return filesystem::path(p).filename() == "c_valid.jtf"; });
+	bool recursiveMatches = scan.FilePaths.size() == size(flat) + 1 && scan.FailedCount == 3 && nested != scan.FilePaths.end()
+		&& scan.Headers[size_t(nested - scan.FilePaths.begin())].Width == width && is_sorted(scan.FilePaths.begin(), scan.FilePaths.end());
+	cout << format("ScanHeaders (recursive):\t {} {} files, {} failed", Verdict(recursiveMatches), scan.FilePaths.size(), scan.FailedCount) << endl;
+
+	bool missingRejected = false;
+	try
+	{
+		jtf::JTFFile::ScanHeaders((directory / "missing").string(), false);
+	}
+	catch (const std::runtime_error&)
+	{
+		missingRejected = true;
+	}
+	cout << format("ScanHeaders (missing):\t {} directory rejected", Verdict(missingRejected)) << endl;
+
+	filesystem::remove_all(directory);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+// sample values covering signs, magnitudes beyond float, subnormals, infinities and NaN
+static vector<double> ConverterSamples(size_t count)
+{
+	const double specials[] = { 0.0, -0.0, 1.0, -1.0, 1e-310, 1e-40, 3.4028235677973366e38, 1e300, -1e300,
+		numeric_limits<double>::infinity(), -numeric_limits<double>::infinity(), numeric_limits<double>::quiet_NaN() };
+	mt19937 random{ uint32_t(count) };
+	uniform_real_distribution<double> value(-1000.0, 1000.0);
+	vector<double> samples(count);
+	for (size_t i = 0; i < count; ++i)
+		samples[i] = i % 7 == 3 ? specials[(i / 7) % size(specials)] : value(random);
+	return samples;
+}
+
+void RunSampleConverterTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Every supported SampleConverter kernel matches the scalar reference bit for bit over odd tails, unaligned pointers and in-place byte swaps." << endl << endl;
+	cout << format("File path:\t\t {} (unused)", filePath) << endl << endl;
+
+	constexpr size_t MAX_COUNT = 131, MAX_SHIFT = 8;
+	const pair<jtf::SampleKernel, const char*> kernels[] = { { jtf::SampleKernel::Scalar, "scalar" }, { jtf::SampleKernel::Sse2, "sse2" },
+		{ jtf::SampleKernel::Avx2, "avx2" }, { jtf::SampleKernel::Avx512, "avx512" }, { jtf::SampleKernel::Neon, "neon" } };
+	for (const auto& [kernel, name] : kernels)
+	{
+		if (!jtf::SampleConverter::IsKernelSupported(kernel))
+		{
+			cout << format("Kernel {}:\t\t skipped, not supported", name) << endl;
+			continue;
+		}
+
+		size_t mismatches = 0;
+		for (size_t count = 0; count <= MAX_COUNT; ++count)
+		{
+			vector<double> doubles = ConverterSamples(count);
+			vector<float> floats(doubles.begin(), doubles.end());
+
+			// byte pointers at every offset within a 64 byte vector, typed pointers one element off
+			for (size_t shift = 0; shift < MAX_SHIFT; ++shift)
+			{
+				// little-endian payload bytes
+				vector<uint8_t> floatBytes(shift + count * 4), doubleBytes(shift + count * 8);
+				for (size_t i = 0; i < count; ++i)
+					for (size_t b = 0; b < 8; ++b)
+					{
+						if (b < 4) floatBytes[shift + i * 4 + b] = uint8_t(bit_cast<uint32_t>(floats[i]) >> (b * 8));
+						doubleBytes[shift + i * 8 + b] = uint8_t(bit_cast<uint64_t>(doubles[i]) >> (b * 8));
+					}
+
+				vector<double> widened(count + 1, 7.0);
+				jtf::SampleConverter::Widen_LittleEndian(kernel, floatBytes.data() + shift, count, widened.data() + shift % 2);
+				vector<float> narrowed(count + 1, 7.0f);
+				jtf::SampleConverter::Narrow_LittleEndian(kernel, doubleBytes.data() + shift, count, narrowed.data() + shift % 2);
+				for (size_t i = 0; i < count; ++i)
+				{
+					mismatches += bit_cast<uint64_t>(widened[shift % 2 + i]) != bit_cast<uint64_t>(double(floats[i]));
+					mismatches += bit_cast<uint32_t>(narrowed[shift % 2 + i]) != bit_cast<uint32_t>(float(doubles[i]));
+				}
+				mismatches += widened[shift % 2 == 0 ? count : 0] != 7.0 || narrowed[shift % 2 == 0 ? count : 0] != 7.0f; // untouched past the samples
+
+				// byte swap into another buffer and in place, for every sample size
+				for (size_t sampleSize : { size_t(1), size_t(2), size_t(4), size_t(8) })
+				{
+					const uint8_t* source = doubleBytes.data() + shift;
+					vector<uint8_t> expected(count * sampleSize);
+					for (size_t i = 0; i < count; ++i)
+						for (size_t b = 0; b < sampleSize; ++b)
+							expected[i * sampleSize + b] = source[i * sampleSize + sampleSize - 1 - b];
+
+					vector<uint8_t> swapped(shift + count * sampleSize);
+					jtf::SampleConverter::ByteSwap(kernel, source, count, sampleSize, swapped.data() + shift);
+					vector<uint8_t> inPlace(doubleBytes);
+					jtf::SampleConverter::ByteSwap(kernel, inPlace.data() + shift, count, sampleSize, inPlace.data() + shift);
+					mismatches += !equal(expected.begin(), expected.end(), swapped.begin() + shift) || !equal(expected.begin(), expected.end(), inPlace.begin() + shift);
+				}
+			}
+
+			// affine into another buffer and in place, one element off alignment
+			for (size_t shift = 0; shift < 2; ++shift)
+			{
+				vector<double> affineDoubles(count + shift), inPlaceDoubles(shift);
+				inPlaceDoubles.insert(inPlaceDoubles.end(), doubles.begin(), doubles.end());
+				jtf::SampleConverter::Affine(kernel, doubles.data(), count, 0.37, -12.5, affineDoubles.data() + shift);
+				jtf::SampleConverter::Affine(kernel, inPlaceDoubles.data() + shift, count, 0.37, -12.5, inPlaceDoubles.data() + shift);
+				vector<float> affineFloats(count + shift), inPlaceFloats(shift);
+				inPlaceFloats.insert(inPlaceFloats.end(), floats.begin(), floats.end());
+				jtf::SampleConverter::Affine(kernel, floats.data(), count, 0.37f, -12.5f, affineFloats.data() + shift);
+				jtf::SampleConverter::Affine(kernel, inPlaceFloats.data() + shift, count, 0.37f, -12.5f, inPlaceFloats.data() + shift);
+				for (size_t i = 0; i < count; ++i)
+				{
+					double productDouble = doubles[i] * 0.37;
+					uint64_t expectedDouble = bit_cast<uint64_t>(productDouble + -12.5);
+					float productFloat = floats[i] * 0.37f;
+					uint32_t expectedFloat = bit_cast<uint32_t>(productFloat + -12.5f);
+					mismatches += bit_cast<uint64_t>(affineDoubles[shift + i]) != expectedDouble || bit_cast<uint64_t>(inPlaceDoubles[shift + i]) != expectedDouble;
+					mismatches += bit_cast<uint32_t>(affineFloats[shift + i]) != expectedFloat || bit_cast<uint32_t>(inPlaceFloats[shift + i]) != expectedFloat;
+				}
+
+				// min/max widen a prior range, NaN samples are skipped
+				double minimumDouble = 0.5, maximumDouble = 0.5, expectedMinimumDouble = 0.5, expectedMaximumDouble = 0.5;
+				float minimumFloat = 0.5f, maximumFloat = 0.5f, expectedMinimumFloat = 0.5f, expectedMaximumFloat = 0.5f;
+				for (size_t i = shift; i < count; ++i)
+				{
+					if (doubles[i] == doubles[i])
+					{
+						expectedMinimumDouble = min(expectedMinimumDouble, doubles[i]);
+						expectedMaximumDouble = max(expectedMaximumDouble, doubles[i]);
+					}
+					if (floats[i] == floats[i])
+					{
+						expectedMinimumFloat = min(expectedMinimumFloat, floats[i]);
+						expectedMaximumFloat = max(expectedMaximumFloat, floats[i]);
+					}
+				}
+				size_t rest = count > shift ? count - shift : 0;
+				jtf::SampleConverter::MinMax(kernel, doubles.data() + shift, rest, minimumDouble, maximumDouble);
+				jtf::SampleConverter::MinMax(kernel, floats.data() + shift, rest, minimumFloat, maximumFloat);
+				mismatches += minimumDouble != expectedMinimumDouble || maximumDouble != expectedMaximumDouble;
+				mismatches += minimumFloat != expectedMinimumFloat || maximumFloat != expectedMaximumFloat;
+			}
+		}
+		cout << format("Kernel {}:\t\t {} {} mismatches{}", name, Verdict(mismatches == 0), mismatches, kernel == jtf::SampleConverter::GetKernel() ? " (selected)" : "") << endl;
+	}
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+// largest deviation of a read elevation from (elevation * scale + offset), in units of the allowed error
+template<typename T> static double ElevationError(const vector<T>& read, const vector<double>& elevations, double scale, double offset, double tolerance)
+{
+	double worst = 0.0;
+	for (size_t i = 0; i < elevations.size(); ++i)
+	{
+		double expected = elevations[i] * scale + offset;
+		double allowed = tolerance + abs(expected) * (is_same_v<T, float> ? 4e-7 : 1e-14);
+		worst = max(worst, abs(double(read[i]) - expected) / allowed);
+	}
+	return worst;
+}
+
+void RunElevationTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Denormalize() / Normalize() invert each other, elevations written with WriteElevations() read back through ReadElevationsInto() with scale and offset." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	// large enough for parallel bands, odd for vector tails
+	const uint16_t width = 301, height = 211;
+	const int32_t boundsLower = -50, boundsUpper = 150;
+	const double scale = 3.28084, offset = 12.5;
+	vector<double> normalized = PatternSamples<double>(width, height);
+
+	for (uint32_t threadCount : { 1u, 0u })
+	{
+		// reference formula, then back, double out of place and float in place
+		vector<double> elevations(normalized.size()), back(normalized.size());
+		jtf::JTFFile::Denormalize<double>(normalized, boundsLower, boundsUpper, elevations, scale, offset, threadCount);
+		jtf::JTFFile::Normalize<double>(elevations, boundsLower, boundsUpper, back, scale, offset, threadCount);
+		double denormalizeError = 0.0, roundTripError = 0.0;
+		for (size_t i = 0; i < normalized.size(); ++i)
+		{
+			denormalizeError = max(denormalizeError, abs(elevations[i] - ((boundsLower + normalized[i] * (boundsUpper - boundsLower)) * scale + offset)));
+			roundTripError = max(roundTripError, abs(back[i] - normalized[i]));
+		}
+
+		vector<float> floats = PatternSamples<float>(width, height);
+		jtf::JTFFile::Denormalize<float>(floats, boundsLower, boundsUpper, floats, scale, offset, threadCount);
+		jtf::JTFFile::Normalize<float>(floats, boundsLower, boundsUpper, floats, scale, offset, threadCount);
+		double floatError = 0.0;
+		for (size_t i = 0; i < normalized.size(); ++i)
+			floatError = max(floatError, abs(double(floats[i]) - normalized[i]));
+
+		bool matches = denormalizeError < 1e-9 && roundTripError < 1e-12 && floatError < 1e-5;
+		cout << format("Normalize round trip ({}):\t {} max error {:.2e}, {:.2e} double, {:.2e} float in place", threadCount == 1 ? "1 thread" : "all", Verdict(matches),
+			denormalizeError, roundTripError, floatError) << endl;
+	}
+
+	// equal bounds map every elevation to 0, mismatched spans are rejected
+	vector<double> flat(64, 7.0);
+	jtf::JTFFile::Normalize<double>(flat, 7, 7, flat);
+	bool equalBounds = all_of(flat.begin(), flat.end(), [](double sample) { return sample == 0.0; });
+	bool sizeRejected = false;
+	try
+	{
+		vector<double> shorter(63);
+		jtf::JTFFile::Denormalize<double>(flat, 0, 1, shorter);
+	}
+	catch (const std::invalid_argument&)
+	{
+		sizeRejected = true;
+	}
+	cout << format("Normalize (edge cases):\t {} equal bounds map to 0, size mismatch rejected", Verdict(equalBounds && sizeRejected)) << endl;
+
+	// write elevations, read them back scaled and shifted, within half a quantization step of the bit depth
+	vector<double> elevations(normalized.size());
+	jtf::JTFFile::Denormalize<double>(normalized, boundsLower, boundsUpper, elevations);
+	for (uint8_t bitDepth : { uint8_t(8), uint8_t(16), uint8_t(32), uint8_t(64) })
+	{
+		jtf::JTF_WriteOptions writeOptions;
+		writeOptions.BitDepth = bitDepth == 64 ? 0 : bitDepth;
+		double step = bitDepth <= 16 ? 0.5 / double((1u << bitDepth) - 1) : bitDepth == 32 ? 1e-7 : 1e-15;
+		double tolerance = step * (boundsUpper - boundsLower) * scale * (1.0 + 1e-6) + 1e-9; // rounding to the nearest step is exact up to the slack
+		bool matches = false;
+		double doubleError = 0.0, floatError = 0.0;
+		try
+		{
+			if (bitDepth == 32)
+				jtf::JTFFile::WriteElevations(filePath, width, height, boundsLower, boundsUpper, vector<float>(elevations.begin(), elevations.end()), writeOptions);
+			else
+				jtf::JTFFile::WriteElevations(filePath, width, height, boundsLower, boundsUpper, elevations, writeOptions);
+
+			vector<double> readDoubles(normalized.size());
+			jtf::JTF_Head header = jtf::JTFFile::ReadElevationsInto<double>(filePath, readDoubles, scale, offset);
+			vector<float> readFloats(normalized.size());
+			jtf::JTFFile::ReadElevationsInto<float>(filePath, readFloats, scale, offset, jtf::JTF_ReadOptions{ 1 });
+			doubleError = ElevationError(readDoubles, elevations, scale, offset, tolerance + (bitDepth == 32 ? 4e-7 * 150 * scale : 0.0));
+			floatError = ElevationError(readFloats, elevations, scale, offset, tolerance + 4e-7 * 150 * scale);
+			matches = header.BitDepth == bitDepth && header.BoundsLower == boundsLower && header.BoundsUpper == boundsUpper && doubleError <= 1.0 && floatError <= 1.0;
+		}
+		catch (const std::exception& e)
+		{
+			cout << e.what();
+		}
+		cout << format("WriteElevations ({} bit):\t {} read error {:.2f} double, {:.2f} float of allowed", bitDepth, Verdict(matches), doubleError, floatError) << endl;
+	}
+
+	// bounds from the elevations, floored and ceiled
+	vector<double> raw(elevations);
+	raw[5] = -61.25;
+	raw[7] = 170.5;
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.BitDepth = 16;
+	jtf::JTFFile::WriteElevations(filePath, width, height, raw, writeOptions);
+	vector<double> readRaw(raw.size());
+	jtf::JTF_Head header = jtf::JTFFile::ReadElevationsInto<double>(filePath, readRaw);
+	double rawError = ElevationError(readRaw, raw, 1.0, 0.0, 0.5 / 65535.0 * (171 + 62) * (1.0 + 1e-6) + 1e-9);
+	bool autoBounds = header.BoundsLower == -62 && header.BoundsUpper == 171 && rawError <= 1.0;
+	cout << format("WriteElevations (auto):\t {} bounds [{}, {}], read error {:.2f} of allowed", Verdict(autoBounds), header.BoundsLower, header.BoundsUpper, rawError) << endl;
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+void RunAtomicReplaceTest(const char* filePath)
+{
+	cout << "Descritption:\t\t Writes go in place by default, an atomic replace through a symbolic link replaces the file it points to." << endl << endl;
+	cout << format("File path:\t\t {}", filePath) << endl << endl;
+
+	const uint16_t width = 16, height = 16;
+	vector<double> heights = PatternSamples<double>(width, height);
+
+	// default write in place, its write calls merge like every other counter
+	jtf::JTF_Stats stats;
+	jtf::JTF_WriteOptions writeOptions;
+	writeOptions.Stats = &stats;
+	jtf::JTFFile::Write(filePath, width, height, -50, 150, heights, writeOptions);
+	jtf::JTF_Stats merged;
+	jtf::MergeStats(merged, stats);
+	bool inPlace = !writeOptions.AtomicReplace && stats.WriteCalls > 0 && merged.WriteCalls == stats.WriteCalls;
+	cout << format("Default write:\t\t {} in place, {} write calls, {} merged", Verdict(inPlace), stats.WriteCalls, merged.WriteCalls) << endl;
+
+	// the link stays a link, the file it points to holds the new samples
+	string linkPath = string(filePath) + ".link";
+	filesystem::remove(linkPath);
+	std::error_code error;
+	filesystem::create_symlink(filePath, linkPath, error);
+	if (error)
+		cout << format("Atomic replace (link):\t skipped, no symbolic link: {}", error.message()) << endl;
+	else
+	{
+		vector<double> replaced(heights.rbegin(), heights.rend());
+		writeOptions.AtomicReplace = true;
+		writeOptions.Stats = nullptr;
+		bool linkKept = false;
+		try
+		{
+			jtf::JTFFile::Write(linkPath, width, height, -50, 150, replaced, writeOptions);
+			linkKept = filesystem::is_symlink(linkPath) && jtf::JTFFile::Read(filePath).Heights.HeightSamples == replaced;
+		}
+		catch (const std::exception& e)
+		{
+			cout << e.what();
+		}
+		cout << format("Atomic replace (link):\t {} link kept, target replaced", Verdict(linkKept)) << endl;
+		filesystem::remove(linkPath);
+	}
+
+	if (filesystem::exists(filePath)) filesystem::remove(filePath);
+
+	cout << "----------------------------------------------------------------------------------------------------" << endl << endl;
+}
+
+int main(int argc, char** argv)
+{
+	// '--default' runs the default procedure without prompting, e.g. from ctest
+	int choice = 1;
+	if (argc < 2 || string(argv[1]) != "--default")
+	{
+		cout << "Testing JTF " << GetVersion() << endl << endl;
+
+		cout << "Choose procedure:\n1. Default\n2. Read file at path" << endl;
+
+		cout << "Awaiting input: ";
+
+		cin >> choice;
+
+		// Move cursor up 1 line and clear it
+		cout << "\033[1A\033[2K";
+		cout << "\033[1A\033[2K";
+		cout << "\033[1A\033[2K";
+		cout << "\033[1A\033[2K";
+
+		cout << "\033[1A\033[2K";
+		cout << "\033[1A\033[2K";
+		cout << "\033[1A\033[2K";
+		cout << "\033[1A\033[2K";
+	}
 
 	cout << "Testing JTF " << GetVersion() << " (" << (choice == 1 ? "Default" : "Read file at path") << ")" << endl;
 
@@ -155,5 +1788,83 @@ int main()
 		format(R"([JTF Import Error] '{}' Cannot open file for reading. => File corrupted or not saved correctly.)", filePath);
 
 
-	return 0;
+
+	RunEarlyExitTest(filePath.c_str());
+
+
+
+	RunRoundTripTest(filePath.c_str());
+
+
+
+	RunDamagedHcmpTest(filePath.c_str());
+
+
+
+	RunCApiTest(filePath.c_str());
+
+
+
+	RunStatsTotalTest(filePath.c_str());
+
+
+
+	RunChunkDirectoryTest(filePath.c_str());
+
+
+
+	RunAtomicReplaceTest(filePath.c_str());
+
+
+
+	RunRegionTest(filePath.c_str());
+
+
+
+	RunLodTest(filePath.c_str());
+
+
+
+	RunStreamWriterTest(filePath.c_str());
+
+
+
+	RunStreamReaderTest(filePath.c_str());
+
+
+
+	RunHeightQueryTest(filePath.c_str());
+
+
+
+	RunCrcTest(filePath.c_str());
+
+
+
+	RunViewTest(filePath.c_str());
+
+
+
+	RunReaderTest(filePath.c_str());
+
+
+
+	RunScanHeadersTest(filePath.c_str());
+
+
+
+	RunSampleConverterTest(filePath.c_str());
+
+
+
+	RunElevationTest(filePath.c_str());
+
+
+
+	RunAsyncTest(filePath.c_str());
+
+
+
+	cout << format("Failures: {}", failureCount) << endl;
+	return failureCount == 0 ? 0 : 1;
 }
\ No newline at end of file